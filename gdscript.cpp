@@ -50,6 +50,8 @@
 #include "core/config/project_settings.h"
 #include "core/core_constants.h"
 #include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 
 #include "scene/resources/packed_scene.h"
 #include "scene/scene_string_names.h"
@@ -438,18 +440,25 @@ bool GDScript::instance_has(const Object *p_this) const {
 }
 
 bool GDScript::has_source_code() const {
-	return !source.is_empty();
+	return !source.is_empty() || !source_utf8.is_empty();
 }
 
 String GDScript::get_source_code() const {
-	return source;
+	if (source_utf8.is_empty()) {
+		return source;
+	}
+	// Validated when loaded.
+	String decoded;
+	decoded.append_utf8((const char *)source_utf8.ptr(), source_utf8.size());
+	return decoded;
 }
 
 void GDScript::set_source_code(const String &p_code) {
-	if (source == p_code) {
+	if (source_utf8.is_empty() && source == p_code) {
 		return;
 	}
 	source = p_code;
+	source_utf8.clear();
 #ifdef TOOLS_ENABLED
 	source_changed_cache = true;
 #endif
@@ -523,7 +532,7 @@ bool GDScript::_update_exports(bool *r_err, bool p_recursive_call, PlaceHolderSc
 
 		GDScriptParser parser;
 		GDScriptAnalyzer analyzer(&parser);
-		Error err = parser.parse(source, path, false);
+		Error err = parser.parse(get_source_code(), path, false);
 
 		if (err == OK && analyzer.analyze() == OK) {
 			const GDScriptParser::ClassNode *c = parser.get_tree();
@@ -595,6 +604,7 @@ bool GDScript::_update_exports(bool *r_err, bool p_recursive_call, PlaceHolderSc
 				base_cache->inheriters_cache.clear(); // to prevent future stackoverflows
 				base_cache.unref();
 				base.unref();
+				_update_ancestors();
 				ERR_FAIL_V_MSG(false, "Cyclic inheritance in script class.");
 			}
 		}
@@ -742,6 +752,9 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 	reloading = true;
 
+	// The analyzer keeps pointers into the trees of the dependencies until the end.
+	GDScriptCache::CompileScope compile_scope;
+
 	bool has_instances;
 	{
 		MutexLock lock(GDScriptLanguage::singleton->mutex);
@@ -774,6 +787,12 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 #endif
 
+	// Only decoded for the parser, unless kept for the editor.
+	String source_code;
+	if (binary_tokens.is_empty()) {
+		source_code = get_source_code();
+	}
+
 	{
 		String source_path = path;
 		if (source_path.is_empty()) {
@@ -792,7 +811,7 @@ Error GDScript::reload(bool p_keep_state) {
 					if (!binary_tokens.is_empty()) {
 						source_hash = hash_djb2_buffer(binary_tokens.ptr(), binary_tokens.size());
 					} else {
-						source_hash = source.hash();
+						source_hash = source_code.hash();
 					}
 					if (parser_ref->get_source_hash() != source_hash) {
 						GDScriptCache::remove_parser(source_path);
@@ -816,7 +835,7 @@ Error GDScript::reload(bool p_keep_state) {
 	if (!binary_tokens.is_empty()) {
 		err = parser.parse_binary(binary_tokens, path);
 	} else {
-		err = parser.parse(source, path, false);
+		err = parser.parse(source_code, path, false);
 	}
 	if (err) {
 		if (EngineDebugger::is_active()) {
@@ -828,48 +847,53 @@ Error GDScript::reload(bool p_keep_state) {
 		return ERR_PARSE_ERROR;
 	}
 
-	GDScriptAnalyzer analyzer(&parser);
-	err = analyzer.analyze();
+	{
+		// The analyzer raises and reads the trees of the dependencies, which other threads share.
+		GDScriptCache::CompileLock cache_lock;
 
-	if (err) {
-		if (EngineDebugger::is_active()) {
-			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
-		}
+		GDScriptAnalyzer analyzer(&parser);
+		err = analyzer.analyze();
+
+		if (err) {
+			if (EngineDebugger::is_active()) {
+				GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+			}
 
-		const List<GDScriptParser::ParserError>::Element *e = parser.get_errors().front();
-		while (e != nullptr) {
-			_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), e->get().line, ("Parse Error: " + e->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
-			e = e->next();
+			const List<GDScriptParser::ParserError>::Element *e = parser.get_errors().front();
+			while (e != nullptr) {
+				_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), e->get().line, ("Parse Error: " + e->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+				e = e->next();
+			}
+			reloading = false;
+			return ERR_PARSE_ERROR;
 		}
-		reloading = false;
-		return ERR_PARSE_ERROR;
-	}
 
-	can_run = ScriptServer::is_scripting_enabled() || parser.is_tool();
+		can_run = ScriptServer::is_scripting_enabled() || parser.is_tool();
 
-	GDScriptCompiler compiler;
-	err = compiler.compile(&parser, this, p_keep_state);
+		GDScriptCompiler compiler;
+		err = compiler.compile(&parser, this, p_keep_state);
 
-	if (err) {
-		// TODO: Provide the script function as the first argument.
-		_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), compiler.get_error_line(), ("Compile Error: " + compiler.get_error()).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
-		if (can_run) {
-			if (EngineDebugger::is_active()) {
-				GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), compiler.get_error_line(), "Parser Error: " + compiler.get_error());
+		if (err) {
+			// TODO: Provide the script function as the first argument.
+			_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), compiler.get_error_line(), ("Compile Error: " + compiler.get_error()).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+			if (can_run) {
+				if (EngineDebugger::is_active()) {
+					GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), compiler.get_error_line(), "Parser Error: " + compiler.get_error());
+				}
+				reloading = false;
+				return ERR_COMPILATION_FAILED;
+			} else {
+				reloading = false;
+				return err;
 			}
-			reloading = false;
-			return ERR_COMPILATION_FAILED;
-		} else {
-			reloading = false;
-			return err;
 		}
-	}
 
 #ifdef TOOLS_ENABLED
-	// Done after compilation because it needs the GDScript object's inner class GDScript objects,
-	// which are made by calling make_scripts() within compiler.compile() above.
-	GDScriptDocGen::generate_docs(this, parser.get_tree());
+		// Done after compilation because it needs the GDScript object's inner class GDScript objects,
+		// which are made by calling make_scripts() within compiler.compile() above.
+		GDScriptDocGen::generate_docs(this, parser.get_tree());
 #endif
+	}
 
 #ifdef DEBUG_ENABLED
 	for (const GDScriptWarning &warning : parser.get_warnings()) {
@@ -1072,6 +1096,8 @@ void GDScript::_get_property_list(List<PropertyInfo> *p_properties) const {
 
 void GDScript::_bind_methods() {
 	ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "new", &GDScript::_new, MethodInfo("new"));
+
+	ClassDB::bind_method(D_METHOD("get_bytecode_report"), &GDScript::get_bytecode_report);
 }
 
 void GDScript::set_path_cache(const String &p_path) {
@@ -1139,7 +1165,15 @@ Error GDScript::load_source_code(const String &p_path) {
 		ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Script '" + p_path + "' contains invalid unicode (UTF-8), so it was not loaded. Please ensure that scripts are saved in valid UTF-8 unicode.");
 	}
 
-	source = s;
+	// Outside of the editor the source is only needed to compile, and takes a quarter of the memory as UTF-8.
+	if (Engine::get_singleton()->is_editor_hint() || len == 0) {
+		source = s;
+		source_utf8.clear();
+	} else {
+		sourcef.resize(len);
+		source_utf8 = sourcef;
+		source = String();
+	}
 	path = p_path;
 	path_valid = true;
 #ifdef TOOLS_ENABLED
@@ -1160,7 +1194,61 @@ const Vector<uint8_t> &GDScript::get_binary_tokens_source() const {
 
 Vector<uint8_t> GDScript::get_as_binary_tokens() const {
 	GDScriptTokenizerBuffer tokenizer;
-	return tokenizer.parse_code_string(source, GDScriptTokenizerBuffer::COMPRESS_NONE);
+	return tokenizer.parse_code_string(get_source_code(), GDScriptTokenizerBuffer::COMPRESS_NONE);
+}
+
+static void _add_bytecode_report(const GDScript *p_script, const GDScriptFunction *p_function, Array &r_functions, GDScriptFunction::BytecodeStats &r_total, HashSet<const GDScriptConstantPool *> &r_pools) {
+	if (!p_function) {
+		return;
+	}
+	const GDScriptFunction::BytecodeStats stats = p_function->get_bytecode_stats();
+	Dictionary entry = stats.to_dictionary();
+	entry["class"] = p_script->get_fully_qualified_name();
+	entry["name"] = p_function->get_name();
+	r_functions.push_back(entry);
+
+	// The pool is shared by all the functions of a class, so it's only counted once in the totals.
+	GDScriptFunction::BytecodeStats own_stats = stats;
+	own_stats.constant_count = 0;
+	own_stats.global_name_count = 0;
+	r_total.accumulate(own_stats);
+
+	const GDScriptConstantPool *pool = p_function->get_constant_pool();
+	if (pool && !r_pools.has(pool)) {
+		r_pools.insert(pool);
+		r_total.constant_count += pool->get_constant_count();
+		r_total.global_name_count += pool->get_global_name_count();
+		r_total.constant_bytes += pool->get_memory_usage();
+	}
+}
+
+static void _collect_bytecode_report(const GDScript *p_script, Array &r_functions, GDScriptFunction::BytecodeStats &r_total, HashSet<const GDScriptConstantPool *> &r_pools) {
+	_add_bytecode_report(p_script, p_script->get_implicit_initializer(), r_functions, r_total, r_pools);
+	_add_bytecode_report(p_script, p_script->get_implicit_ready(), r_functions, r_total, r_pools);
+	_add_bytecode_report(p_script, p_script->get_static_initializer(), r_functions, r_total, r_pools);
+	for (const KeyValue<GDScriptFunction *, GDScript::LambdaInfo> &E : p_script->get_lambda_info()) {
+		_add_bytecode_report(p_script, E.key, r_functions, r_total, r_pools);
+	}
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->get_member_functions()) {
+		_add_bytecode_report(p_script, E.value, r_functions, r_total, r_pools);
+	}
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->get_subclasses()) {
+		_collect_bytecode_report(E.value.ptr(), r_functions, r_total, r_pools);
+	}
+}
+
+// Totals for the script and its inner classes, plus one entry per compiled function in "functions".
+// Per-function constant and global name counts are the size of the class's shared pool.
+Dictionary GDScript::get_bytecode_report() const {
+	Array functions;
+	GDScriptFunction::BytecodeStats total;
+	HashSet<const GDScriptConstantPool *> pools;
+	_collect_bytecode_report(this, functions, total, pools);
+
+	Dictionary report = total.to_dictionary();
+	report["path"] = get_script_path();
+	report["functions"] = functions;
+	return report;
 }
 
 const HashMap<StringName, GDScriptFunction *> &GDScript::debug_get_member_functions() const {
@@ -1197,16 +1285,43 @@ bool GDScript::inherits_script(const Ref<Script> &p_script) const {
 		return false;
 	}
 
-	const GDScript *s = this;
+	return is_subclass_of(gd.ptr());
+}
 
-	while (s) {
-		if (s == p_script.ptr()) {
-			return true;
-		}
-		s = s->base.ptr();
+bool GDScript::_build_ancestors() {
+	LocalVector<const GDScript *> chain;
+	for (const GDScript *scr = this; scr; scr = scr->base.ptr()) {
+		chain.push_back(scr);
 	}
+	chain.invert();
 
-	return false;
+	bool changed = chain.size() != ancestors.size();
+	for (uint32_t i = 0; !changed && i < chain.size(); i++) {
+		changed = chain[i] != ancestors[i];
+	}
+	if (changed) {
+		ancestors = chain;
+	}
+	return changed;
+}
+
+void GDScript::_update_ancestors() {
+	const bool was_built = !ancestors.is_empty();
+	if (!_build_ancestors() || !was_built) {
+		// Scripts inheriting from this one are compiled after it, unless its base changed on reload.
+		return;
+	}
+
+	MutexLock lock(GDScriptLanguage::singleton->mutex);
+	for (SelfList<GDScript> *E = GDScriptLanguage::singleton->script_list.first(); E; E = E->next()) {
+		GDScript *scr = E->self();
+		for (const GDScript *scr_base = scr->base.ptr(); scr_base; scr_base = scr_base->base.ptr()) {
+			if (scr_base == this) {
+				scr->_build_ancestors();
+				break;
+			}
+		}
+	}
 }
 
 GDScript *GDScript::find_class(const String &p_qualified_name) {
@@ -1377,8 +1492,8 @@ void GDScript::_collect_function_dependencies(GDScriptFunction *p_func, RBSet<GD
 	for (GDScriptFunction *lambda : p_func->lambdas) {
 		_collect_function_dependencies(lambda, p_dependencies, p_except);
 	}
-	for (const Variant &V : p_func->constants) {
-		GDScript *scr = _get_gdscript_from_variant(V);
+	for (int i = 0; i < p_func->_constant_count; i++) {
+		GDScript *scr = _get_gdscript_from_variant(p_func->_constants_ptr[i]);
 		if (scr != nullptr && scr != p_except) {
 			scr->_collect_dependencies(p_dependencies, p_except);
 		}
@@ -1584,6 +1699,7 @@ void GDScript::clear(ClearData *p_clear_data) {
 		clear_data->functions.insert(E.value);
 	}
 	member_functions.clear();
+	GDScriptLanguage::get_singleton()->invalidate_devirtualized_calls();
 
 	for (KeyValue<StringName, MemberInfo> &E : member_indices) {
 		clear_data->scripts.insert(E.value.data_type.script_type_ref);
@@ -2309,6 +2425,120 @@ void GDScriptLanguage::init() {
 #endif // TESTS_ENABLED
 }
 
+uint32_t GDScriptLanguage::_number_native_class(const StringName &p_class, const HashMap<StringName, LocalVector<StringName>> &p_children, uint32_t p_next) {
+	NativeClassRange &range = native_class_ranges[p_class];
+	range.begin = p_next++;
+	HashMap<StringName, LocalVector<StringName>>::ConstIterator E = p_children.find(p_class);
+	if (E) {
+		for (const StringName &child : E->value) {
+			p_next = _number_native_class(child, p_children, p_next);
+		}
+	}
+	range.end = p_next;
+	return p_next;
+}
+
+void GDScriptLanguage::_update_native_class_ranges() {
+	LocalVector<StringName> class_list;
+	ClassDB::get_class_list(class_list);
+
+	HashMap<StringName, LocalVector<StringName>> children;
+	LocalVector<StringName> roots;
+	for (const StringName &class_name : class_list) {
+		const StringName parent = ClassDB::get_parent_class_nocheck(class_name);
+		if (parent == StringName()) {
+			roots.push_back(class_name);
+		} else {
+			children[parent].push_back(class_name);
+		}
+	}
+
+	native_class_ranges.clear();
+	native_class_ranges.reserve(class_list.size());
+	uint32_t next = 0;
+	for (const StringName &root : roots) {
+		next = _number_native_class(root, children, next);
+	}
+}
+
+bool GDScriptLanguage::is_native_subclass(const StringName &p_class, const StringName &p_base) {
+	if (native_class_ranges_dirty.is_set()) {
+		RWLockWrite lock(native_class_ranges_lock);
+		if (native_class_ranges_dirty.is_set()) {
+			_update_native_class_ranges();
+			native_class_ranges_dirty.clear();
+		}
+	}
+
+	{
+		RWLockRead lock(native_class_ranges_lock);
+		HashMap<StringName, NativeClassRange>::ConstIterator class_range = native_class_ranges.find(p_class);
+		HashMap<StringName, NativeClassRange>::ConstIterator base_range = native_class_ranges.find(p_base);
+		if (class_range && base_range) {
+			return base_range->value.begin <= class_range->value.begin && class_range->value.begin < base_range->value.end;
+		}
+	}
+
+	// Registered after the ranges were numbered.
+	if (ClassDB::class_exists(p_class) && ClassDB::class_exists(p_base)) {
+		native_class_ranges_dirty.set();
+	}
+	return ClassDB::is_parent_class(p_class, p_base);
+}
+
+GDScriptFunction *GDScriptLanguage::devirtualize_method(GDScript *p_receiver, const StringName &p_method, GDScript **r_key) {
+	*r_key = nullptr;
+	if (p_method == SceneStringName(_ready)) {
+		// Needs the implicit ready chain, see `GDScriptInstance::callp()`.
+		return nullptr;
+	}
+
+	// Resolve the same way `GDScriptInstance::callp()` does.
+	GDScript *owner = nullptr;
+	GDScriptFunction *function = nullptr;
+	for (GDScript *scr = p_receiver; scr; scr = scr->base.ptr()) {
+		if (!scr->valid) {
+			return nullptr;
+		}
+		HashMap<StringName, GDScriptFunction *>::Iterator E = scr->member_functions.find(p_method);
+		if (E) {
+			owner = scr;
+			function = E->value;
+			break;
+		}
+	}
+	if (!function) {
+		return nullptr;
+	}
+
+	// Class hierarchy analysis: find the loaded scripts that override the method below its owner.
+	LocalVector<const GDScript *> overriders;
+	{
+		MutexLock lock(mutex);
+		for (SelfList<GDScript> *E = script_list.first(); E; E = E->next()) {
+			const GDScript *scr = E->self();
+			if (scr != owner && scr->member_functions.has(p_method) && scr->is_subclass_of(owner)) {
+				overriders.push_back(scr);
+			}
+		}
+	}
+
+	// The call site can be bound to the most general script between the receiver and the owner
+	// that no overriding script inherits from.
+	for (GDScript *scr = p_receiver; scr; scr = scr->base.ptr()) {
+		for (const GDScript *overrider : overriders) {
+			if (overrider->is_subclass_of(scr)) {
+				return *r_key ? function : nullptr;
+			}
+		}
+		*r_key = scr;
+		if (scr == owner) {
+			break;
+		}
+	}
+	return function;
+}
+
 #ifdef TOOLS_ENABLED
 void GDScriptLanguage::_extension_loaded(const Ref<GDExtension> &p_extension) {
 	List<StringName> class_list;
@@ -2320,6 +2550,8 @@ void GDScriptLanguage::_extension_loaded(const Ref<GDExtension> &p_extension) {
 		Ref<GDScriptNativeClass> nc = memnew(GDScriptNativeClass(n));
 		_add_global(n, nc);
 	}
+	clear_native_completion_cache();
+	invalidate_native_class_ranges();
 }
 
 void GDScriptLanguage::_extension_unloading(const Ref<GDExtension> &p_extension) {
@@ -2328,6 +2560,8 @@ void GDScriptLanguage::_extension_unloading(const Ref<GDExtension> &p_extension)
 	for (const StringName &n : class_list) {
 		_remove_global(n);
 	}
+	clear_native_completion_cache();
+	invalidate_native_class_ranges();
 }
 #endif
 
@@ -2347,6 +2581,9 @@ void GDScriptLanguage::finish() {
 
 	// Clear the cache before parsing the script_list
 	GDScriptCache::clear();
+#ifdef TOOLS_ENABLED
+	clear_native_completion_cache();
+#endif
 
 	// Clear dependencies between scripts, to ensure cyclic references are broken
 	// (to avoid leaks at exit).
@@ -2397,11 +2634,23 @@ void GDScriptLanguage::profiling_start() {
 		elem->self()->profile.last_frame_call_count = 0;
 		elem->self()->profile.last_frame_self_time = 0;
 		elem->self()->profile.last_frame_total_time = 0;
-		elem->self()->profile.native_calls.clear();
-		elem->self()->profile.last_native_calls.clear();
+		elem->self()->profile.native_calls->clear();
+		elem->self()->profile.last_native_calls->clear();
 		elem = elem->next();
 	}
 
+	{
+		MutexLock dirty_lock(profile_dirty_mutex);
+		for (GDScriptFunction *function : profile_dirty_functions) {
+			function->profile.frame_dirty.store(false);
+		}
+		for (GDScriptFunction *function : profile_last_frame_functions) {
+			function->profile.reported_last_frame = false;
+		}
+		profile_dirty_functions.clear();
+		profile_last_frame_functions.clear();
+	}
+
 	profiling = true;
 #endif
 }
@@ -2426,6 +2675,7 @@ int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr,
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(mutex);
+	MutexLock dirty_lock(profile_dirty_mutex);
 
 	profiling_collate_native_call_data(true);
 	SelfList<GDScriptFunction> *elem = function_list.first();
@@ -2441,7 +2691,7 @@ int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr,
 		current++;
 
 		int nat_time = 0;
-		HashMap<String, GDScriptFunction::Profile::NativeProfile>::ConstIterator nat_calls = elem->self()->profile.native_calls.begin();
+		HashMap<String, GDScriptFunction::Profile::NativeProfile>::ConstIterator nat_calls = elem->self()->profile.native_calls->begin();
 		while (nat_calls) {
 			p_info_arr[current].call_count = nat_calls->value.call_count;
 			p_info_arr[current].total_time = nat_calls->value.total_time;
@@ -2464,23 +2714,24 @@ int GDScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_
 
 #ifdef DEBUG_ENABLED
 	MutexLock lock(mutex);
+	MutexLock dirty_lock(profile_dirty_mutex);
 
 	profiling_collate_native_call_data(false);
-	SelfList<GDScriptFunction> *elem = function_list.first();
-	while (elem) {
+	for (const GDScriptFunction *function : profile_last_frame_functions) {
 		if (current >= p_info_max) {
 			break;
 		}
-		if (elem->self()->profile.last_frame_call_count > 0) {
+		const GDScriptFunction::Profile &profile = function->profile;
+		if (profile.last_frame_call_count > 0) {
 			int last_non_internal = current;
-			p_info_arr[current].call_count = elem->self()->profile.last_frame_call_count;
-			p_info_arr[current].self_time = elem->self()->profile.last_frame_self_time;
-			p_info_arr[current].total_time = elem->self()->profile.last_frame_total_time;
-			p_info_arr[current].signature = elem->self()->profile.signature;
+			p_info_arr[current].call_count = profile.last_frame_call_count;
+			p_info_arr[current].self_time = profile.last_frame_self_time;
+			p_info_arr[current].total_time = profile.last_frame_total_time;
+			p_info_arr[current].signature = profile.signature;
 			current++;
 
 			int nat_time = 0;
-			HashMap<String, GDScriptFunction::Profile::NativeProfile>::ConstIterator nat_calls = elem->self()->profile.last_native_calls.begin();
+			HashMap<String, GDScriptFunction::Profile::NativeProfile>::ConstIterator nat_calls = profile.last_native_calls->begin();
 			while (nat_calls) {
 				p_info_arr[current].call_count = nat_calls->value.call_count;
 				p_info_arr[current].total_time = nat_calls->value.total_time;
@@ -2493,7 +2744,6 @@ int GDScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_
 			}
 			p_info_arr[last_non_internal].internal_time = nat_time;
 		}
-		elem = elem->next();
 	}
 #endif
 
@@ -2505,9 +2755,8 @@ void GDScriptLanguage::profiling_collate_native_call_data(bool p_accumulated) {
 	// The same native call can be called from multiple functions, so join them together here.
 	// Only use the name of the function (ie signature.split[2]).
 	HashMap<String, GDScriptFunction::Profile::NativeProfile *> seen_nat_calls;
-	SelfList<GDScriptFunction> *elem = function_list.first();
-	while (elem) {
-		HashMap<String, GDScriptFunction::Profile::NativeProfile> *nat_calls = p_accumulated ? &elem->self()->profile.native_calls : &elem->self()->profile.last_native_calls;
+	auto collate = [&seen_nat_calls, p_accumulated](GDScriptFunction::Profile &p_profile) {
+		HashMap<String, GDScriptFunction::Profile::NativeProfile> *nat_calls = p_accumulated ? p_profile.native_calls : p_profile.last_native_calls;
 		HashMap<String, GDScriptFunction::Profile::NativeProfile>::Iterator it = nat_calls->begin();
 
 		while (it != nat_calls->end()) {
@@ -2516,13 +2765,25 @@ void GDScriptLanguage::profiling_collate_native_call_data(bool p_accumulated) {
 			if (already_found) {
 				already_found->value->total_time += it->value.total_time;
 				already_found->value->call_count += it->value.call_count;
-				elem->self()->profile.last_native_calls.remove(it);
+				p_profile.last_native_calls->remove(it);
 			} else {
 				seen_nat_calls.insert(sig[2], &it->value);
 			}
 			++it;
 		}
-		elem = elem->next();
+	};
+
+	if (p_accumulated) {
+		SelfList<GDScriptFunction> *elem = function_list.first();
+		while (elem) {
+			collate(elem->self()->profile);
+			elem = elem->next();
+		}
+	} else {
+		// Only functions reported for the last frame can have last frame native calls.
+		for (GDScriptFunction *function : profile_last_frame_functions) {
+			collate(function->profile);
+		}
 	}
 #endif
 }
@@ -2724,26 +2985,108 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 	reload_scripts(scripts, p_soft_reload);
 }
 
+#ifdef DEBUG_ENABLED
+void GDScriptLanguage::_sync_breakpoint_traps() {
+	// The debugger edits the breakpoint set while handling its messages on the main thread, so it's
+	// only read from there. Other threads stopped at a breakpoint get the traps from the next sync.
+	if (!Thread::is_main_thread()) {
+		return;
+	}
+	ScriptDebugger *script_debugger = EngineDebugger::get_script_debugger();
+	if (!script_debugger) {
+		return;
+	}
+
+	// The script debugger doesn't notify about breakpoint changes, so compare an
+	// order-independent hash of the breakpoint set with the one traps were patched for.
+	const HashMap<int, HashSet<StringName>> &breakpoints = script_debugger->get_breakpoints();
+	uint64_t hash = breakpoints.size();
+	for (const KeyValue<int, HashSet<StringName>> &E : breakpoints) {
+		for (const StringName &source : E.value) {
+			hash += hash_murmur3_one_64(((uint64_t)(uint32_t)E.key << 32) | source.hash());
+		}
+	}
+	if (hash == breakpoints_hash) {
+		return;
+	}
+	breakpoints_hash = hash;
+
+	MutexLock lock(mutex);
+
+	SelfList<GDScriptFunction> *elem = function_list.first();
+	while (elem) {
+		elem->self()->update_breakpoint_traps(breakpoints);
+		elem = elem->next();
+	}
+}
+
+void GDScriptLanguage::debug_line_poll() {
+	EngineDebugger::get_singleton()->line_poll();
+
+	// The debugger only handles its messages every few thousand polls, follow at a similar pace,
+	// so breakpoints set while a long loop runs are patched in before the next frame.
+	// Only the main thread handles them, see `_sync_breakpoint_traps()`.
+	static uint32_t polls = 0;
+	if (Thread::is_main_thread() && unlikely((++polls & 1023) == 0)) {
+		_sync_breakpoint_traps();
+	}
+}
+#endif
+
 void GDScriptLanguage::frame() {
 #ifdef DEBUG_ENABLED
+	if (EngineDebugger::is_active()) {
+		_sync_breakpoint_traps();
+	}
+
 	if (profiling) {
-		MutexLock lock(mutex);
+		MutexLock lock(profile_dirty_mutex);
 
-		SelfList<GDScriptFunction> *elem = function_list.first();
-		while (elem) {
-			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count.get();
-			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time.get();
-			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time.get();
-			elem->self()->profile.last_native_calls = elem->self()->profile.native_calls;
-			elem->self()->profile.frame_call_count.set(0);
-			elem->self()->profile.frame_self_time.set(0);
-			elem->self()->profile.frame_total_time.set(0);
-			elem->self()->profile.native_calls.clear();
-			elem = elem->next();
+		// Only functions touched in the last two frames have anything to flip.
+		for (GDScriptFunction *function : profile_last_frame_functions) {
+			GDScriptFunction::Profile &profile = function->profile;
+			profile.last_frame_call_count = 0;
+			profile.last_frame_self_time = 0;
+			profile.last_frame_total_time = 0;
+			profile.last_native_calls->clear();
+			profile.reported_last_frame = false;
+		}
+
+		for (GDScriptFunction *function : profile_dirty_functions) {
+			GDScriptFunction::Profile &profile = function->profile;
+			// Clear first, so calls racing with the flip mark the function again.
+			profile.frame_dirty.store(false);
+			profile.last_frame_call_count = profile.frame_call_count.get();
+			profile.last_frame_self_time = profile.frame_self_time.get();
+			profile.last_frame_total_time = profile.frame_total_time.get();
+			profile.frame_call_count.set(0);
+			profile.frame_self_time.set(0);
+			profile.frame_total_time.set(0);
+			SWAP(profile.native_calls, profile.last_native_calls);
+			profile.native_calls->clear();
+			profile.reported_last_frame = true;
 		}
+
+		profile_last_frame_functions = profile_dirty_functions;
+		profile_dirty_functions.clear();
 	}
 
 #endif
+
+	if (release_parsers) {
+		// Once no script was parsed for a while, scripts loaded later parse their dependencies again.
+		const uint64_t parser_generation = GDScriptCache::get_parser_generation();
+		if (parser_generation != release_parsers_generation) {
+			release_parsers_generation = parser_generation;
+			release_parsers_idle_frames = 0;
+		} else if (++release_parsers_idle_frames == RELEASE_PARSERS_SETTLE_FRAMES) {
+			const Dictionary report = GDScriptCache::compact();
+			if (!report.is_empty()) {
+				print_verbose(vformat("GDScript: Released %d parsers after loading, static memory %s -> %s.", report["parsers"],
+						String::humanize_size(report["memory_before"]), String::humanize_size(report["memory_after"])));
+			}
+		}
+	}
 }
 
 /* EDITOR FUNCTIONS */
@@ -2832,29 +3175,350 @@ String GDScriptLanguage::get_global_class_name(const String &p_path, String *r_b
 	return _get_global_class_name(p_path, r_base_type, r_icon_path, r_is_abstract, r_is_tool, r_vec);
 }
 
-String GDScriptLanguage::_get_global_class_name(const String &p_path, String *r_base_type, String *r_icon_path, bool *r_is_abstract, bool *r_is_tool, LocalVector<String> &r_visited) const {
-	if (r_visited.has(p_path)) {
-		return String();
+// Reads the script annotations, `class_name` and `extends` the way `GDScriptParser::parse_program()`
+// does, and stops at the first token that isn't part of them. Returns `false` if the parser is needed
+// to tell, such as an `@icon` argument that isn't a plain string, or a tokenizer error.
+bool GDScriptLanguage::_scan_global_class_header(GDScriptTokenizer &p_tokenizer, const String &p_path, GlobalClassHeader &r_header) {
+	typedef GDScriptTokenizer::Token Token;
+
+	Token current = p_tokenizer.scan();
+	auto advance = [&]() {
+		current = p_tokenizer.scan();
+	};
+	auto match = [&](Token::Type p_type) -> bool {
+		if (current.type != p_type) {
+			return false;
+		}
+		advance();
+		return true;
+	};
+	auto end_statement = [&]() -> bool {
+		return match(Token::NEWLINE) || match(Token::SEMICOLON) || current.type == Token::TK_EOF;
+	};
+	auto parse_extends = [&]() -> bool {
+		r_header.extends_used = true;
+		if (current.type == Token::LITERAL) {
+			if (current.literal.get_type() != Variant::STRING) {
+				return false;
+			}
+			r_header.extends_path = current.literal;
+			advance();
+			if (!match(Token::PERIOD)) {
+				return true;
+			}
+		}
+		do {
+			if (current.type != Token::IDENTIFIER) {
+				return false;
+			}
+			r_header.extends.push_back(current.get_identifier());
+			advance();
+		} while (match(Token::PERIOD));
+		return true;
+	};
+
+	// Class annotations apply to the script if `class_name`, `extends` or a script annotation follows,
+	// otherwise to the next member.
+	bool pending_abstract = false;
+	auto apply_pending = [&]() {
+		r_header.is_abstract = r_header.is_abstract || pending_abstract;
+		pending_abstract = false;
+	};
+	// Annotations after `class_name` or `extends` belong to the first member.
+	bool class_or_extends_seen = false;
+
+	while (true) {
+		switch (current.type) {
+			case Token::NEWLINE:
+				advance();
+				break;
+			case Token::LITERAL:
+				if (current.literal.get_type() != Variant::STRING) {
+					return true;
+				}
+				// Strings used as comments.
+				advance();
+				if (!end_statement()) {
+					return false;
+				}
+				break;
+			case Token::ANNOTATION: {
+				if (class_or_extends_seen) {
+					return true;
+				}
+				const StringName name = current.get_identifier();
+				advance();
+				if (name == SNAME("@tool")) {
+					apply_pending();
+					r_header.is_tool = true;
+				} else if (name == SNAME("@static_unload")) {
+					apply_pending();
+				} else if (name == SNAME("@abstract")) {
+					pending_abstract = true;
+				} else if (name == SNAME("@icon")) {
+					apply_pending();
+					if (!match(Token::PARENTHESIS_OPEN) || current.type != Token::LITERAL || current.literal.get_type() != Variant::STRING) {
+						return false;
+					}
+					const String path = current.literal;
+					advance();
+					if (path.is_empty() || !r_header.icon_path.is_empty() || !match(Token::PARENTHESIS_CLOSE)) {
+						return false;
+					}
+					// As `GDScriptParser::icon_annotation()`.
+					if (path.is_absolute_path()) {
+						r_header.icon_path = path.simplify_path();
+					} else if (path.is_relative_path()) {
+						r_header.icon_path = p_path.get_base_dir().path_join(path).simplify_path();
+					} else {
+						r_header.icon_path = path;
+					}
+				} else {
+					bool exists = false;
+					if (!GDScriptParser::annotation_continues_header(name, exists)) {
+						// The first member, or an annotation only the parser can report.
+						return exists;
+					}
+					// Doesn't change the header, skip its arguments.
+					if (match(Token::PARENTHESIS_OPEN)) {
+						int depth = 1;
+						while (depth > 0) {
+							if (current.type == Token::TK_EOF || current.type == Token::ERROR) {
+								return false;
+							}
+							if (current.type == Token::PARENTHESIS_OPEN) {
+								depth++;
+							} else if (current.type == Token::PARENTHESIS_CLOSE) {
+								depth--;
+							}
+							advance();
+						}
+					}
+				}
+			} break;
+			case Token::CLASS_NAME:
+				apply_pending();
+				class_or_extends_seen = true;
+				advance();
+				if (!r_header.name.is_empty() || current.type != Token::IDENTIFIER) {
+					return false;
+				}
+				r_header.name = current.get_identifier();
+				advance();
+				if (match(Token::EXTENDS)) {
+					if (r_header.extends_used || !parse_extends()) {
+						return false;
+					}
+				}
+				if (!end_statement()) {
+					return false;
+				}
+				break;
+			case Token::EXTENDS:
+				apply_pending();
+				class_or_extends_seen = true;
+				advance();
+				if (r_header.extends_used || !parse_extends() || !end_statement()) {
+					return false;
+				}
+				break;
+			case Token::TK_EOF:
+				apply_pending();
+				return true;
+			case Token::ERROR:
+				return false;
+			default:
+				// The first member, the header is complete.
+				return true;
+		}
 	}
+}
 
-	r_visited.push_back(p_path);
+// Collects the `preload()` and `extends` paths. Only string constants are dependencies, other
+// arguments are left to the analyzer, which reports them.
+void GDScriptLanguage::_scan_dependencies(GDScriptTokenizer &p_tokenizer, const String &p_path, Vector<String> &r_dependencies) {
+	typedef GDScriptTokenizer::Token Token;
+
+	auto add_dependency = [&](const String &p_dependency) {
+		String path = p_dependency;
+		if (path.is_relative_path()) {
+			// As `GDScriptAnalyzer::reduce_preload()`.
+			path = p_path.get_base_dir().path_join(path);
+		}
+		path = path.simplify_path();
+		if (!path.is_empty() && !r_dependencies.has(path)) {
+			r_dependencies.push_back(path);
+		}
+	};
+
+	// The last tokens, enough to match `preload("path")` and `extends "path"`.
+	Token::Type previous[2] = { Token::EMPTY, Token::EMPTY };
+	String pending_path;
+	while (true) {
+		const Token token = p_tokenizer.scan();
+		if (token.type == Token::TK_EOF) {
+			break;
+		}
+		if (token.type == Token::ERROR) {
+			// The tokenizer recovers, the parser reports it.
+			continue;
+		}
+
+		if (token.type == Token::LITERAL && token.literal.get_type() == Variant::STRING) {
+			if (previous[1] == Token::EXTENDS) {
+				add_dependency(token.literal);
+			} else if (previous[1] == Token::PARENTHESIS_OPEN && previous[0] == Token::PRELOAD) {
+				pending_path = token.literal;
+			}
+		} else if (token.type == Token::PARENTHESIS_CLOSE && !pending_path.is_empty()) {
+			add_dependency(pending_path);
+		}
+		if (token.type != Token::LITERAL) {
+			pending_path = String();
+		}
+
+		previous[0] = previous[1];
+		previous[1] = token.type;
+	}
+}
+
+// Scans the tokens of the script for what `r_scan` is missing, using the cache when the file is
+// unchanged. The parser is only used for a header the scan can't tell.
+bool GDScriptLanguage::_get_script_scan(const String &p_path, bool p_header, bool p_dependencies, ScriptScan &r_scan) const {
+	const uint64_t modified_time = FileAccess::get_modified_time(p_path);
+	{
+		MutexLock lock(script_scans_mutex);
+		const ScriptScan *cached = script_scans.getptr(p_path);
+		// Modification times are in seconds: a scan made in the same second as the last save may
+		// miss a later save in that second, only the content hash tells then.
+		if (cached && modified_time != 0 && cached->modified_time == modified_time && cached->scan_time > modified_time) {
+			r_scan = *cached;
+		}
+	}
+	if ((!p_header || r_scan.has_header) && (!p_dependencies || r_scan.has_dependencies)) {
+		return true;
+	}
 
+	const uint64_t scan_time = OS::get_singleton()->get_unix_time();
 	Error err;
-	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
-	if (err) {
-		return String();
+	const Vector<uint8_t> content = FileAccess::get_file_as_bytes(p_path, &err);
+	if (err != OK) {
+		return false;
 	}
+	const uint32_t content_hash = hash_murmur3_buffer(content.ptr(), content.size());
 
-	String source = f->get_as_utf8_string();
+	{
+		MutexLock lock(script_scans_mutex);
+		ScriptScan *cached = script_scans.getptr(p_path);
+		if (cached && cached->content_hash == content_hash) {
+			// Touched but not changed, as when switching branches.
+			cached->modified_time = modified_time;
+			cached->scan_time = scan_time;
+			r_scan = *cached;
+		} else {
+			r_scan = ScriptScan();
+		}
+	}
+	r_scan.modified_time = modified_time;
+	r_scan.scan_time = scan_time;
+	r_scan.content_hash = content_hash;
 
-	GDScriptParser parser;
-	err = parser.parse(source, p_path, false, false);
+	const bool is_binary = p_path.get_extension().to_lower() == "gdc";
+	String source;
+	if (!is_binary) {
+		source.append_utf8((const char *)content.ptr(), content.size());
+	}
+	auto scan = [&](auto p_scanner) -> bool {
+		if (is_binary) {
+			GDScriptTokenizerBuffer tokenizer;
+			if (tokenizer.set_code_buffer(content) != OK) {
+				return false;
+			}
+			return p_scanner(tokenizer);
+		}
+		GDScriptTokenizerText tokenizer;
+		tokenizer.set_source_code(source);
+		return p_scanner(tokenizer);
+	};
+
+	if (p_header && !r_scan.has_header) {
+		GlobalClassHeader header;
+		const bool scanned = scan([&](GDScriptTokenizer &p_tokenizer) {
+			return _scan_global_class_header(p_tokenizer, p_path, header);
+		});
+		if (!scanned) {
+			// Only the parser knows, it still stops before the class body of text scripts.
+			GDScriptParser parser;
+			if (is_binary) {
+				_ALLOW_DISCARD_ parser.parse_binary(content, p_path);
+			} else {
+				_ALLOW_DISCARD_ parser.parse(source, p_path, false, false);
+			}
 
-	const GDScriptParser::ClassNode *c = parser.get_tree();
-	if (!c) {
-		return String(); // No class parsed.
+			const GDScriptParser::ClassNode *c = parser.get_tree();
+			if (!c) {
+				return false; // No class parsed.
+			}
+
+			header = GlobalClassHeader();
+			header.name = c->identifier != nullptr ? String(c->identifier->name) : String();
+			header.extends_used = c->extends_used;
+			header.extends_path = c->extends_path;
+			for (const GDScriptParser::IdentifierNode *identifier : c->extends) {
+				header.extends.push_back(identifier->name);
+			}
+			header.icon_path = c->simplified_icon_path;
+			header.is_abstract = c->is_abstract;
+			header.is_tool = parser.is_tool();
+		}
+		r_scan.header = header;
+		r_scan.has_header = true;
 	}
 
+	if (p_dependencies && !r_scan.has_dependencies) {
+		Vector<String> dependencies;
+		const bool scanned = scan([&](GDScriptTokenizer &p_tokenizer) {
+			_scan_dependencies(p_tokenizer, p_path, dependencies);
+			return true;
+		});
+		if (!scanned) {
+			return false;
+		}
+		r_scan.dependencies = dependencies;
+		r_scan.has_dependencies = true;
+	}
+
+	MutexLock lock(script_scans_mutex);
+	script_scans[p_path] = r_scan;
+	return true;
+}
+
+Vector<String> GDScriptLanguage::get_script_dependencies(const String &p_path) const {
+	ScriptScan scan;
+	if (!_get_script_scan(p_path, false, true, scan)) {
+		return Vector<String>();
+	}
+	return scan.dependencies;
+}
+
+void GDScriptLanguage::forget_script_scan(const String &p_path) {
+	MutexLock lock(script_scans_mutex);
+	script_scans.erase(p_path);
+}
+
+String GDScriptLanguage::_get_global_class_name(const String &p_path, String *r_base_type, String *r_icon_path, bool *r_is_abstract, bool *r_is_tool, LocalVector<String> &r_visited) const {
+	if (r_visited.has(p_path)) {
+		return String();
+	}
+
+	r_visited.push_back(p_path);
+
+	ScriptScan scan;
+	if (!_get_script_scan(p_path, true, false, scan)) {
+		return String();
+	}
+	const GlobalClassHeader &header = scan.header;
+
 	/* **WARNING**
 	 *
 	 * This function is written with the goal to be *extremely* error tolerant, as such
@@ -2870,83 +3534,87 @@ String GDScriptLanguage::_get_global_class_name(const String &p_path, String *r_
 	 */
 
 	if (r_base_type) {
-		const GDScriptParser::ClassNode *subclass = c;
+		bool extends_used = header.extends_used;
+		String extends_path = header.extends_path;
+		Vector<StringName> extend_classes = header.extends;
 		String path = p_path;
 		GDScriptParser subparser;
-		while (subclass) {
-			if (subclass->extends_used) {
-				if (!subclass->extends_path.is_empty()) {
-					if (subclass->extends.is_empty()) {
-						// We only care about the referenced class_name.
-						_ALLOW_DISCARD_ _get_global_class_name(subclass->extends_path, r_base_type, nullptr, nullptr, nullptr, r_visited);
-						subclass = nullptr;
-						break;
-					} else {
-						Vector<GDScriptParser::IdentifierNode *> extend_classes = subclass->extends;
+		while (true) {
+			if (!extends_used) {
+				*r_base_type = "RefCounted";
+				break;
+			}
+			if (extends_path.is_empty()) {
+				if (extend_classes.size() == 1) {
+					*r_base_type = extend_classes[0];
+				}
+				break;
+			}
+			if (extend_classes.is_empty()) {
+				// We only care about the referenced class_name.
+				_ALLOW_DISCARD_ _get_global_class_name(extends_path, r_base_type, nullptr, nullptr, nullptr, r_visited);
+				break;
+			}
 
-						Ref<FileAccess> subfile = FileAccess::open(subclass->extends_path, FileAccess::READ);
-						if (subfile.is_null()) {
-							break;
-						}
-						String subsource = subfile->get_as_utf8_string();
+			// An inner class of another script, which has to be parsed completely.
+			Ref<FileAccess> subfile = FileAccess::open(extends_path, FileAccess::READ);
+			if (subfile.is_null()) {
+				break;
+			}
+			String subsource = subfile->get_as_utf8_string();
 
-						if (subsource.is_empty()) {
-							break;
-						}
-						String subpath = subclass->extends_path;
-						if (subpath.is_relative_path()) {
-							subpath = path.get_base_dir().path_join(subpath).simplify_path();
-						}
+			if (subsource.is_empty()) {
+				break;
+			}
+			String subpath = extends_path;
+			if (subpath.is_relative_path()) {
+				subpath = path.get_base_dir().path_join(subpath).simplify_path();
+			}
 
-						if (OK != subparser.parse(subsource, subpath, false)) {
-							break;
-						}
-						path = subpath;
-						subclass = subparser.get_tree();
-
-						while (extend_classes.size() > 0) {
-							bool found = false;
-							for (int i = 0; i < subclass->members.size(); i++) {
-								if (subclass->members[i].type != GDScriptParser::ClassNode::Member::CLASS) {
-									continue;
-								}
-
-								const GDScriptParser::ClassNode *inner_class = subclass->members[i].m_class;
-								if (inner_class->identifier->name == extend_classes[0]->name) {
-									extend_classes.remove_at(0);
-									found = true;
-									subclass = inner_class;
-									break;
-								}
-							}
-							if (!found) {
-								subclass = nullptr;
-								break;
-							}
-						}
+			if (OK != subparser.parse(subsource, subpath, false)) {
+				break;
+			}
+			path = subpath;
+			const GDScriptParser::ClassNode *subclass = subparser.get_tree();
+
+			while (subclass && extend_classes.size() > 0) {
+				const GDScriptParser::ClassNode *inner = nullptr;
+				for (int i = 0; i < subclass->members.size(); i++) {
+					if (subclass->members[i].type != GDScriptParser::ClassNode::Member::CLASS) {
+						continue;
+					}
+
+					const GDScriptParser::ClassNode *inner_class = subclass->members[i].m_class;
+					if (inner_class->identifier->name == extend_classes[0]) {
+						extend_classes.remove_at(0);
+						inner = inner_class;
+						break;
 					}
-				} else if (subclass->extends.size() == 1) {
-					*r_base_type = subclass->extends[0]->name;
-					subclass = nullptr;
-				} else {
-					break;
 				}
-			} else {
-				*r_base_type = "RefCounted";
-				subclass = nullptr;
+				subclass = inner;
+			}
+			if (!subclass) {
+				break;
+			}
+
+			extends_used = subclass->extends_used;
+			extends_path = subclass->extends_path;
+			extend_classes.clear();
+			for (const GDScriptParser::IdentifierNode *identifier : subclass->extends) {
+				extend_classes.push_back(identifier->name);
 			}
 		}
 	}
 	if (r_icon_path) {
-		*r_icon_path = c->simplified_icon_path;
+		*r_icon_path = header.icon_path;
 	}
 	if (r_is_abstract) {
-		*r_is_abstract = c->is_abstract;
+		*r_is_abstract = header.is_abstract;
 	}
 	if (r_is_tool) {
-		*r_is_tool = parser.is_tool();
+		*r_is_tool = header.is_tool;
 	}
-	return c->identifier != nullptr ? String(c->identifier->name) : String();
+	return header.name;
 }
 
 thread_local GDScriptLanguage::CallLevel *GDScriptLanguage::_call_stack = nullptr;
@@ -2988,6 +3656,14 @@ GDScriptLanguage::GDScriptLanguage() {
 	_debug_max_call_stack = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "512," + itos(GDScriptFunction::MAX_CALL_DEPTH - 1) + ",1"), 1024);
 	track_call_stack = GLOBAL_DEF_RST("debug/settings/gdscript/always_track_call_stacks", false);
 	track_locals = GLOBAL_DEF_RST("debug/settings/gdscript/always_track_local_variables", false);
+	// The editor keeps the trees for completion and for reloading scripts.
+	release_parsers = GLOBAL_DEF_RST("gdscript/memory/release_parsers_after_load", false) && !Engine::get_singleton()->is_editor_hint();
+	set_jit_enabled(GLOBAL_DEF_RST("gdscript/jit/enabled", false), GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "gdscript/jit/call_threshold", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"), 1000));
+
+	native_class_ranges_dirty.set();
+
+	// Set by the "Lean Bytecode" export preset option. Debug metadata is kept while a debugger is attached.
+	lean_bytecode = OS::get_singleton()->has_feature("gdscript_lean_bytecode") && !EngineDebugger::is_active();
 
 #ifdef DEBUG_ENABLED
 	track_call_stack = true;
@@ -3024,6 +3700,11 @@ GDScriptLanguage::~GDScriptLanguage() {
 	singleton = nullptr;
 }
 
+void GDScriptLanguage::set_jit_enabled(bool p_enabled, uint32_t p_call_threshold) {
+	jit_enabled = p_enabled && GDScriptJIT::is_supported();
+	jit_call_threshold = MAX(p_call_threshold, 1u);
+}
+
 void GDScriptLanguage::add_orphan_subclass(const String &p_qualified_name, const ObjectID &p_subclass) {
 	orphan_subclasses[p_qualified_name] = p_subclass;
 }
@@ -3064,9 +3745,67 @@ Ref<GDScript> GDScriptLanguage::get_script_by_fully_qualified_name(const String
 
 /*************** RESOURCE ***************/
 
+// Whether loading the script at `p_path` can't wait for `p_owner`, as far as its preloads and base
+// scripts tell. Other resources can refer to anything, so the scripts using them are left out.
+// `r_known` holds the answers already found for the same owner, so shared dependencies are walked once.
+static bool _is_independent_script(const String &p_path, const String &p_owner, HashSet<String> &r_visited, HashMap<String, bool> &r_known) {
+	if (p_path == p_owner) {
+		return false;
+	}
+	const bool *known = r_known.getptr(p_path);
+	if (known) {
+		return *known;
+	}
+	if (r_visited.has(p_path)) {
+		return true;
+	}
+	r_visited.insert(p_path);
+
+	const String extension = p_path.get_extension().to_lower();
+	if (extension != "gd" && extension != "gdc") {
+		return false;
+	}
+	for (const String &E : GDScriptLanguage::get_singleton()->get_script_dependencies(ResourceLoader::path_remap(p_path))) {
+		if (!_is_independent_script(E, p_owner, r_visited, r_known)) {
+			// Any script on the way there depends on the owner too.
+			r_known.insert(p_path, false);
+			return false;
+		}
+	}
+	return true;
+}
+
 Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
 	Error err;
 	bool ignoring = p_cache_mode == CACHE_MODE_IGNORE || p_cache_mode == CACHE_MODE_IGNORE_DEEP;
+
+	// Dependencies load on other threads while this script loads, and it uses them as they finish.
+	// Only reading and parsing really overlap: analysis and compilation share the trees of the
+	// dependencies, so they hold the cache mutex and run one at a time (see `CompileLock`).
+	// Not while parsing or compiling, the dependencies could wait for what this thread is working on.
+	LocalVector<Ref<ResourceLoader::LoadToken>> dependency_tokens;
+	if (p_use_sub_threads && p_cache_mode != CACHE_MODE_IGNORE_DEEP && !GDScriptCache::is_compiling()) {
+		HashMap<String, bool> known;
+		for (const String &E : GDScriptLanguage::get_singleton()->get_script_dependencies(p_path)) {
+			if (ResourceCache::has(E)) {
+				continue;
+			}
+			HashSet<String> visited;
+			if (!_is_independent_script(E, p_original_path, visited, known)) {
+				known.insert(E, false);
+				continue;
+			}
+			// Nothing reached from here depends on the owner.
+			for (const String &F : visited) {
+				known.insert(F, true);
+			}
+			Ref<ResourceLoader::LoadToken> token = ResourceLoader::_load_start(E, "", ResourceLoader::LOAD_THREAD_DISTRIBUTE, CACHE_MODE_REUSE);
+			if (token.is_valid()) {
+				dependency_tokens.push_back(token);
+			}
+		}
+	}
+
 	Ref<GDScript> scr = GDScriptCache::get_full_script(p_original_path, err, "", ignoring);
 
 	if (err && scr.is_valid()) {
@@ -3074,6 +3813,15 @@ Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const Str
 		ERR_PRINT_ED(vformat(R"(Failed to load script "%s" with error "%s".)", p_original_path, error_names[err]));
 	}
 
+	for (uint32_t i = 0; i < dependency_tokens.size(); i++) {
+		if (r_progress) {
+			*r_progress = float(i + 1) / float(dependency_tokens.size() + 1);
+		}
+		// Already reported by the dependency, and not an error of this script.
+		Error dependency_err = OK;
+		ResourceLoader::_load_complete(*dependency_tokens[i].ptr(), &dependency_err);
+	}
+
 	if (r_error) {
 		// Don't fail loading because of parsing error.
 		*r_error = scr.is_valid() ? OK : err;
@@ -3100,20 +3848,9 @@ String ResourceFormatLoaderGDScript::get_resource_type(const String &p_path) con
 }
 
 void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types) {
-	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
-	ERR_FAIL_COND_MSG(file.is_null(), "Cannot open file '" + p_path + "'.");
-
-	String source = file->get_as_utf8_string();
-	if (source.is_empty()) {
-		return;
-	}
-
-	GDScriptParser parser;
-	if (OK != parser.parse(source, p_path, false)) {
-		return;
-	}
+	ERR_FAIL_COND_MSG(!FileAccess::exists(p_path), "Cannot open file '" + p_path + "'.");
 
-	for (const String &E : parser.get_dependencies()) {
+	for (const String &E : GDScriptLanguage::get_singleton()->get_script_dependencies(p_path)) {
 		p_dependencies->push_back(E);
 	}
 }
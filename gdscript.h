@@ -38,8 +38,12 @@
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/object/script_language.h"
+#include "core/os/rw_lock.h"
 #include "core/templates/rb_set.h"
 
+class GDScriptParser;
+class GDScriptTokenizer;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -96,6 +100,11 @@ class GDScript : public Script {
 	Ref<GDScript> base;
 	GDScript *_owner = nullptr; //for subclasses
 
+	// Base scripts from the root down to this one, so `is_subclass_of()` is a single lookup.
+	LocalVector<const GDScript *> ancestors;
+	bool _build_ancestors();
+	void _update_ancestors();
+
 	// Members are just indices to the instantiated script.
 	HashMap<StringName, MemberInfo> member_indices; // Includes member info of all base GDScript classes.
 	HashSet<StringName> members; // Only members of the current class.
@@ -180,6 +189,7 @@ private:
 	bool clearing = false;
 	//exported members
 	String source;
+	Vector<uint8_t> source_utf8; // Kept instead of `source` outside of the editor, decoded when needed.
 	Vector<uint8_t> binary_tokens;
 	String path;
 	bool path_valid = false; // False if using default path.
@@ -271,6 +281,8 @@ public:
 	_FORCE_INLINE_ const GDScriptFunction *get_implicit_ready() const { return implicit_ready; }
 	_FORCE_INLINE_ const GDScriptFunction *get_static_initializer() const { return static_initializer; }
 
+	Dictionary get_bytecode_report() const;
+
 	RBSet<GDScript *> get_dependencies();
 	HashMap<GDScript *, RBSet<GDScript *>> get_all_dependencies();
 	RBSet<GDScript *> get_must_clear_dependencies();
@@ -282,6 +294,20 @@ public:
 	bool is_abstract() const override { return _is_abstract; }
 	Ref<GDScript> get_base() const;
 
+	_FORCE_INLINE_ bool is_subclass_of(const GDScript *p_base) const {
+		if (!ancestors.is_empty() && !p_base->ancestors.is_empty()) {
+			const uint32_t depth = p_base->ancestors.size() - 1;
+			return depth < ancestors.size() && ancestors[depth] == p_base;
+		}
+		// Not compiled yet.
+		for (const GDScript *scr = this; scr; scr = scr->base.ptr()) {
+			if (scr == p_base) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	const HashMap<StringName, MemberInfo> &debug_get_member_indices() const { return member_indices; }
 	const HashMap<StringName, GDScriptFunction *> &debug_get_member_functions() const; //this is debug only
 	StringName debug_get_member_by_index(int p_idx) const;
@@ -449,12 +475,63 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	bool track_call_stack = false;
 	bool track_locals = false;
+	bool lean_bytecode = false;
+	bool jit_enabled = false;
+	uint32_t jit_call_threshold = 0;
+	bool release_parsers = false; // Compact `GDScriptCache` once loading settles.
+	static constexpr uint32_t RELEASE_PARSERS_SETTLE_FRAMES = 300;
+	uint64_t release_parsers_generation = 0;
+	uint32_t release_parsers_idle_frames = 0;
+
+	// Preorder numbering of the native class tree: a class inherits from another when its number
+	// falls in the other's range. Rebuilt lazily when ClassDB changes.
+	struct NativeClassRange {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+	};
+	HashMap<StringName, NativeClassRange> native_class_ranges;
+	RWLock native_class_ranges_lock;
+	SafeFlag native_class_ranges_dirty;
+
+	uint32_t _number_native_class(const StringName &p_class, const HashMap<StringName, LocalVector<StringName>> &p_children, uint32_t p_next);
+	void _update_native_class_ranges();
+
+	// Bumped whenever script methods may have been added, removed or freed. Devirtualized call sites
+	// cache the epoch they were resolved in and fall back to a dynamic call when it changes.
+	SafeNumeric<uint32_t> script_hierarchy_epoch{ 1 };
 
 	static CallLevel *_get_stack_level(uint32_t p_level);
 
 	void _add_global(const StringName &p_name, const Variant &p_value);
 	void _remove_global(const StringName &p_name);
 
+	// What `get_global_class_name()` needs from the top of a script.
+	struct GlobalClassHeader {
+		String name;
+		bool extends_used = false;
+		String extends_path;
+		Vector<StringName> extends;
+		String icon_path; // Simplified.
+		bool is_abstract = false;
+		bool is_tool = false;
+	};
+	// What is known about a script file from its tokens alone, cached per path since the editor asks
+	// for every script on each scan. Valid while the modification time or the content are unchanged.
+	struct ScriptScan {
+		uint64_t modified_time = 0;
+		uint64_t scan_time = 0; // When the content was read, in the same unit as `modified_time`.
+		uint32_t content_hash = 0;
+		bool has_header = false;
+		GlobalClassHeader header;
+		bool has_dependencies = false;
+		Vector<String> dependencies;
+	};
+	mutable HashMap<String, ScriptScan> script_scans;
+	mutable Mutex script_scans_mutex;
+
+	static bool _scan_global_class_header(GDScriptTokenizer &p_tokenizer, const String &p_path, GlobalClassHeader &r_header);
+	static void _scan_dependencies(GDScriptTokenizer &p_tokenizer, const String &p_path, Vector<String> &r_dependencies);
+	bool _get_script_scan(const String &p_path, bool p_header, bool p_dependencies, ScriptScan &r_scan) const;
 	String _get_global_class_name(const String &p_path, String *r_base_type, String *r_icon_path, bool *r_is_abstract, bool *r_is_tool, LocalVector<String> &r_visited) const;
 
 	friend class GDScriptInstance;
@@ -471,6 +548,15 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	bool profile_native_calls;
 	uint64_t script_frame_time;
+
+	// Functions with profile data in the current frame, and those reported for the last one,
+	// so that flipping frames doesn't need to walk every function.
+	Mutex profile_dirty_mutex;
+	LocalVector<GDScriptFunction *> profile_dirty_functions;
+	LocalVector<GDScriptFunction *> profile_last_frame_functions;
+
+	uint64_t breakpoints_hash = 0;
+	void _sync_breakpoint_traps();
 #endif
 
 	HashMap<String, ObjectID> orphan_subclasses;
@@ -478,10 +564,17 @@ class GDScriptLanguage : public ScriptLanguage {
 #ifdef TOOLS_ENABLED
 	void _extension_loaded(const Ref<GDExtension> &p_extension);
 	void _extension_unloading(const Ref<GDExtension> &p_extension);
+
+	Error _complete_code(GDScriptParser &parser, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint);
+	Error _lookup_code(GDScriptParser &parser, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result);
 #endif
 
 public:
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
+#ifdef DEBUG_ENABLED
+	// `EngineDebugger::line_poll()`, then applies the breakpoints it may have received.
+	void debug_line_poll();
+#endif
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
 	_FORCE_INLINE_ void enter_function(CallLevel *call_level, GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
@@ -581,6 +674,17 @@ public:
 
 	_FORCE_INLINE_ bool should_track_call_stack() const { return track_call_stack; }
 	_FORCE_INLINE_ bool should_track_locals() const { return track_locals; }
+	_FORCE_INLINE_ bool is_lean_bytecode_enabled() const { return lean_bytecode; }
+	_FORCE_INLINE_ bool is_jit_enabled() const { return jit_enabled; }
+	_FORCE_INLINE_ uint32_t get_jit_call_threshold() const { return jit_call_threshold; }
+	void set_jit_enabled(bool p_enabled, uint32_t p_call_threshold);
+
+	bool is_native_subclass(const StringName &p_class, const StringName &p_base);
+	void invalidate_native_class_ranges() { native_class_ranges_dirty.set(); }
+
+	_FORCE_INLINE_ uint32_t get_script_hierarchy_epoch() const { return script_hierarchy_epoch.get(); }
+	void invalidate_devirtualized_calls() { script_hierarchy_epoch.increment(); }
+	GDScriptFunction *devirtualize_method(GDScript *p_receiver, const StringName &p_method, GDScript **r_key);
 	_FORCE_INLINE_ int get_global_array_size() const { return global_array.size(); }
 	_FORCE_INLINE_ Variant *get_global_array() { return _global_array; }
 	_FORCE_INLINE_ const HashMap<StringName, int> &get_global_map() const { return globals; }
@@ -618,6 +722,14 @@ public:
 	virtual Error complete_code(const String &p_code, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint) override;
 #ifdef TOOLS_ENABLED
 	virtual Error lookup_code(const String &p_code, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result) override;
+
+	// Variants of `complete_code()` and `lookup_code()` taking the cursor as a zero-based
+	// line and character in `p_code`, instead of a sentinel character inserted in it.
+	Error complete_code_at(const String &p_code, int p_line, int p_character, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint);
+	Error lookup_code_at(const String &p_code, int p_line, int p_character, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result);
+
+	// Completion options for native class members are cached, and must be rebuilt when ClassDB changes.
+	void clear_native_completion_cache();
 #endif
 	virtual String _get_indentation() const;
 	virtual void auto_indent_code(String &p_code, int p_from_line, int p_to_line) const override;
@@ -664,6 +776,9 @@ public:
 
 	virtual bool handles_global_class_type(const String &p_type) const override;
 	virtual String get_global_class_name(const String &p_path, String *r_base_type = nullptr, String *r_icon_path = nullptr, bool *r_is_abstract = nullptr, bool *r_is_tool = nullptr) const override;
+	// The paths of `preload()` and `extends` constants, without parsing the script.
+	Vector<String> get_script_dependencies(const String &p_path) const;
+	void forget_script_scan(const String &p_path);
 
 	void add_orphan_subclass(const String &p_qualified_name, const ObjectID &p_subclass);
 	Ref<GDScript> get_orphan_subclass(const String &p_qualified_name);
@@ -31,6 +31,7 @@
 #include "gdscript_analyzer.h"
 
 #include "gdscript.h"
+#include "gdscript_const_evaluator.h"
 #include "gdscript_utility_callable.h"
 #include "gdscript_utility_functions.h"
 
@@ -2051,7 +2052,20 @@ void GDScriptAnalyzer::resolve_function_body(GDScriptParser::FunctionNode *p_fun
 	bool previous_static_context = static_context;
 	static_context = p_function->is_static;
 
+	// Another function's body can be resolved while inside a guarded block.
+	LocalVector<TypeNarrowing> previous_type_narrowings = type_narrowings;
+	LocalVector<GDScriptParser::VariableNode *> previous_container_locals = container_locals;
+	int previous_loop_depth = loop_depth;
+	type_narrowings.clear();
+	container_locals.clear();
+	loop_depth = 0;
+
 	resolve_suite(p_function->body);
+	hoist_container_locals();
+
+	type_narrowings = previous_type_narrowings;
+	container_locals = previous_container_locals;
+	loop_depth = previous_loop_depth;
 
 	if (!p_function->get_datatype().is_hard_type() && p_function->body->get_datatype().is_set()) {
 		// Use the suite inferred type if return isn't explicitly set.
@@ -2252,6 +2266,10 @@ void GDScriptAnalyzer::resolve_variable(GDScriptParser::VariableNode *p_variable
 	static constexpr const char *kind = "variable";
 	resolve_assignable(p_variable, kind);
 
+	if (p_is_local && p_variable->initializer != nullptr && (p_variable->initializer->type == GDScriptParser::Node::ARRAY || p_variable->initializer->type == GDScriptParser::Node::DICTIONARY)) {
+		container_locals.push_back(p_variable);
+	}
+
 #ifdef DEBUG_ENABLED
 	if (p_is_local) {
 		if (p_variable->usages == 0 && !String(p_variable->identifier->name).begins_with("_")) {
@@ -2281,10 +2299,284 @@ void GDScriptAnalyzer::resolve_parameter(GDScriptParser::ParameterNode *p_parame
 	resolve_assignable(p_parameter, kind);
 }
 
+const GDScriptParser::Node *GDScriptAnalyzer::get_local_declaration(const GDScriptParser::IdentifierNode *p_identifier) {
+	switch (p_identifier->source) {
+		case GDScriptParser::IdentifierNode::FUNCTION_PARAMETER:
+			return p_identifier->parameter_source;
+		case GDScriptParser::IdentifierNode::LOCAL_VARIABLE:
+			return p_identifier->variable_source;
+		case GDScriptParser::IdentifierNode::LOCAL_ITERATOR:
+		case GDScriptParser::IdentifierNode::LOCAL_BIND:
+			return p_identifier->bind_source;
+		default:
+			return nullptr;
+	}
+}
+
+GDScriptParser::IdentifierNode *GDScriptAnalyzer::get_narrowable_local(GDScriptParser::ExpressionNode *p_expression) {
+	if (p_expression == nullptr || p_expression->type != GDScriptParser::Node::IDENTIFIER || p_expression->get_datatype().is_hard_type()) {
+		return nullptr;
+	}
+	GDScriptParser::IdentifierNode *identifier = static_cast<GDScriptParser::IdentifierNode *>(p_expression);
+	return get_local_declaration(identifier) != nullptr ? identifier : nullptr;
+}
+
+GDScriptParser::ExpressionNode *GDScriptAnalyzer::get_typeof_argument(GDScriptParser::ExpressionNode *p_expression) {
+	if (p_expression == nullptr || p_expression->type != GDScriptParser::Node::CALL) {
+		return nullptr;
+	}
+	GDScriptParser::CallNode *call = static_cast<GDScriptParser::CallNode *>(p_expression);
+	if (call->is_super || call->callee == nullptr || call->callee->type != GDScriptParser::Node::IDENTIFIER || call->function_name != SNAME("typeof") || call->arguments.size() != 1) {
+		return nullptr;
+	}
+	return call->arguments[0];
+}
+
+bool GDScriptAnalyzer::get_typeof_narrowing(const GDScriptParser::ExpressionNode *p_value, GDScriptParser::DataType &r_type) {
+	if (p_value == nullptr || !p_value->is_constant || p_value->reduced_value.get_type() != Variant::INT) {
+		return false;
+	}
+	const int64_t type = p_value->reduced_value;
+	if (type <= Variant::NIL || type == Variant::OBJECT || type >= Variant::VARIANT_MAX) {
+		return false;
+	}
+	r_type = GDScriptParser::DataType();
+	r_type.kind = GDScriptParser::DataType::BUILTIN;
+	r_type.builtin_type = Variant::Type(type);
+	return true;
+}
+
+void GDScriptAnalyzer::add_type_narrowing(GDScriptParser::IdentifierNode *p_identifier, const GDScriptParser::DataType &p_type) {
+	if (current_lambda != nullptr || p_type.is_meta_type) {
+		// Lambda bodies are resolved later, out of the guarded region.
+		return;
+	}
+
+	switch (p_type.kind) {
+		case GDScriptParser::DataType::BUILTIN:
+			if (p_type.builtin_type == Variant::NIL || p_type.builtin_type == Variant::OBJECT) {
+				return;
+			}
+			break;
+		case GDScriptParser::DataType::NATIVE:
+		case GDScriptParser::DataType::SCRIPT:
+		case GDScriptParser::DataType::CLASS:
+			break;
+		default:
+			return;
+	}
+
+	TypeNarrowing narrowing;
+	narrowing.declaration = get_local_declaration(p_identifier);
+	narrowing.type = p_type;
+	narrowing.type.type_source = GDScriptParser::DataType::ANNOTATED_INFERRED;
+	narrowing.type.is_constant = false;
+	narrowing.type.is_coroutine = false;
+	narrowing.type.container_element_types.clear();
+	narrowing.loop_depth = loop_depth;
+	type_narrowings.push_back(narrowing);
+}
+
+// Finds the untyped locals whose type is known when `p_condition` is true. The compiler can then use typed
+// opcodes for them in the guarded block, as long as they aren't assigned, see `kill_type_narrowing()`.
+void GDScriptAnalyzer::push_type_narrowings(GDScriptParser::ExpressionNode *p_condition) {
+	if (p_condition == nullptr) {
+		return;
+	}
+
+	switch (p_condition->type) {
+		case GDScriptParser::Node::TYPE_TEST: {
+			// `value is Type`.
+			GDScriptParser::TypeTestNode *type_test = static_cast<GDScriptParser::TypeTestNode *>(p_condition);
+			GDScriptParser::IdentifierNode *local = get_narrowable_local(type_test->operand);
+			if (local != nullptr) {
+				add_type_narrowing(local, type_test->test_datatype);
+			}
+		} break;
+		case GDScriptParser::Node::CAST: {
+			// `value as Type`, only true for objects.
+			GDScriptParser::CastNode *cast = static_cast<GDScriptParser::CastNode *>(p_condition);
+			GDScriptParser::IdentifierNode *local = get_narrowable_local(cast->operand);
+			if (local != nullptr && cast->get_datatype().is_hard_type() && cast->get_datatype().kind != GDScriptParser::DataType::BUILTIN) {
+				add_type_narrowing(local, cast->get_datatype());
+			}
+		} break;
+		case GDScriptParser::Node::BINARY_OPERATOR: {
+			GDScriptParser::BinaryOpNode *binary_op = static_cast<GDScriptParser::BinaryOpNode *>(p_condition);
+			if (binary_op->operation == GDScriptParser::BinaryOpNode::OP_LOGIC_AND) {
+				push_type_narrowings(binary_op->left_operand);
+				push_type_narrowings(binary_op->right_operand);
+			} else if (binary_op->operation == GDScriptParser::BinaryOpNode::OP_COMP_EQUAL) {
+				// `typeof(value) == TYPE_*`, in either order.
+				for (int i = 0; i < 2; i++) {
+					GDScriptParser::ExpressionNode *call = i == 0 ? binary_op->left_operand : binary_op->right_operand;
+					GDScriptParser::ExpressionNode *other = i == 0 ? binary_op->right_operand : binary_op->left_operand;
+					GDScriptParser::IdentifierNode *local = get_narrowable_local(get_typeof_argument(call));
+					GDScriptParser::DataType type;
+					if (local != nullptr && get_typeof_narrowing(other, type)) {
+						add_type_narrowing(local, type);
+						break;
+					}
+				}
+			} else if (binary_op->operation == GDScriptParser::BinaryOpNode::OP_COMP_NOT_EQUAL) {
+				// `value as Type != null`, in either order.
+				for (int i = 0; i < 2; i++) {
+					GDScriptParser::ExpressionNode *cast = i == 0 ? binary_op->left_operand : binary_op->right_operand;
+					GDScriptParser::ExpressionNode *other = i == 0 ? binary_op->right_operand : binary_op->left_operand;
+					if (cast != nullptr && other != nullptr && cast->type == GDScriptParser::Node::CAST && other->is_constant && other->reduced_value.get_type() == Variant::NIL) {
+						push_type_narrowings(cast);
+						break;
+					}
+				}
+			}
+		} break;
+		default:
+			break;
+	}
+}
+
+void GDScriptAnalyzer::pop_type_narrowings(uint32_t p_size) {
+	type_narrowings.resize(p_size);
+}
+
+void GDScriptAnalyzer::apply_type_narrowing(GDScriptParser::IdentifierNode *p_identifier) {
+	if (type_narrowings.is_empty() || current_lambda != nullptr || p_identifier->get_datatype().is_hard_type()) {
+		return;
+	}
+	const GDScriptParser::Node *declaration = get_local_declaration(p_identifier);
+	if (declaration == nullptr) {
+		return;
+	}
+
+	for (int64_t i = int64_t(type_narrowings.size()) - 1; i >= 0; i--) {
+		TypeNarrowing &narrowing = type_narrowings[i];
+		if (narrowing.declaration != declaration) {
+			continue;
+		}
+		if (!narrowing.killed) {
+			p_identifier->narrowed_type = narrowing.type;
+			narrowing.uses.push_back(Pair<GDScriptParser::IdentifierNode *, int>(p_identifier, loop_depth));
+		}
+		return;
+	}
+}
+
+void GDScriptAnalyzer::kill_type_narrowing(const GDScriptParser::IdentifierNode *p_identifier) {
+	const GDScriptParser::Node *declaration = get_local_declaration(p_identifier);
+	if (declaration == nullptr) {
+		return;
+	}
+
+	for (TypeNarrowing &narrowing : type_narrowings) {
+		if (narrowing.declaration != declaration || narrowing.killed) {
+			continue;
+		}
+		narrowing.killed = true;
+		if (loop_depth > narrowing.loop_depth) {
+			// Uses in the loop run again after the assignment.
+			for (const Pair<GDScriptParser::IdentifierNode *, int> &use : narrowing.uses) {
+				if (use.second > narrowing.loop_depth) {
+					use.first->narrowed_type = GDScriptParser::DataType();
+				}
+			}
+		}
+	}
+}
+
+void GDScriptAnalyzer::mark_written(GDScriptParser::ExpressionNode *p_target) {
+	// Writing through a subscript changes the base too when it's a value type.
+	while (p_target != nullptr && p_target->type == GDScriptParser::Node::SUBSCRIPT) {
+		p_target = static_cast<GDScriptParser::SubscriptNode *>(p_target)->base;
+	}
+	if (p_target == nullptr || p_target->type != GDScriptParser::Node::IDENTIFIER) {
+		return;
+	}
+
+	GDScriptParser::IdentifierNode *identifier = static_cast<GDScriptParser::IdentifierNode *>(p_target);
+	if (identifier->source == GDScriptParser::IdentifierNode::FUNCTION_PARAMETER && identifier->parameter_source != nullptr) {
+		identifier->parameter_source->is_modified = true;
+	} else if (identifier->source == GDScriptParser::IdentifierNode::LOCAL_VARIABLE && identifier->variable_source != nullptr) {
+		identifier->variable_source->is_modified = true;
+	}
+}
+
+// The container is only read where it's used: indexed, iterated, tested with `in`, or used as base of a const method.
+// Such a use doesn't let the container escape, so a constant literal can be shared and any other literal can reuse its storage.
+void GDScriptAnalyzer::mark_read_only_use(GDScriptParser::ExpressionNode *p_expression) {
+	if (p_expression == nullptr) {
+		return;
+	}
+
+	switch (p_expression->type) {
+		case GDScriptParser::Node::IDENTIFIER: {
+			GDScriptParser::IdentifierNode *identifier = static_cast<GDScriptParser::IdentifierNode *>(p_expression);
+			if (identifier->source == GDScriptParser::IdentifierNode::LOCAL_VARIABLE && identifier->variable_source != nullptr && !identifier->is_read_only_use && identifier->variable_source->escaping_uses > 0) {
+				identifier->is_read_only_use = true;
+				identifier->variable_source->escaping_uses--;
+			}
+		} break;
+		case GDScriptParser::Node::ARRAY: {
+			GDScriptParser::ArrayNode *array = static_cast<GDScriptParser::ArrayNode *>(p_expression);
+			if (!hoist_container_literal(array)) {
+				array->is_scratch = true;
+			}
+		} break;
+		case GDScriptParser::Node::DICTIONARY:
+			hoist_container_literal(p_expression);
+			break;
+		default:
+			break;
+	}
+}
+
+// Turns a container literal made only of constants into a read-only constant, so it isn't built on each evaluation.
+bool GDScriptAnalyzer::hoist_container_literal(GDScriptParser::ExpressionNode *p_literal) {
+	if (p_literal->is_constant) {
+		return true;
+	}
+
+	bool is_reduced = false;
+	Variant value = make_expression_reduced_value(p_literal, is_reduced);
+	if (!is_reduced) {
+		return false;
+	}
+
+	// Nested containers and objects could still be modified through the elements read out of it.
+	Array values;
+	if (value.get_type() == Variant::DICTIONARY) {
+		const Dictionary dictionary = value;
+		values = dictionary.keys();
+		values.append_array(dictionary.values());
+	} else {
+		values = value;
+	}
+	for (int i = 0; i < values.size(); i++) {
+		const Variant::Type element_type = values[i].get_type();
+		if (element_type == Variant::ARRAY || element_type == Variant::DICTIONARY || element_type == Variant::OBJECT) {
+			return false;
+		}
+	}
+
+	p_literal->is_constant = true;
+	p_literal->reduced_value = value;
+	return true;
+}
+
+void GDScriptAnalyzer::hoist_container_locals() {
+	for (GDScriptParser::VariableNode *local : container_locals) {
+		if (!local->is_modified && local->escaping_uses == 0) {
+			hoist_container_literal(local->initializer);
+		}
+	}
+}
+
 void GDScriptAnalyzer::resolve_if(GDScriptParser::IfNode *p_if) {
 	reduce_expression(p_if->condition);
 
+	const uint32_t narrowings = type_narrowings.size();
+	push_type_narrowings(p_if->condition);
 	resolve_suite(p_if->true_block);
+	pop_type_narrowings(narrowings);
 	p_if->set_datatype(p_if->true_block->get_datatype());
 
 	if (p_if->false_block != nullptr) {
@@ -2405,7 +2697,12 @@ void GDScriptAnalyzer::resolve_for(GDScriptParser::ForNode *p_for) {
 		}
 	}
 
+	// After the literal got its element type from the iterator.
+	mark_read_only_use(p_for->list);
+
+	loop_depth++;
 	resolve_suite(p_for->loop);
+	loop_depth--;
 	p_for->set_datatype(p_for->loop->get_datatype());
 #ifdef DEBUG_ENABLED
 	if (p_for->variable) {
@@ -2415,9 +2712,11 @@ void GDScriptAnalyzer::resolve_for(GDScriptParser::ForNode *p_for) {
 }
 
 void GDScriptAnalyzer::resolve_while(GDScriptParser::WhileNode *p_while) {
+	loop_depth++;
 	resolve_node(p_while->condition, false);
 
 	resolve_suite(p_while->loop);
+	loop_depth--;
 	p_while->set_datatype(p_while->loop->get_datatype());
 }
 
@@ -2464,11 +2763,37 @@ void GDScriptAnalyzer::resolve_match_branch(GDScriptParser::MatchBranchNode *p_m
 		resolve_match_pattern(p_match_branch->patterns[i], p_match_test);
 	}
 
+	// `match typeof(value):` narrows `value` in branches testing a single type.
+	const uint32_t narrowings = type_narrowings.size();
+	GDScriptParser::IdentifierNode *typeof_local = get_narrowable_local(get_typeof_argument(p_match_test));
+	if (typeof_local != nullptr && !p_match_branch->patterns.is_empty()) {
+		GDScriptParser::DataType narrowed_type;
+		bool narrowable = true;
+		for (const GDScriptParser::PatternNode *pattern : p_match_branch->patterns) {
+			const GDScriptParser::ExpressionNode *value = nullptr;
+			if (pattern->pattern_type == GDScriptParser::PatternNode::PT_LITERAL) {
+				value = pattern->literal;
+			} else if (pattern->pattern_type == GDScriptParser::PatternNode::PT_EXPRESSION) {
+				value = pattern->expression;
+			}
+			GDScriptParser::DataType pattern_type;
+			if (!get_typeof_narrowing(value, pattern_type) || (narrowed_type.is_set() && narrowed_type != pattern_type)) {
+				narrowable = false;
+				break;
+			}
+			narrowed_type = pattern_type;
+		}
+		if (narrowable) {
+			add_type_narrowing(typeof_local, narrowed_type);
+		}
+	}
+
 	if (p_match_branch->guard_body) {
 		resolve_suite(p_match_branch->guard_body);
 	}
 
 	resolve_suite(p_match_branch->block);
+	pop_type_narrowings(narrowings);
 
 	decide_suite_type(p_match_branch, p_match_branch->block);
 }
@@ -2891,6 +3216,10 @@ void GDScriptAnalyzer::update_dictionary_literal_element_type(GDScriptParser::Di
 void GDScriptAnalyzer::reduce_assignment(GDScriptParser::AssignmentNode *p_assignment) {
 	reduce_expression(p_assignment->assigned_value);
 
+	if (p_assignment->assignee->type == GDScriptParser::Node::IDENTIFIER) {
+		kill_type_narrowing(static_cast<GDScriptParser::IdentifierNode *>(p_assignment->assignee));
+	}
+
 #ifdef DEBUG_ENABLED
 	// Increment assignment count for local variables.
 	// Before we reduce the assignee because we don't want to warn about not being assigned when performing the assignment.
@@ -2903,6 +3232,7 @@ void GDScriptAnalyzer::reduce_assignment(GDScriptParser::AssignmentNode *p_assig
 #endif // DEBUG_ENABLED
 
 	reduce_expression(p_assignment->assignee);
+	mark_written(p_assignment->assignee);
 
 #ifdef DEBUG_ENABLED
 	{
@@ -3130,6 +3460,10 @@ void GDScriptAnalyzer::reduce_binary_op(GDScriptParser::BinaryOpNode *p_binary_o
 	reduce_expression(p_binary_op->left_operand);
 	reduce_expression(p_binary_op->right_operand);
 
+	if (p_binary_op->operation == GDScriptParser::BinaryOpNode::OP_CONTENT_TEST) {
+		mark_read_only_use(p_binary_op->right_operand);
+	}
+
 	GDScriptParser::DataType left_type;
 	if (p_binary_op->left_operand) {
 		left_type = p_binary_op->left_operand->get_datatype();
@@ -3522,6 +3856,16 @@ void GDScriptAnalyzer::reduce_call(GDScriptParser::CallNode *p_call, bool p_is_a
 		} else if (GDScriptUtilityFunctions::function_exists(function_name)) {
 			MethodInfo function_info = GDScriptUtilityFunctions::get_function_info(function_name);
 
+			if (function_name == SNAME("swap")) {
+				// Writes to both arguments.
+				for (GDScriptParser::ExpressionNode *argument : p_call->arguments) {
+					if (argument->type == GDScriptParser::Node::IDENTIFIER) {
+						kill_type_narrowing(static_cast<GDScriptParser::IdentifierNode *>(argument));
+					}
+					mark_written(argument);
+				}
+			}
+
 			if (!p_is_root && !p_is_await && function_info.return_val.type == Variant::NIL && ((function_info.return_val.usage & PROPERTY_USAGE_NIL_IS_VARIANT) == 0)) {
 				push_error(vformat(R"*(Cannot get return value of call to "%s()" because it returns "void".)*", function_name), p_call);
 			}
@@ -3672,6 +4016,12 @@ void GDScriptAnalyzer::reduce_call(GDScriptParser::CallNode *p_call, bool p_is_a
 			reduce_expression(subscript->base);
 			base_type = subscript->base->get_datatype();
 			is_self = subscript->base->type == GDScriptParser::Node::SELF;
+
+			if (base_type.kind == GDScriptParser::DataType::BUILTIN && !base_type.is_meta_type && (base_type.builtin_type == Variant::ARRAY || base_type.builtin_type == Variant::DICTIONARY)) {
+				if (Variant::has_builtin_method(base_type.builtin_type, p_call->function_name) && Variant::is_builtin_method_const(base_type.builtin_type, p_call->function_name)) {
+					mark_read_only_use(subscript->base);
+				}
+			}
 		}
 	} else {
 		// Invalid call. Error already sent in parser.
@@ -3784,6 +4134,20 @@ void GDScriptAnalyzer::reduce_call(GDScriptParser::CallNode *p_call, bool p_is_a
 		}
 #endif // DEBUG_ENABLED
 
+		if (all_is_constant && p_call->is_static && !is_constructor && (is_self || base_type.is_meta_type)) {
+			// Pure static functions from this file can be run now. Reference types are left to `make_call_reduced_value()`,
+			// since a folded value would be shared between calls.
+			Vector<Variant> args;
+			for (int i = 0; i < p_call->arguments.size(); i++) {
+				args.push_back(p_call->arguments[i]->reduced_value);
+			}
+			Variant value;
+			if (make_static_call_reduced_value(p_call, base_type, args, value) && !Variant::is_type_shared(value.get_type()) && !value.is_array()) {
+				p_call->is_constant = true;
+				p_call->reduced_value = value;
+			}
+		}
+
 		call_type = return_type;
 	} else {
 		bool found = false;
@@ -4539,6 +4903,10 @@ void GDScriptAnalyzer::reduce_identifier(GDScriptParser::IdentifierNode *p_ident
 		case GDScriptParser::IdentifierNode::LOCAL_VARIABLE:
 			p_identifier->set_datatype(p_identifier->variable_source->get_datatype());
 			found_source = true;
+			if (p_identifier->source == GDScriptParser::IdentifierNode::LOCAL_VARIABLE) {
+				// Until a read-only use is recognized, see `mark_read_only_use()`.
+				p_identifier->variable_source->escaping_uses++;
+			}
 #ifdef DEBUG_ENABLED
 			if (p_identifier->variable_source && p_identifier->variable_source->assignments == 0 && !(p_identifier->get_datatype().is_hard_type() && p_identifier->get_datatype().kind == GDScriptParser::DataType::BUILTIN)) {
 				parser->push_warning(p_identifier, GDScriptWarning::UNASSIGNED_VARIABLE, p_identifier->name);
@@ -4562,6 +4930,10 @@ void GDScriptAnalyzer::reduce_identifier(GDScriptParser::IdentifierNode *p_ident
 			break;
 	}
 
+	if (found_source) {
+		apply_type_narrowing(p_identifier);
+	}
+
 #ifdef DEBUG_ENABLED
 	if (!found_source && p_identifier->suite != nullptr && p_identifier->suite->has_local(p_identifier->name)) {
 		parser->push_warning(p_identifier, GDScriptWarning::CONFUSABLE_LOCAL_USAGE, p_identifier->name);
@@ -4896,6 +5268,10 @@ void GDScriptAnalyzer::reduce_subscript(GDScriptParser::SubscriptNode *p_subscri
 	} else {
 		reduce_expression(p_subscript->base);
 	}
+	if (!p_subscript->is_attribute) {
+		// Attributes aren't, since a method reference would keep the container.
+		mark_read_only_use(p_subscript->base);
+	}
 
 	GDScriptParser::DataType result_type;
 
@@ -5487,6 +5863,43 @@ Variant GDScriptAnalyzer::make_subscript_reduced_value(GDScriptParser::Subscript
 }
 
 Variant GDScriptAnalyzer::make_call_reduced_value(GDScriptParser::CallNode *p_call, bool &is_reduced) {
+	if (p_call->is_static && !p_call->is_super) {
+		GDScriptParser::DataType base_type;
+		if (p_call->get_callee_type() == GDScriptParser::Node::IDENTIFIER) {
+			base_type = parser->current_class->get_datatype();
+		} else if (p_call->get_callee_type() == GDScriptParser::Node::SUBSCRIPT) {
+			const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(p_call->callee);
+			if (subscript->base != nullptr && subscript->base->get_datatype().is_meta_type) {
+				base_type = subscript->base->get_datatype();
+			}
+		}
+
+		Vector<Variant> args;
+		for (int i = 0; i < p_call->arguments.size(); i++) {
+			bool is_arg_value_reduced = false;
+			Variant arg_value = make_expression_reduced_value(p_call->arguments[i], is_arg_value_reduced);
+			if (!is_arg_value_reduced) {
+				return Variant();
+			}
+			args.push_back(arg_value);
+		}
+
+		Variant value;
+		if (!make_static_call_reduced_value(p_call, base_type, args, value)) {
+			return Variant();
+		}
+		if (value.get_type() == Variant::ARRAY) {
+			Array array = value;
+			array.make_read_only();
+		} else if (value.get_type() == Variant::DICTIONARY) {
+			Dictionary dictionary = value;
+			dictionary.make_read_only();
+		}
+
+		is_reduced = true;
+		return value;
+	}
+
 	if (p_call->get_callee_type() == GDScriptParser::Node::IDENTIFIER) {
 		Variant::Type type = Variant::NIL;
 		if (p_call->function_name == SNAME("Array")) {
@@ -5533,6 +5946,25 @@ Variant GDScriptAnalyzer::make_call_reduced_value(GDScriptParser::CallNode *p_ca
 	return Variant();
 }
 
+bool GDScriptAnalyzer::make_static_call_reduced_value(const GDScriptParser::CallNode *p_call, const GDScriptParser::DataType &p_base_type, const Vector<Variant> &p_arguments, Variant &r_value) {
+	if (p_base_type.kind != GDScriptParser::DataType::CLASS || p_base_type.class_type == nullptr) {
+		return false;
+	}
+
+	// Only functions from this file, so reloading another script can't leave stale constants behind.
+	const GDScriptParser::ClassNode *root = p_base_type.class_type;
+	while (root->outer != nullptr) {
+		root = root->outer;
+	}
+	if (root != parser->get_tree()) {
+		return false;
+	}
+
+	const GDScriptParser::ClassNode *owner = nullptr;
+	const GDScriptParser::FunctionNode *function = GDScriptConstEvaluator::find_static_function(p_base_type.class_type, p_call->function_name, &owner);
+	return function != nullptr && GDScriptConstEvaluator::evaluate_static_call(owner, function, p_arguments, r_value, &failed_static_calls);
+}
+
 Array GDScriptAnalyzer::make_array_from_element_datatype(const GDScriptParser::DataType &p_element_datatype, const GDScriptParser::Node *p_source_node) {
 	Array array;
 
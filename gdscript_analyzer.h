@@ -31,6 +31,7 @@
 #pragma once
 
 #include "gdscript_cache.h"
+#include "gdscript_const_evaluator.h"
 #include "gdscript_parser.h"
 
 #include "core/object/object.h"
@@ -55,8 +56,36 @@ class GDScriptAnalyzer {
 	GDScriptParser::LambdaNode *current_lambda = nullptr;
 	List<GDScriptParser::LambdaNode *> pending_body_resolution_lambdas;
 	HashMap<const GDScriptParser::ClassNode *, Ref<GDScriptParserRef>> external_class_parser_cache;
+	GDScriptConstEvaluator::FailedCalls failed_static_calls;
 	bool static_context = false;
 
+	struct TypeNarrowing {
+		const GDScriptParser::Node *declaration = nullptr;
+		GDScriptParser::DataType type;
+		int loop_depth = 0;
+		bool killed = false;
+		LocalVector<Pair<GDScriptParser::IdentifierNode *, int>> uses; // With the loop depth of each use.
+	};
+	LocalVector<TypeNarrowing> type_narrowings;
+	int loop_depth = 0;
+
+	// Locals of the current function initialized with a container literal.
+	LocalVector<GDScriptParser::VariableNode *> container_locals;
+
+	static const GDScriptParser::Node *get_local_declaration(const GDScriptParser::IdentifierNode *p_identifier);
+	static GDScriptParser::IdentifierNode *get_narrowable_local(GDScriptParser::ExpressionNode *p_expression);
+	static GDScriptParser::ExpressionNode *get_typeof_argument(GDScriptParser::ExpressionNode *p_expression);
+	static bool get_typeof_narrowing(const GDScriptParser::ExpressionNode *p_value, GDScriptParser::DataType &r_type);
+	void add_type_narrowing(GDScriptParser::IdentifierNode *p_identifier, const GDScriptParser::DataType &p_type);
+	void push_type_narrowings(GDScriptParser::ExpressionNode *p_condition);
+	void pop_type_narrowings(uint32_t p_size);
+	void apply_type_narrowing(GDScriptParser::IdentifierNode *p_identifier);
+	void kill_type_narrowing(const GDScriptParser::IdentifierNode *p_identifier);
+	void mark_written(GDScriptParser::ExpressionNode *p_target);
+	void mark_read_only_use(GDScriptParser::ExpressionNode *p_expression);
+	bool hoist_container_literal(GDScriptParser::ExpressionNode *p_literal);
+	void hoist_container_locals();
+
 	// Tests for detecting invalid overloading of script members
 	static _FORCE_INLINE_ bool has_member_name_conflict_in_script_class(const StringName &p_name, const GDScriptParser::ClassNode *p_current_class_node, const GDScriptParser::Node *p_member);
 	static _FORCE_INLINE_ bool has_member_name_conflict_in_native_type(const StringName &p_name, const StringName &p_native_type_string);
@@ -121,6 +150,7 @@ class GDScriptAnalyzer {
 	Variant make_dictionary_reduced_value(GDScriptParser::DictionaryNode *p_dictionary, bool &is_reduced);
 	Variant make_subscript_reduced_value(GDScriptParser::SubscriptNode *p_subscript, bool &is_reduced);
 	Variant make_call_reduced_value(GDScriptParser::CallNode *p_call, bool &is_reduced);
+	bool make_static_call_reduced_value(const GDScriptParser::CallNode *p_call, const GDScriptParser::DataType &p_base_type, const Vector<Variant> &p_arguments, Variant &r_value);
 
 	// Helpers.
 	Array make_array_from_element_datatype(const GDScriptParser::DataType &p_element_datatype, const GDScriptParser::Node *p_source_node = nullptr);
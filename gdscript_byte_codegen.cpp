@@ -30,6 +30,7 @@
 
 #include "gdscript_byte_codegen.h"
 
+#include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
 
 uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) {
@@ -148,7 +149,7 @@ void GDScriptByteCodeGenerator::pop_temporary() {
 
 void GDScriptByteCodeGenerator::start_parameters() {
 	if (function->_default_arg_count > 0) {
-		append(GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
+		append_opcode(GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
 		function->default_arguments.push_back(opcodes.size());
 	}
 }
@@ -165,14 +166,20 @@ void GDScriptByteCodeGenerator::write_start(GDScript *p_script, const StringName
 	function->source = p_script->get_script_path();
 
 #ifdef DEBUG_ENABLED
-	function->func_cname = (String(function->source) + " - " + String(p_function_name)).utf8();
-	function->_func_cname = function->func_cname.get_data();
+	if (!GDScriptLanguage::get_singleton()->is_lean_bytecode_enabled()) {
+		function->func_cname = (String(function->source) + " - " + String(p_function_name)).utf8();
+		function->_func_cname = function->func_cname.get_data();
+	}
 #endif
 
 	function->_static = p_static;
 	function->return_type = p_return_type;
 	function->rpc_config = p_rpc_config;
 	function->_argument_count = 0;
+
+	record_instruction_starts = GDScriptLanguage::get_singleton()->is_jit_enabled();
+	// Release builds only track the call stack when the project setting asks for it.
+	track_call_stack = release_codegen ? bool(GLOBAL_GET("debug/settings/gdscript/always_track_call_stacks")) : GDScriptLanguage::get_singleton()->should_track_call_stack();
 }
 
 GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
@@ -193,30 +200,8 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		}
 	}
 
-	if (constant_map.size()) {
-		function->_constant_count = constant_map.size();
-		function->constants.resize(constant_map.size());
-		function->_constants_ptr = function->constants.ptrw();
-		for (const KeyValue<Variant, int> &K : constant_map) {
-			function->constants.write[K.value] = K.key;
-		}
-	} else {
-		function->_constants_ptr = nullptr;
-		function->_constant_count = 0;
-	}
-
-	if (name_map.size()) {
-		function->global_names.resize(name_map.size());
-		function->_global_names_ptr = &function->global_names[0];
-		for (const KeyValue<StringName, int> &E : name_map) {
-			function->global_names.write[E.value] = E.key;
-		}
-		function->_global_names_count = function->global_names.size();
-
-	} else {
-		function->_global_names_ptr = nullptr;
-		function->_global_names_count = 0;
-	}
+	// Constant and global name pointers are set once the whole script is compiled.
+	constant_pool->add_function(function);
 
 	if (opcodes.size()) {
 		function->code = opcodes;
@@ -392,20 +377,37 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
-	if (GDScriptLanguage::get_singleton()->should_track_locals()) {
-		function->stack_debug = stack_debug;
+	const bool lean = GDScriptLanguage::get_singleton()->is_lean_bytecode_enabled();
+	if (lean) {
+		// Breakpoint traps can't be set without a debugger.
+		function->line_opcodes.clear();
+	} else if (GDScriptLanguage::get_singleton()->should_track_locals()) {
+		function->_build_local_variable_table(stack_debug);
 	}
 	function->_stack_size = GDScriptFunction::FIXED_ADDRESSES_MAX + max_locals + temporaries.size();
+	function->_temporary_count = temporaries.size();
 	function->_instruction_args_size = instr_args_max;
+	function->_inline_cache_count = inline_cache_count;
+	function->_operator_cache_count = operator_cache_count;
 
 #ifdef DEBUG_ENABLED
-	function->operator_names = operator_names;
-	function->setter_names = setter_names;
-	function->getter_names = getter_names;
-	function->builtin_methods_names = builtin_methods_names;
-	function->constructors_names = constructors_names;
-	function->utilities_names = utilities_names;
-	function->gds_utilities_names = gds_utilities_names;
+	// Lean bytecode only runs without a debugger, which is the only user of these. The names used in
+	// error messages are looked up again when needed, see `GDScriptFunction::_get_gds_utility_name()`.
+	if (!lean) {
+		function->operator_names = operator_names;
+		function->setter_names = setter_names;
+		function->getter_names = getter_names;
+		function->builtin_methods_names = builtin_methods_names;
+		function->constructors_names = constructors_names;
+		function->utilities_names = utilities_names;
+		function->gds_utilities_names = gds_utilities_names;
+	}
+#endif
+
+#ifdef DEBUG_ENABLED
+	if (EngineDebugger::is_active() && !function->line_opcodes.is_empty()) {
+		function->update_breakpoint_traps(EngineDebugger::get_script_debugger()->get_breakpoints());
+	}
 #endif
 
 	ended = true;
@@ -573,12 +575,9 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	append(Address());
 	append(p_target);
 	append(p_operator);
-	append(0); // Signature storage.
-	append(0); // Return type storage.
-	constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*(opcodes.ptr()));
-	for (int i = 0; i < _pointer_size; i++) {
-		append(0); // Space for function pointer.
-	}
+	append(0); // Index + 1 of the speculation on the operand types, see `GDScriptFunction::Speculation`.
+	append(0); // Misses of the speculation.
+	operator_cache_count++;
 }
 
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
@@ -630,12 +629,9 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 	append(p_right_operand);
 	append(p_target);
 	append(p_operator);
-	append(0); // Signature storage.
-	append(0); // Return type storage.
-	constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*(opcodes.ptr()));
-	for (int i = 0; i < _pointer_size; i++) {
-		append(0); // Space for function pointer.
-	}
+	append(0); // Index + 1 of the speculation on the operand types, see `GDScriptFunction::Speculation`.
+	append(0); // Misses of the speculation.
+	operator_cache_count++;
 }
 
 void GDScriptByteCodeGenerator::write_type_test(const Address &p_target, const Address &p_source, const GDScriptDataType &p_type) {
@@ -842,6 +838,13 @@ void GDScriptByteCodeGenerator::write_get(const Address &p_target, const Address
 	append(p_target);
 }
 
+void GDScriptByteCodeGenerator::write_get_dictionary_key(const Address &p_target, const Address &p_key, const Address &p_source) {
+	append_opcode(GDScriptFunction::OPCODE_GET_DICTIONARY_KEY);
+	append(p_source);
+	append(p_key);
+	append(p_target);
+}
+
 void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
 	if (HAS_BUILTIN_TYPE(p_target) && Variant::get_member_validated_setter(p_target.type.builtin_type, p_name) &&
 			IS_BUILTIN_TYPE(p_source, Variant::get_member_type(p_target.type.builtin_type, p_name))) {
@@ -859,11 +862,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders: cached class pointer, cached PropertySetGet pointer (PIC entries).
-	}
+	append_inline_cache(); // Cached class and PropertySetGet.
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -882,33 +881,21 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders: cached class pointer, cached PropertySetGet pointer (PIC entries).
-	}
+	append_inline_cache(); // Cached class and PropertySetGet.
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
 	append_opcode(GDScriptFunction::OPCODE_SET_MEMBER);
 	append(p_value);
 	append(p_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for self member access (PIC entries).
-	}
+	append_inline_cache(); // Cached self member access.
 }
 
 void GDScriptByteCodeGenerator::write_get_member(const Address &p_target, const StringName &p_name) {
 	append_opcode(GDScriptFunction::OPCODE_GET_MEMBER);
 	append(p_target);
 	append(p_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for self member access (PIC entries).
-	}
+	append_inline_cache(); // Cached self member access.
 }
 
 void GDScriptByteCodeGenerator::write_set_static_variable(const Address &p_value, const Address &p_class, int p_index) {
@@ -1110,11 +1097,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for method call PIC.
-	}
+	append_inline_cache(); // Cached method call.
 	ct.cleanup();
 }
 
@@ -1140,11 +1123,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for method call PIC.
-	}
+	append_inline_cache(); // Cached method call.
 	ct.cleanup();
 }
 
@@ -1370,7 +1349,7 @@ void GDScriptByteCodeGenerator::write_call_method_bind_validated(const Address &
 }
 
 void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
-	append_opcode_and_argcount(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN, 2 + p_arguments.size());
+	append_opcode_and_argcount(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL_SCRIPT : GDScriptFunction::OPCODE_CALL_SCRIPT_RETURN, 2 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
 	}
@@ -1379,11 +1358,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for method call PIC.
-	}
+	append_inline_cache(); // Devirtualized script call.
 	ct.cleanup();
 }
 
@@ -1397,16 +1372,12 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for method call PIC.
-	}
+	append_inline_cache(); // Cached method call.
 	ct.cleanup();
 }
 
 void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
-	append_opcode_and_argcount(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN, 2 + p_arguments.size());
+	append_opcode_and_argcount(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL_SCRIPT : GDScriptFunction::OPCODE_CALL_SCRIPT_RETURN, 2 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
 	}
@@ -1415,11 +1386,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
-	constexpr int _ptr_slots = sizeof(void *) / sizeof(int);
-	constexpr int _pic_size = 4;
-	for (int i = 0; i < _ptr_slots * 2 * _pic_size; i++) {
-		append(0); // Inline cache placeholders for method call PIC.
-	}
+	append_inline_cache(); // Devirtualized script call.
 	ct.cleanup();
 }
 
@@ -1518,6 +1485,22 @@ void GDScriptByteCodeGenerator::write_construct_typed_array(const Address &p_tar
 	ct.cleanup();
 }
 
+void GDScriptByteCodeGenerator::write_construct_scratch_array(const Address &p_target, const Vector<Address> &p_arguments) {
+	// A temporary slot that is never pooled nor cleared, so the array storage lives as long as the frame.
+	Address scratch(Address::TEMPORARY, temporaries.size());
+	temporaries.push_back(StackSlot(Variant::NIL, true));
+
+	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_SCRATCH_ARRAY, 2 + p_arguments.size());
+	for (int i = 0; i < p_arguments.size(); i++) {
+		append(p_arguments[i]);
+	}
+	append(scratch);
+	CallTarget ct = get_call_target(p_target);
+	append(ct.target);
+	append(p_arguments.size());
+	ct.cleanup();
+}
+
 void GDScriptByteCodeGenerator::write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) {
 	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY, 1 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
@@ -1868,8 +1851,9 @@ void GDScriptByteCodeGenerator::write_breakpoint() {
 }
 
 void GDScriptByteCodeGenerator::write_newline(int p_line) {
-	if (GDScriptLanguage::get_singleton()->should_track_call_stack()) {
+	if (track_call_stack) {
 		// Add newline for debugger and stack tracking if enabled in the project settings.
+		function->line_opcodes.push_back(opcodes.size());
 		append_opcode(GDScriptFunction::OPCODE_LINE);
 		append(p_line);
 		current_line = p_line;
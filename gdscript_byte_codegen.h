@@ -99,13 +99,17 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int inline_cache_count = 0;
+	int operator_cache_count = 0; // Untyped operators, see `GDScriptFunction::_operator_cache_count`.
+	bool record_instruction_starts = false; // Lets the JIT decode past instructions it has no template for.
+	bool release_codegen = false;
+	bool track_call_stack = false;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
 #endif
 
-	HashMap<Variant, int> constant_map;
-	RBMap<StringName, int> name_map;
+	GDScriptConstantPool *constant_pool = nullptr;
 #ifdef TOOLS_ENABLED
 	Vector<StringName> named_globals;
 #endif
@@ -217,23 +221,11 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	}
 
 	int get_name_map_pos(const StringName &p_identifier) {
-		int ret;
-		if (!name_map.has(p_identifier)) {
-			ret = name_map.size();
-			name_map[p_identifier] = ret;
-		} else {
-			ret = name_map[p_identifier];
-		}
-		return ret;
+		return constant_pool->add_global_name(p_identifier);
 	}
 
 	int get_constant_pos(const Variant &p_constant) {
-		if (constant_map.has(p_constant)) {
-			return constant_map[p_constant];
-		}
-		int pos = constant_map.size();
-		constant_map[p_constant] = pos;
-		return pos;
+		return constant_pool->add_constant(p_constant);
 	}
 
 	int get_operation_pos(const Variant::ValidatedOperatorEvaluator p_operation) {
@@ -378,10 +370,16 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	}
 
 	void append_opcode(GDScriptFunction::Opcode p_code) {
+		if (record_instruction_starts) {
+			function->instruction_starts.push_back(opcodes.size());
+		}
 		opcodes.push_back(p_code);
 	}
 
 	void append_opcode_and_argcount(GDScriptFunction::Opcode p_code, int p_argument_count) {
+		if (record_instruction_starts) {
+			function->instruction_starts.push_back(opcodes.size());
+		}
 		opcodes.push_back(p_code);
 		opcodes.push_back(p_argument_count);
 		instr_args_max = MAX(instr_args_max, p_argument_count);
@@ -391,6 +389,14 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		opcodes.push_back(p_code);
 	}
 
+	// Placeholders for a polymorphic inline cache, patched by the VM with pairs of cached class and target pointers.
+	void append_inline_cache() {
+		for (int i = 0; i < GDScriptFunction::INLINE_CACHE_SLOTS; i++) {
+			opcodes.push_back(0);
+		}
+		inline_cache_count++;
+	}
+
 	void append(const Address &p_address) {
 		opcodes.push_back(address_of(p_address));
 	}
@@ -480,6 +486,10 @@ public:
 	virtual void set_signature(const String &p_signature) override;
 #endif
 	virtual void set_initial_line(int p_line) override;
+	virtual bool is_generating_debug_code() const override { return !release_codegen; }
+
+	// Generates the same bytecode as release builds, even in the editor.
+	void set_release_codegen(bool p_enabled) { release_codegen = p_enabled; }
 
 	virtual void write_type_adjust(const Address &p_target, Variant::Type p_new_type) override;
 	virtual void write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) override;
@@ -498,6 +508,7 @@ public:
 	virtual void write_end_ternary() override;
 	virtual void write_set(const Address &p_target, const Address &p_index, const Address &p_source) override;
 	virtual void write_get(const Address &p_target, const Address &p_index, const Address &p_source) override;
+	virtual void write_get_dictionary_key(const Address &p_target, const Address &p_key, const Address &p_source) override;
 	virtual void write_set_named(const Address &p_target, const StringName &p_name, const Address &p_source) override;
 	virtual void write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) override;
 	virtual void write_set_member(const Address &p_value, const StringName &p_name) override;
@@ -532,6 +543,7 @@ public:
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments) override;
+	virtual void write_construct_scratch_array(const Address &p_target, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments) override;
 	virtual void write_await(const Address &p_target, const Address &p_operand) override;
@@ -555,5 +567,7 @@ public:
 	virtual void write_return(const Address &p_return_value) override;
 	virtual void write_assert(const Address &p_test, const Address &p_message) override;
 
+	GDScriptByteCodeGenerator(GDScriptConstantPool *p_constant_pool) :
+			constant_pool(p_constant_pool) {}
 	virtual ~GDScriptByteCodeGenerator();
 };
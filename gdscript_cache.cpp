@@ -36,6 +36,7 @@
 #include "gdscript_parser.h"
 
 #include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/vector.h"
 
 GDScriptParserRef::Status GDScriptParserRef::get_status() const {
@@ -148,6 +149,8 @@ SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG> &_get_gdscript_cache_mutex() {
 	return GDScriptCache::mutex;
 }
 
+thread_local int GDScriptCache::compile_nesting = 0;
+
 template <>
 thread_local SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG>::TLSData SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG>::tls_data(_get_gdscript_cache_mutex());
 SafeBinaryMutex<GDScriptCache::BINARY_MUTEX_TAG> GDScriptCache::mutex;
@@ -165,6 +168,10 @@ void GDScriptCache::move_script(const String &p_from, const String &p_to) {
 
 	remove_parser(p_from);
 
+	if (GDScriptLanguage::get_singleton() != nullptr) {
+		GDScriptLanguage::get_singleton()->forget_script_scan(p_from);
+	}
+
 	if (singleton->shallow_gdscript_cache.has(p_from) && !p_from.is_empty()) {
 		singleton->shallow_gdscript_cache[p_to] = singleton->shallow_gdscript_cache[p_from];
 	}
@@ -207,6 +214,10 @@ void GDScriptCache::remove_script(const String &p_path) {
 	singleton->dependencies.erase(p_path);
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
+
+	if (GDScriptLanguage::get_singleton() != nullptr) {
+		GDScriptLanguage::get_singleton()->forget_script_scan(p_path);
+	}
 }
 
 Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
@@ -231,8 +242,14 @@ Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptP
 		ref.instantiate();
 		ref->path = p_path;
 		singleton->parser_map[p_path] = ref.ptr();
+		singleton->parser_generation++;
 	}
+	_enter_compile();
+	// Analyzing may load other resources, and wait for the threads loading them.
+	uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(singleton->mutex);
 	r_error = ref->raise_status(p_status);
+	WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
+	_exit_compile();
 
 	return ref;
 }
@@ -338,6 +355,26 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 	return script;
 }
 
+bool GDScriptCache::_is_waiting_for(Thread::ID p_thread, Thread::ID p_target) {
+	// Follows the chain of threads waiting for a script another one compiles.
+	Thread::ID thread = p_thread;
+	for (uint32_t i = 0; i <= singleton->waiting_threads.size(); i++) {
+		if (thread == p_target) {
+			return true;
+		}
+		const String *path = singleton->waiting_threads.getptr(thread);
+		if (path == nullptr) {
+			return false;
+		}
+		const Thread::ID *owner = singleton->compiling_scripts.getptr(*path);
+		if (owner == nullptr) {
+			return false;
+		}
+		thread = *owner;
+	}
+	return false;
+}
+
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner, bool p_update_from_disk) {
 	MutexLock lock(singleton->mutex);
 
@@ -345,8 +382,21 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		singleton->dependencies[p_owner].insert(p_path);
 	}
 
-	Ref<GDScript> script;
 	r_error = OK;
+
+	// Wait for another thread compiling the script, unless it's waiting for this one.
+	const Thread::ID caller_id = Thread::get_caller_id();
+	while (singleton->compiling_scripts.has(p_path)) {
+		if (_is_waiting_for(singleton->compiling_scripts[p_path], caller_id)) {
+			// Cyclic dependency, the script is finished further up.
+			return get_cached_script(p_path);
+		}
+		singleton->waiting_threads[caller_id] = p_path;
+		singleton->compiled_condition.wait(lock);
+		singleton->waiting_threads.erase(caller_id);
+	}
+
+	Ref<GDScript> script;
 	if (singleton->full_gdscript_cache.has(p_path)) {
 		script = singleton->full_gdscript_cache[p_path];
 		if (!p_update_from_disk) {
@@ -380,11 +430,16 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 		}
 	}
 
-	// Allowing lifting the lock might cause a script to be reloaded multiple times,
-	// which, as a last resort deadlock prevention strategy, is a good tradeoff.
-	uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(singleton->mutex);
+	// Other scripts can be parsed meanwhile, also the dependencies of this one on the threads loading them.
+	// The analysis and compilation take the mutex again, see `CompileLock`.
+	singleton->compiling_scripts[p_path] = caller_id;
+	_enter_compile();
+	lock.temp_unlock();
 	r_error = script->reload(true);
-	WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
+	lock.temp_relock();
+	_exit_compile();
+	singleton->compiling_scripts.erase(p_path);
+	singleton->compiled_condition.notify_all();
 	if (r_error) {
 		return script;
 	}
@@ -415,16 +470,62 @@ Ref<GDScript> GDScriptCache::get_cached_script(const String &p_path) {
 	return Ref<GDScript>();
 }
 
-Error GDScriptCache::finish_compiling(const String &p_owner) {
+void GDScriptCache::_enter_compile() {
+	// Locked by the caller.
+	if (compile_nesting++ == 0) {
+		singleton->compiling_threads++;
+	}
+}
+
+void GDScriptCache::_exit_compile() {
+	// Locked by the caller.
+	if (--compile_nesting == 0) {
+		singleton->compiling_threads--;
+	}
+}
+
+bool GDScriptCache::is_compiling() {
+	return compile_nesting > 0;
+}
+
+GDScriptCache::CompileLock::CompileLock() :
+		lock(GDScriptCache::mutex) {
+	allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(GDScriptCache::mutex);
+}
+
+GDScriptCache::CompileLock::~CompileLock() {
+	WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
+}
+
+GDScriptCache::CompileScope::CompileScope() {
+	MutexLock lock(GDScriptCache::mutex);
+	_enter_compile();
+}
+
+GDScriptCache::CompileScope::~CompileScope() {
+	MutexLock lock(GDScriptCache::mutex);
+	_exit_compile();
+}
+
+uint64_t GDScriptCache::get_parser_generation() {
 	MutexLock lock(singleton->mutex);
+	return singleton->parser_generation;
+}
 
-	// Mark this as compiled.
-	Ref<GDScript> script = get_cached_script(p_owner);
-	singleton->full_gdscript_cache[p_owner] = script;
-	singleton->shallow_gdscript_cache.erase(p_owner);
+Error GDScriptCache::finish_compiling(const String &p_owner) {
+	HashSet<String> depends;
+	{
+		MutexLock lock(singleton->mutex);
 
-	HashSet<String> depends = singleton->dependencies[p_owner];
+		// Mark this as compiled.
+		Ref<GDScript> script = get_cached_script(p_owner);
+		singleton->full_gdscript_cache[p_owner] = script;
+		singleton->shallow_gdscript_cache.erase(p_owner);
 
+		depends = singleton->dependencies[p_owner];
+	}
+
+	// Not locked, so the dependencies compiled on other threads can finish.
 	Error err = OK;
 	for (const String &E : depends) {
 		Error this_err = OK;
@@ -436,6 +537,7 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 		}
 	}
 
+	MutexLock lock(singleton->mutex);
 	singleton->dependencies.erase(p_owner);
 
 	return err;
@@ -451,6 +553,55 @@ void GDScriptCache::remove_static_script(const String &p_fqcn) {
 	singleton->static_gdscript_cache.erase(p_fqcn);
 }
 
+Dictionary GDScriptCache::compact() {
+	Dictionary report;
+	if (singleton == nullptr) {
+		return report;
+	}
+
+	MutexLock lock(singleton->mutex);
+
+	// Analyzed trees point into the trees of their dependencies, so all go at once.
+	if (singleton->cleared || singleton->compiling_threads > 0 || (singleton->parser_map.is_empty() && singleton->abandoned_parser_map.is_empty())) {
+		return report;
+	}
+
+	const uint64_t memory_before = Memory::get_mem_usage();
+
+	RBSet<Ref<GDScriptParserRef>> parser_refs;
+	for (const KeyValue<String, Vector<ObjectID>> &KV : singleton->abandoned_parser_map) {
+		for (ObjectID parser_ref_id : KV.value) {
+			Ref<GDScriptParserRef> parser_ref = { ObjectDB::get_instance(parser_ref_id) };
+			if (parser_ref.is_valid()) {
+				parser_refs.insert(parser_ref);
+			}
+		}
+	}
+	for (KeyValue<String, GDScriptParserRef *> &E : singleton->parser_map) {
+		parser_refs.insert(E.value);
+	}
+	const int parser_count = singleton->parser_map.size();
+
+	singleton->abandoned_parser_map.clear();
+	singleton->parser_map.clear();
+	singleton->parser_inverse_dependencies.clear();
+
+	// Breaks the cycles between parsers depending on each other.
+	for (const Ref<GDScriptParserRef> &E : parser_refs) {
+		if (E.is_valid()) {
+			E->abandoned = true;
+			E->clear();
+		}
+	}
+	parser_refs.clear();
+
+	report["parsers"] = parser_count;
+	// Only tracked in debug builds.
+	report["memory_before"] = memory_before;
+	report["memory_after"] = Memory::get_mem_usage();
+	return report;
+}
+
 void GDScriptCache::clear() {
 	if (singleton == nullptr) {
 		return;
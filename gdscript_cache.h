@@ -33,7 +33,9 @@
 #include "gdscript.h"
 
 #include "core/object/ref_counted.h"
+#include "core/os/condition_variable.h"
 #include "core/os/safe_binary_mutex.h"
+#include "core/os/thread.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
 
@@ -93,6 +95,12 @@ class GDScriptCache {
 	HashMap<String, Ref<GDScript>> static_gdscript_cache;
 	HashMap<String, HashSet<String>> dependencies;
 	HashMap<String, HashSet<String>> parser_inverse_dependencies;
+	// Scripts being compiled without holding the mutex, and the threads waiting for them.
+	HashMap<String, Thread::ID> compiling_scripts;
+	HashMap<Thread::ID, String> waiting_threads;
+	ConditionVariable compiled_condition;
+	int compiling_threads = 0; // With a nonzero `compile_nesting`.
+	uint64_t parser_generation = 0; // Incremented for each parser created.
 
 	friend class GDScript;
 	friend class GDScriptParserRef;
@@ -112,7 +120,32 @@ private:
 	static SafeBinaryMutex<BINARY_MUTEX_TAG> mutex;
 	friend SafeBinaryMutex<BINARY_MUTEX_TAG> &_get_gdscript_cache_mutex();
 
+	static thread_local int compile_nesting;
+
+	static bool _is_waiting_for(Thread::ID p_thread, Thread::ID p_target);
+	static void _enter_compile();
+	static void _exit_compile();
+
 public:
+	// Held while a script is analyzed and compiled, since the analyzer raises and reads the trees of
+	// its dependencies, which other threads share. Waiting for a task of the worker thread pool, as
+	// loading another resource does, releases the mutex so that task can use the cache.
+	class CompileLock {
+		MutexLock<SafeBinaryMutex<BINARY_MUTEX_TAG>> lock;
+		uint32_t allowance_id = 0;
+
+	public:
+		CompileLock();
+		~CompileLock();
+	};
+
+	// Counts a compile that doesn't go through the cache, such as reloading a script, see `compact()`.
+	class CompileScope {
+	public:
+		CompileScope();
+		~CompileScope();
+	};
+
 	static void move_script(const String &p_from, const String &p_to);
 	static void remove_script(const String &p_path);
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
@@ -128,10 +161,22 @@ public:
 	 */
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String(), bool p_update_from_disk = false);
 	static Ref<GDScript> get_cached_script(const String &p_path);
+	// Whether this thread is parsing or compiling a script, and so can't wait for other loads.
+	static bool is_compiling();
+	// Changes whenever a script is parsed, to tell when loading has settled.
+	static uint64_t get_parser_generation();
 	static Error finish_compiling(const String &p_owner);
 	static void add_static_script(Ref<GDScript> p_script);
 	static void remove_static_script(const String &p_fqcn);
 
+	/**
+	 * Releases the parsers and analyzers kept for compiled scripts. Scripts loaded later parse
+	 * their dependencies again, the compiled scripts don't need them.
+	 *
+	 * Does nothing while a script is parsed or compiled. Returns a report of the released memory,
+	 * empty if nothing was released.
+	 */
+	static Dictionary compact();
 	static void clear();
 
 	GDScriptCache();
@@ -89,6 +89,8 @@ public:
 	virtual void set_signature(const String &p_signature) = 0;
 #endif
 	virtual void set_initial_line(int p_line) = 0;
+	// Whether asserts, breakpoints and line tracking are generated in debug builds.
+	virtual bool is_generating_debug_code() const { return true; }
 
 	virtual void write_type_adjust(const Address &p_target, Variant::Type p_new_type) = 0;
 	virtual void write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) = 0;
@@ -107,6 +109,7 @@ public:
 	virtual void write_end_ternary() = 0;
 	virtual void write_set(const Address &p_target, const Address &p_index, const Address &p_source) = 0;
 	virtual void write_get(const Address &p_target, const Address &p_index, const Address &p_source) = 0;
+	virtual void write_get_dictionary_key(const Address &p_target, const Address &p_key, const Address &p_source) = 0;
 	virtual void write_set_named(const Address &p_target, const StringName &p_name, const Address &p_source) = 0;
 	virtual void write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) = 0;
 	virtual void write_set_member(const Address &p_value, const StringName &p_name) = 0;
@@ -140,6 +143,7 @@ public:
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) = 0;
 	virtual void write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) = 0;
 	virtual void write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments) = 0;
+	virtual void write_construct_scratch_array(const Address &p_target, const Vector<Address> &p_arguments) = 0;
 	virtual void write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) = 0;
 	virtual void write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments) = 0;
 	virtual void write_await(const Address &p_target, const Address &p_operand) = 0;
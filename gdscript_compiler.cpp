@@ -34,6 +34,8 @@
 #include "gdscript_analyzer.h"
 #include "gdscript_byte_codegen.h"
 #include "gdscript_cache.h"
+#include "gdscript_cpp_codegen.h"
+#include "gdscript_native.h"
 #include "gdscript_utility_functions.h"
 
 #include "core/config/engine.h"
@@ -254,6 +256,53 @@ static bool _can_use_validate_call(const MethodBind *p_method, const Vector<GDSc
 	return true;
 }
 
+// Same slot, typed as narrowed by an enclosing `is` or `typeof()` guard, so the typed opcodes can be used.
+GDScriptCodeGenerator::Address GDScriptCompiler::_get_narrowed_address(CodeGen &codegen, const GDScriptParser::IdentifierNode *p_identifier, const GDScriptCodeGenerator::Address &p_address) {
+	if (!p_identifier->narrowed_type.is_set() || p_address.type.has_type()) {
+		return p_address;
+	}
+	GDScriptCodeGenerator::Address narrowed = p_address;
+	narrowed.type = _gdtype_from_datatype(p_identifier->narrowed_type, codegen.script);
+	return narrowed;
+}
+
+// Constant key read from a statically typed `Dictionary`, converted ahead to the key type of the dictionary.
+// Untyped keys become a `StringName`, since it carries its hash and compares equal to a `String` key.
+// A `String` key type keeps a `String` constant, which the dictionary validates and hashes on each read.
+bool GDScriptCompiler::_get_constant_dictionary_key(const GDScriptParser::SubscriptNode *p_subscript, Variant &r_key) {
+	const GDScriptParser::DataType base_type = p_subscript->base->get_datatype();
+	if (!base_type.is_hard_type() || base_type.is_meta_type || base_type.kind != GDScriptParser::DataType::BUILTIN || base_type.builtin_type != Variant::DICTIONARY) {
+		return false;
+	}
+
+	StringName key;
+	if (p_subscript->is_attribute) {
+		if (p_subscript->attribute == nullptr || Variant::has_builtin_method(Variant::DICTIONARY, p_subscript->attribute->name)) {
+			return false; // A method reference, not a key.
+		}
+		key = p_subscript->attribute->name;
+	} else {
+		if (p_subscript->index == nullptr || !p_subscript->index->is_constant) {
+			return false;
+		}
+		const Variant::Type index_type = p_subscript->index->reduced_value.get_type();
+		if (index_type != Variant::STRING && index_type != Variant::STRING_NAME) {
+			return false;
+		}
+		key = p_subscript->index->reduced_value;
+	}
+
+	const GDScriptParser::DataType key_type = base_type.get_container_element_type_or_variant(0);
+	if (key_type.is_variant() || (key_type.kind == GDScriptParser::DataType::BUILTIN && key_type.builtin_type == Variant::STRING_NAME)) {
+		r_key = key;
+	} else if (key_type.kind == GDScriptParser::DataType::BUILTIN && key_type.builtin_type == Variant::STRING) {
+		r_key = String(key);
+	} else {
+		return false;
+	}
+	return true;
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root, bool p_initializer) {
 	if (p_expression->is_constant && !(p_expression->get_datatype().is_meta_type && p_expression->get_datatype().kind == GDScriptParser::DataType::CLASS)) {
 		return codegen.add_constant(p_expression->reduced_value);
@@ -277,12 +326,12 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 				case GDScriptParser::IdentifierNode::LOCAL_BIND: {
 					// Try function parameters.
 					if (codegen.parameters.has(identifier)) {
-						return codegen.parameters[identifier];
+						return _get_narrowed_address(codegen, in, codegen.parameters[identifier]);
 					}
 
 					// Try local variables and constants.
 					if (!p_initializer && codegen.locals.has(identifier)) {
-						return codegen.locals[identifier];
+						return _get_narrowed_address(codegen, in, codegen.locals[identifier]);
 					}
 				} break;
 
@@ -519,6 +568,8 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 
 			if (array_type.has_container_element_type(0)) {
 				gen->write_construct_typed_array(result, array_type.get_container_element_type(0), values);
+			} else if (an->is_scratch) {
+				gen->write_construct_scratch_array(result, values);
 			} else {
 				gen->write_construct_array(result, values);
 			}
@@ -712,6 +763,9 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 											// Not exact arguments, but still can use method bind call.
 											gen->write_call_method_bind(result, base, method, arguments);
 										}
+									} else if (base.type.kind == GDScriptDataType::GDSCRIPT) {
+										// Script method, can be bound to its function once resolved.
+										gen->write_call_script_function(result, base, call->function_name, arguments);
 									} else {
 										gen->write_call(result, base, call->function_name, arguments);
 									}
@@ -793,6 +847,15 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 				return GDScriptCodeGenerator::Address();
 			}
 
+			Variant dictionary_key;
+			if (_get_constant_dictionary_key(subscript, dictionary_key)) {
+				gen->write_get_dictionary_key(result, codegen.add_constant(dictionary_key), base);
+				if (base.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+					gen->pop_temporary();
+				}
+				return result;
+			}
+
 			bool named = subscript->is_attribute;
 			StringName name;
 			GDScriptCodeGenerator::Address index;
@@ -2222,6 +2285,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::ASSERT: {
 #ifdef DEBUG_ENABLED
+				if (!gen->is_generating_debug_code()) {
+					break;
+				}
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, as->condition);
@@ -2249,7 +2315,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::BREAKPOINT: {
 #ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
+				if (gen->is_generating_debug_code()) {
+					gen->write_breakpoint();
+				}
 #endif
 			} break;
 			case GDScriptParser::Node::VARIABLE: {
@@ -2326,10 +2394,19 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 	return OK;
 }
 
+GDScriptCodeGenerator *GDScriptCompiler::_create_generator(GDScript *p_script) {
+#ifdef TOOLS_ENABLED
+	if (cpp_module) {
+		return memnew(GDScriptCppCodeGenerator(_get_constant_pool(p_script), cpp_module));
+	}
+#endif
+	return memnew(GDScriptByteCodeGenerator(_get_constant_pool(p_script)));
+}
+
 GDScriptFunction *GDScriptCompiler::_parse_function(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_func, bool p_for_ready, bool p_for_lambda) {
 	r_error = OK;
 	CodeGen codegen;
-	codegen.generator = memnew(GDScriptByteCodeGenerator);
+	codegen.generator = _create_generator(p_script);
 
 	codegen.class_node = p_class;
 	codegen.script = p_script;
@@ -2565,6 +2642,15 @@ GDScriptFunction *GDScriptCompiler::_parse_function(Error &r_error, GDScript *p_
 		if (p_func->is_vararg()) {
 			gd_function->_vararg_index = vararg_addr.address;
 		}
+
+		// Coroutines keep their stack after returning, so they can't borrow. Lambdas are only called through callables.
+		if (!p_func->is_coroutine && !p_for_lambda) {
+			for (int i = 0; i < MIN(p_func->parameters.size(), 64); i++) {
+				if (!p_func->parameters[i]->is_modified) {
+					gd_function->_borrowable_args |= uint64_t(1) << i;
+				}
+			}
+		}
 	}
 
 	gd_function->method_info = method_info;
@@ -2581,7 +2667,7 @@ GDScriptFunction *GDScriptCompiler::_parse_function(Error &r_error, GDScript *p_
 GDScriptFunction *GDScriptCompiler::_make_static_initializer(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class) {
 	r_error = OK;
 	CodeGen codegen;
-	codegen.generator = memnew(GDScriptByteCodeGenerator);
+	codegen.generator = _create_generator(p_script);
 
 	codegen.class_node = p_class;
 	codegen.script = p_script;
@@ -2750,6 +2836,8 @@ Error GDScriptCompiler::_prepare_compilation(GDScript *p_script, const GDScriptP
 
 	p_script->native = Ref<GDScriptNativeClass>();
 	p_script->base = Ref<GDScript>();
+	// The errors below return before the base is set again, the ancestors must not point to the old one.
+	p_script->_update_ancestors();
 	p_script->members.clear();
 
 	// This makes possible to clear script constants and member_functions without heap-use-after-free errors.
@@ -2764,6 +2852,7 @@ Error GDScriptCompiler::_prepare_compilation(GDScript *p_script, const GDScriptP
 		member_functions.insert(E.key, E.value);
 	}
 	p_script->member_functions.clear();
+	GDScriptLanguage::get_singleton()->invalidate_devirtualized_calls();
 	for (const KeyValue<StringName, GDScriptFunction *> &E : member_functions) {
 		memdelete(E.value);
 	}
@@ -2877,6 +2966,8 @@ Error GDScriptCompiler::_prepare_compilation(GDScript *p_script, const GDScriptP
 		} break;
 	}
 
+	p_script->_update_ancestors();
+
 	// Duplicate RPC information from base GDScript
 	// Base script isn't valid because it should not have been compiled yet, but the reference contains relevant info.
 	if (base_type.kind == GDScriptDataType::GDSCRIPT && p_script->base.is_valid()) {
@@ -3101,6 +3192,9 @@ Error GDScriptCompiler::_compile_class(GDScript *p_script, const GDScriptParser:
 		}
 	}
 
+	// All functions of the class are compiled, they can run from here on.
+	_finalize_constant_pool(p_script);
+
 #ifdef DEBUG_ENABLED
 
 	//validate instances if keeping state
@@ -3173,6 +3267,41 @@ Error GDScriptCompiler::_compile_class(GDScript *p_script, const GDScriptParser:
 	return OK;
 }
 
+GDScriptConstantPool *GDScriptCompiler::_get_constant_pool(GDScript *p_script) {
+	HashMap<GDScript *, GDScriptConstantPool *>::Iterator E = constant_pools.find(p_script);
+	if (E) {
+		return E->value;
+	}
+	return constant_pools.insert(p_script, memnew(GDScriptConstantPool))->value;
+}
+
+void GDScriptCompiler::_finalize_constant_pool(GDScript *p_script) {
+	HashMap<GDScript *, GDScriptConstantPool *>::Iterator E = constant_pools.find(p_script);
+	if (!E) {
+		return;
+	}
+	// Native code is keyed and translated with the final constant count.
+	const LocalVector<GDScriptFunction *> functions = E->value->get_functions();
+	E->value->finalize();
+	for (GDScriptFunction *function : functions) {
+		function->_native_function = GDScriptNativeFunctions::get_function(function);
+#ifdef TOOLS_ENABLED
+		if (cpp_module) {
+			cpp_module->translate_function(function);
+		}
+#endif
+	}
+	// Drop the compiler's reference, the functions keep the pool alive.
+	E->value->unreference();
+	constant_pools.remove(E);
+}
+
+void GDScriptCompiler::_finalize_constant_pools() {
+	while (!constant_pools.is_empty()) {
+		_finalize_constant_pool(constant_pools.begin()->key);
+	}
+}
+
 void GDScriptCompiler::convert_to_initializer_type(Variant &p_variant, const GDScriptParser::VariableNode *p_node) {
 	// Set p_variant to the value of p_node's initializer, with the type of p_node's variable.
 	GDScriptParser::DataType member_t = p_node->datatype;
@@ -3373,11 +3502,13 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	Error err = _prepare_compilation(main_script, parser->get_tree(), p_keep_state);
 
 	if (err) {
+		_finalize_constant_pools();
 		return err;
 	}
 
 	err = _compile_class(main_script, root, p_keep_state);
 	if (err) {
+		_finalize_constant_pools();
 		return err;
 	}
 
@@ -3387,6 +3518,15 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
+	_finalize_constant_pools();
+
+	// New member functions may override methods that call sites were bound to.
+	GDScriptLanguage::get_singleton()->invalidate_devirtualized_calls();
+
+	if (!update_cache) {
+		return OK;
+	}
+
 	if (has_static_data && !root->annotated_static_unload) {
 		GDScriptCache::add_static_script(p_script);
 	}
@@ -3412,3 +3552,7 @@ int GDScriptCompiler::get_error_column() const {
 
 GDScriptCompiler::GDScriptCompiler() {
 }
+
+GDScriptCompiler::~GDScriptCompiler() {
+	_finalize_constant_pools();
+}
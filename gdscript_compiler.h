@@ -37,6 +37,8 @@
 
 #include "core/templates/hash_set.h"
 
+class GDScriptCppModule;
+
 class GDScriptCompiler {
 	const GDScriptParser *parser = nullptr;
 	HashSet<GDScript *> parsed_classes;
@@ -149,16 +151,22 @@ class GDScriptCompiler {
 
 	GDScriptDataType _gdtype_from_datatype(const GDScriptParser::DataType &p_datatype, GDScript *p_owner, bool p_handle_metatype = true);
 
+	GDScriptCodeGenerator::Address _get_narrowed_address(CodeGen &codegen, const GDScriptParser::IdentifierNode *p_identifier, const GDScriptCodeGenerator::Address &p_address);
+	static bool _get_constant_dictionary_key(const GDScriptParser::SubscriptNode *p_subscript, Variant &r_key);
 	GDScriptCodeGenerator::Address _parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root = false, bool p_initializer = false);
 	GDScriptCodeGenerator::Address _parse_match_pattern(CodeGen &codegen, Error &r_error, const GDScriptParser::PatternNode *p_pattern, const GDScriptCodeGenerator::Address &p_value_addr, const GDScriptCodeGenerator::Address &p_type_addr, const GDScriptCodeGenerator::Address &p_previous_test, bool p_is_first, bool p_is_nested);
 	List<GDScriptCodeGenerator::Address> _add_block_locals(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block);
 	void _clear_block_locals(CodeGen &codegen, const List<GDScriptCodeGenerator::Address> &p_locals);
 	Error _parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals = true, bool p_clear_locals = true);
+	GDScriptCodeGenerator *_create_generator(GDScript *p_script);
 	GDScriptFunction *_parse_function(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_func, bool p_for_ready = false, bool p_for_lambda = false);
 	GDScriptFunction *_make_static_initializer(Error &r_error, GDScript *p_script, const GDScriptParser::ClassNode *p_class);
 	Error _parse_setter_getter(GDScript *p_script, const GDScriptParser::ClassNode *p_class, const GDScriptParser::VariableNode *p_variable, bool p_is_setter);
 	Error _prepare_compilation(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	Error _compile_class(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
+	GDScriptConstantPool *_get_constant_pool(GDScript *p_script);
+	void _finalize_constant_pool(GDScript *p_script);
+	void _finalize_constant_pools();
 	FunctionLambdaInfo _get_function_replacement_info(GDScriptFunction *p_func, int p_index = -1, int p_depth = 0, GDScriptFunction *p_parent_func = nullptr);
 	Vector<FunctionLambdaInfo> _get_function_lambda_replacement_info(GDScriptFunction *p_func, int p_depth = 0, GDScriptFunction *p_parent_func = nullptr);
 	ScriptLambdaInfo _get_script_lambda_replacement_info(GDScript *p_script);
@@ -172,15 +180,27 @@ class GDScriptCompiler {
 	String error;
 	GDScriptParser::ExpressionNode *awaited_node = nullptr;
 	bool has_static_data = false;
+	HashMap<GDScript *, GDScriptConstantPool *> constant_pools;
+	bool update_cache = true;
+#ifdef TOOLS_ENABLED
+	GDScriptCppModule *cpp_module = nullptr;
+#endif
 
 public:
 	static void convert_to_initializer_type(Variant &p_variant, const GDScriptParser::VariableNode *p_node);
 	static void make_scripts(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
+	// For scripts that aren't the loaded resource, leaves the cache entries of their path alone.
+	void set_update_cache(bool p_update) { update_cache = p_update; }
+#ifdef TOOLS_ENABLED
+	// Also emits C++ for the compiled functions, see `GDScriptCppCodeGenerator`.
+	void set_cpp_module(GDScriptCppModule *p_module) { cpp_module = p_module; }
+#endif
 
 	String get_error() const;
 	int get_error_line() const;
 	int get_error_column() const;
 
 	GDScriptCompiler();
+	~GDScriptCompiler();
 };
@@ -0,0 +1,703 @@
+/**************************************************************************/
+/*  gdscript_const_evaluator.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#include "gdscript_const_evaluator.h"
+
+#include "gdscript_utility_functions.h"
+
+static const GDScriptParser::ClassNode *_get_root_class(const GDScriptParser::ClassNode *p_class) {
+	while (p_class->outer != nullptr) {
+		p_class = p_class->outer;
+	}
+	return p_class;
+}
+
+static bool _is_unsafe_type(Variant::Type p_type) {
+	// Values with identity or side effects that can't be reproduced at compile time.
+	return p_type == Variant::OBJECT || p_type == Variant::CALLABLE || p_type == Variant::SIGNAL || p_type == Variant::RID;
+}
+
+const GDScriptParser::FunctionNode *GDScriptConstEvaluator::find_static_function(const GDScriptParser::ClassNode *p_class, const StringName &p_name, const GDScriptParser::ClassNode **r_owner) {
+	const GDScriptParser::ClassNode *root = _get_root_class(p_class);
+	const GDScriptParser::ClassNode *current = p_class;
+	while (current != nullptr && _get_root_class(current) == root) {
+		if (current->has_member(p_name)) {
+			const GDScriptParser::ClassNode::Member member = current->get_member(p_name);
+			if (member.type != GDScriptParser::ClassNode::Member::FUNCTION || !member.function->is_static || member.function->body == nullptr) {
+				return nullptr;
+			}
+			if (r_owner != nullptr) {
+				*r_owner = current;
+			}
+			return member.function;
+		}
+		if (current->base_type.kind != GDScriptParser::DataType::CLASS || current->base_type.class_type == current) {
+			break;
+		}
+		current = current->base_type.class_type;
+	}
+	return nullptr;
+}
+
+uint32_t GDScriptConstEvaluator::FailedCall::hash(const FailedCall &p_call) {
+	uint32_t h = hash_murmur3_one_64((uint64_t)p_call.function);
+	for (const Variant &argument : p_call.arguments) {
+		h = hash_murmur3_one_32(argument.hash(), h);
+	}
+	return hash_fmix32(h);
+}
+
+bool GDScriptConstEvaluator::FailedCall::compare(const FailedCall &p_a, const FailedCall &p_b) {
+	if (p_a.function != p_b.function || p_a.arguments.size() != p_b.arguments.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.arguments.size(); i++) {
+		// Strict comparison: `1` and `1.0` may evaluate differently.
+		if (!p_a.arguments[i].hash_compare(p_b.arguments[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptConstEvaluator::evaluate_static_call(const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_function, const Vector<Variant> &p_arguments, Variant &r_value, FailedCalls *r_failed_calls) {
+	FailedCall call;
+	if (r_failed_calls != nullptr) {
+		call.function = p_function;
+		call.arguments = p_arguments;
+		if (r_failed_calls->has(call)) {
+			return false;
+		}
+	}
+
+	GDScriptConstEvaluator evaluator;
+	if (evaluator._call_function(p_class, p_function, p_arguments, r_value)) {
+		return true;
+	}
+	if (r_failed_calls != nullptr) {
+		r_failed_calls->insert(call);
+	}
+	return false;
+}
+
+bool GDScriptConstEvaluator::_step() {
+	return ++steps <= MAX_STEPS;
+}
+
+GDScriptConstEvaluator::Local *GDScriptConstEvaluator::_get_local(const StringName &p_name) {
+	for (uint32_t i = locals.size(); i > frame_base; i--) {
+		if (locals[i - 1].name == p_name) {
+			return &locals[i - 1];
+		}
+	}
+	return nullptr;
+}
+
+bool GDScriptConstEvaluator::_get_declared_type(const GDScriptParser::TypeNode *p_type, Variant::Type &r_type) const {
+	if (p_type == nullptr) {
+		r_type = Variant::VARIANT_MAX;
+		return true;
+	}
+	if (p_type->is_union() || !p_type->container_types.is_empty() || p_type->type_chain.size() != 1) {
+		return false;
+	}
+
+	const StringName &name = p_type->type_chain[0]->name;
+	if (name == SNAME("Variant")) {
+		r_type = Variant::VARIANT_MAX;
+		return true;
+	}
+	if (name == SNAME("void")) {
+		r_type = Variant::NIL;
+		return true;
+	}
+	r_type = GDScriptParser::get_builtin_type(name);
+	return r_type < Variant::VARIANT_MAX;
+}
+
+bool GDScriptConstEvaluator::_convert(Variant::Type p_type, Variant &r_value) const {
+	const Variant::Type type = r_value.get_type();
+	if (p_type == Variant::VARIANT_MAX || p_type == type) {
+		return true;
+	}
+
+	// Same implicit conversions as typed assignments.
+	const bool numeric = (p_type == Variant::INT || p_type == Variant::FLOAT) && (type == Variant::INT || type == Variant::FLOAT);
+	const bool textual = (p_type == Variant::STRING || p_type == Variant::STRING_NAME) && (type == Variant::STRING || type == Variant::STRING_NAME);
+	if (!numeric && !textual) {
+		return false;
+	}
+
+	const Variant *args[1] = { &r_value };
+	Variant converted;
+	Callable::CallError ce;
+	Variant::construct(p_type, converted, args, 1, ce);
+	if (ce.error != Callable::CallError::CALL_OK) {
+		return false;
+	}
+	r_value = converted;
+	return true;
+}
+
+bool GDScriptConstEvaluator::_declare(const GDScriptParser::AssignableNode *p_assignable, const Variant &p_value, bool p_has_value) {
+	Local local;
+	local.name = p_assignable->identifier->name;
+	local.value = p_value;
+
+	if (p_assignable->infer_datatype) {
+		if (!p_has_value || p_value.get_type() == Variant::NIL || _is_unsafe_type(p_value.get_type())) {
+			return false;
+		}
+		local.type = p_value.get_type();
+	} else if (!_get_declared_type(p_assignable->datatype_specifier, local.type) || local.type == Variant::NIL) {
+		return false;
+	}
+
+	if (!p_has_value && local.type != Variant::VARIANT_MAX) {
+		Callable::CallError ce;
+		Variant::construct(local.type, local.value, nullptr, 0, ce);
+	} else if (!_convert(local.type, local.value)) {
+		return false;
+	}
+
+	locals.push_back(local);
+	return true;
+}
+
+bool GDScriptConstEvaluator::_call_function(const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_function, const Vector<Variant> &p_arguments, Variant &r_value) {
+	if (depth >= MAX_DEPTH || p_function->is_vararg() || p_function->is_coroutine || p_function->body == nullptr || p_arguments.size() > p_function->parameters.size()) {
+		return false;
+	}
+
+	Variant::Type return_type = Variant::VARIANT_MAX;
+	if (!_get_declared_type(p_function->return_type, return_type)) {
+		return false;
+	}
+
+	const GDScriptParser::ClassNode *previous_class = current_class;
+	const uint32_t previous_frame_base = frame_base;
+	current_class = p_class;
+	frame_base = locals.size();
+	depth++;
+
+	bool valid = true;
+	for (int i = 0; valid && i < p_function->parameters.size(); i++) {
+		const GDScriptParser::ParameterNode *parameter = p_function->parameters[i];
+		Variant value;
+		if (parameter->infer_datatype || i >= p_arguments.size()) {
+			// Inferred parameters take their type from the default value.
+			valid = parameter->initializer != nullptr && _evaluate(parameter->initializer, value);
+		}
+		if (valid && parameter->infer_datatype && i < p_arguments.size()) {
+			const Variant::Type type = value.get_type();
+			value = p_arguments[i];
+			valid = type != Variant::NIL && _convert(type, value);
+		} else if (i < p_arguments.size()) {
+			value = p_arguments[i];
+		}
+		valid = valid && _declare(parameter, value, true);
+	}
+
+	Variant result;
+	if (valid) {
+		const Flow flow = _execute_suite(p_function->body);
+		valid = flow == FLOW_NEXT || flow == FLOW_RETURN;
+		if (flow == FLOW_RETURN) {
+			result = return_value;
+		}
+		valid = valid && (return_type != Variant::NIL || result.get_type() == Variant::NIL) && _convert(return_type, result);
+	}
+
+	locals.resize(frame_base);
+	return_value = Variant();
+	depth--;
+	frame_base = previous_frame_base;
+	current_class = previous_class;
+
+	if (valid) {
+		r_value = result;
+	}
+	return valid;
+}
+
+bool GDScriptConstEvaluator::_evaluate_arguments(const GDScriptParser::CallNode *p_call, Vector<Variant> &r_arguments) {
+	r_arguments.resize(p_call->arguments.size());
+	for (int i = 0; i < p_call->arguments.size(); i++) {
+		if (!_evaluate(p_call->arguments[i], r_arguments.write[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptConstEvaluator::_call(const GDScriptParser::CallNode *p_call, Variant &r_value) {
+	if (p_call->is_super) {
+		return false;
+	}
+
+	Vector<Variant> arguments;
+	if (!_evaluate_arguments(p_call, arguments)) {
+		return false;
+	}
+	const Variant **argptrs = (const Variant **)alloca(sizeof(const Variant *) * arguments.size());
+	for (int i = 0; i < arguments.size(); i++) {
+		argptrs[i] = &arguments[i];
+	}
+	Callable::CallError ce;
+
+	if (p_call->get_callee_type() == GDScriptParser::Node::IDENTIFIER) {
+		// Same resolution order as the compiler.
+		const StringName &function_name = p_call->function_name;
+		const Variant::Type builtin_type = GDScriptParser::get_builtin_type(function_name);
+		if (builtin_type < Variant::VARIANT_MAX) {
+			Variant::construct(builtin_type, r_value, argptrs, arguments.size(), ce);
+			return ce.error == Callable::CallError::CALL_OK;
+		}
+		if (Variant::has_utility_function(function_name)) {
+			if (Variant::get_utility_function_type(function_name) != Variant::UTILITY_FUNC_TYPE_MATH) {
+				return false;
+			}
+			Variant::call_utility_function(function_name, &r_value, argptrs, arguments.size(), ce);
+			return ce.error == Callable::CallError::CALL_OK;
+		}
+		if (GDScriptUtilityFunctions::function_exists(function_name)) {
+			// `range()` isn't constant only because it creates a new array on each call.
+			if (!GDScriptUtilityFunctions::is_function_constant(function_name) && function_name != SNAME("range")) {
+				return false;
+			}
+			GDScriptUtilityFunctions::get_function(function_name)(&r_value, argptrs, arguments.size(), ce);
+			return ce.error == Callable::CallError::CALL_OK;
+		}
+
+		const GDScriptParser::ClassNode *owner = nullptr;
+		const GDScriptParser::FunctionNode *function = find_static_function(current_class, function_name, &owner);
+		return function != nullptr && _call_function(owner, function, arguments, r_value);
+	}
+
+	if (p_call->get_callee_type() != GDScriptParser::Node::SUBSCRIPT) {
+		return false;
+	}
+	const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(p_call->callee);
+	if (!subscript->is_attribute || subscript->attribute == nullptr) {
+		return false;
+	}
+	const StringName &method = subscript->attribute->name;
+
+	Local *local = nullptr;
+	if (subscript->base->type == GDScriptParser::Node::IDENTIFIER) {
+		const StringName &base_name = static_cast<const GDScriptParser::IdentifierNode *>(subscript->base)->name;
+		local = _get_local(base_name);
+		if (local == nullptr) {
+			const Variant::Type builtin_type = GDScriptParser::get_builtin_type(base_name);
+			if (builtin_type < Variant::VARIANT_MAX) {
+				// Static method of a built-in type.
+				Variant::call_static(builtin_type, method, argptrs, arguments.size(), r_value, ce);
+				return ce.error == Callable::CallError::CALL_OK;
+			}
+
+			// Static function of a class from this file.
+			for (const GDScriptParser::ClassNode *current = current_class; current != nullptr; current = current->outer) {
+				const GDScriptParser::ClassNode *base_class = nullptr;
+				if (current->identifier != nullptr && current->identifier->name == base_name) {
+					base_class = current;
+				} else if (current->has_member(base_name)) {
+					const GDScriptParser::ClassNode::Member member = current->get_member(base_name);
+					if (member.type != GDScriptParser::ClassNode::Member::CLASS) {
+						break;
+					}
+					base_class = member.m_class;
+				}
+				if (base_class != nullptr) {
+					const GDScriptParser::ClassNode *owner = nullptr;
+					const GDScriptParser::FunctionNode *function = find_static_function(base_class, method, &owner);
+					return function != nullptr && _call_function(owner, function, arguments, r_value);
+				}
+			}
+		}
+	}
+
+	// Built-in method. Call it on the local itself so mutations stick.
+	Variant base;
+	if (local == nullptr && !_evaluate(subscript->base, base)) {
+		return false;
+	}
+	Variant &target = local != nullptr ? local->value : base;
+	if (_is_unsafe_type(target.get_type()) || target.is_read_only()) {
+		return false;
+	}
+	if (method == SNAME("pick_random") || method == SNAME("shuffle")) {
+		return false;
+	}
+	target.callp(method, argptrs, arguments.size(), r_value, ce);
+	return ce.error == Callable::CallError::CALL_OK;
+}
+
+bool GDScriptConstEvaluator::_assign(const GDScriptParser::AssignmentNode *p_assignment) {
+	Variant value;
+	if (!_evaluate(p_assignment->assigned_value, value)) {
+		return false;
+	}
+
+	if (p_assignment->assignee->type == GDScriptParser::Node::IDENTIFIER) {
+		Local *local = _get_local(static_cast<const GDScriptParser::IdentifierNode *>(p_assignment->assignee)->name);
+		if (local == nullptr) {
+			return false;
+		}
+		if (p_assignment->operation != GDScriptParser::AssignmentNode::OP_NONE) {
+			bool valid = false;
+			Variant result;
+			Variant::evaluate(p_assignment->variant_op, local->value, value, result, valid);
+			if (!valid) {
+				return false;
+			}
+			value = result;
+		}
+		if (!_convert(local->type, value)) {
+			return false;
+		}
+		local->value = value;
+		return true;
+	}
+
+	// Only a single level of subscript on a local, e.g. `table[i] = value` or `point.x += 1`.
+	if (p_assignment->assignee->type != GDScriptParser::Node::SUBSCRIPT) {
+		return false;
+	}
+	const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(p_assignment->assignee);
+	if (subscript->base->type != GDScriptParser::Node::IDENTIFIER || (subscript->is_attribute && subscript->attribute == nullptr)) {
+		return false;
+	}
+
+	Variant index;
+	if (!subscript->is_attribute && !_evaluate(subscript->index, index)) {
+		return false;
+	}
+	Local *local = _get_local(static_cast<const GDScriptParser::IdentifierNode *>(subscript->base)->name);
+	if (local == nullptr || _is_unsafe_type(local->value.get_type()) || local->value.is_read_only()) {
+		return false;
+	}
+
+	bool valid = false;
+	if (p_assignment->operation != GDScriptParser::AssignmentNode::OP_NONE) {
+		const Variant current = subscript->is_attribute ? local->value.get_named(subscript->attribute->name, valid) : local->value.get(index, &valid);
+		if (!valid) {
+			return false;
+		}
+		Variant result;
+		Variant::evaluate(p_assignment->variant_op, current, value, result, valid);
+		if (!valid) {
+			return false;
+		}
+		value = result;
+	}
+
+	if (subscript->is_attribute) {
+		local->value.set_named(subscript->attribute->name, value, valid);
+	} else {
+		local->value.set(index, value, &valid);
+	}
+	return valid;
+}
+
+bool GDScriptConstEvaluator::_evaluate(const GDScriptParser::ExpressionNode *p_expression, Variant &r_value) {
+	if (p_expression == nullptr || !_step()) {
+		return false;
+	}
+
+	switch (p_expression->type) {
+		case GDScriptParser::Node::LITERAL: {
+			r_value = static_cast<const GDScriptParser::LiteralNode *>(p_expression)->value;
+			return true;
+		}
+		case GDScriptParser::Node::IDENTIFIER: {
+			const StringName &name = static_cast<const GDScriptParser::IdentifierNode *>(p_expression)->name;
+			const Local *local = _get_local(name);
+			if (local != nullptr) {
+				r_value = local->value;
+				return true;
+			}
+			// Class constants that are already reduced.
+			for (const GDScriptParser::ClassNode *current = current_class; current != nullptr; current = current->outer) {
+				if (!current->has_member(name)) {
+					continue;
+				}
+				const GDScriptParser::ClassNode::Member member = current->get_member(name);
+				if (member.type != GDScriptParser::ClassNode::Member::CONSTANT || member.constant->initializer == nullptr || !member.constant->initializer->is_constant) {
+					return false;
+				}
+				r_value = member.constant->initializer->reduced_value;
+				return true;
+			}
+			return false;
+		}
+		case GDScriptParser::Node::ARRAY: {
+			const GDScriptParser::ArrayNode *array_node = static_cast<const GDScriptParser::ArrayNode *>(p_expression);
+			Array array;
+			array.resize(array_node->elements.size());
+			for (int i = 0; i < array_node->elements.size(); i++) {
+				Variant element;
+				if (!_evaluate(array_node->elements[i], element)) {
+					return false;
+				}
+				array[i] = element;
+			}
+			r_value = array;
+			return true;
+		}
+		case GDScriptParser::Node::DICTIONARY: {
+			const GDScriptParser::DictionaryNode *dictionary_node = static_cast<const GDScriptParser::DictionaryNode *>(p_expression);
+			Dictionary dictionary;
+			for (const GDScriptParser::DictionaryNode::Pair &element : dictionary_node->elements) {
+				Variant key;
+				Variant value;
+				if (!_evaluate(element.key, key) || !_evaluate(element.value, value)) {
+					return false;
+				}
+				dictionary[key] = value;
+			}
+			r_value = dictionary;
+			return true;
+		}
+		case GDScriptParser::Node::UNARY_OPERATOR: {
+			const GDScriptParser::UnaryOpNode *unary = static_cast<const GDScriptParser::UnaryOpNode *>(p_expression);
+			Variant operand;
+			if (!_evaluate(unary->operand, operand)) {
+				return false;
+			}
+			bool valid = false;
+			Variant::evaluate(unary->variant_op, operand, Variant(), r_value, valid);
+			return valid;
+		}
+		case GDScriptParser::Node::BINARY_OPERATOR: {
+			const GDScriptParser::BinaryOpNode *binary = static_cast<const GDScriptParser::BinaryOpNode *>(p_expression);
+			Variant left;
+			if (!_evaluate(binary->left_operand, left)) {
+				return false;
+			}
+			switch (binary->operation) {
+				case GDScriptParser::BinaryOpNode::OP_LOGIC_AND:
+				case GDScriptParser::BinaryOpNode::OP_LOGIC_OR: {
+					// Short-circuit like the VM does.
+					const bool is_and = binary->operation == GDScriptParser::BinaryOpNode::OP_LOGIC_AND;
+					if (left.booleanize() != is_and) {
+						r_value = !is_and;
+						return true;
+					}
+					Variant right;
+					if (!_evaluate(binary->right_operand, right)) {
+						return false;
+					}
+					r_value = right.booleanize();
+					return true;
+				}
+				default:
+					break;
+			}
+			if (binary->variant_op == Variant::OP_MAX) {
+				return false;
+			}
+			Variant right;
+			if (!_evaluate(binary->right_operand, right)) {
+				return false;
+			}
+			bool valid = false;
+			Variant::evaluate(binary->variant_op, left, right, r_value, valid);
+			return valid;
+		}
+		case GDScriptParser::Node::TERNARY_OPERATOR: {
+			const GDScriptParser::TernaryOpNode *ternary = static_cast<const GDScriptParser::TernaryOpNode *>(p_expression);
+			Variant condition;
+			if (!_evaluate(ternary->condition, condition)) {
+				return false;
+			}
+			return _evaluate(condition.booleanize() ? ternary->true_expr : ternary->false_expr, r_value);
+		}
+		case GDScriptParser::Node::SUBSCRIPT: {
+			const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(p_expression);
+			if (subscript->base == nullptr || (subscript->is_attribute && subscript->attribute == nullptr) || (!subscript->is_attribute && subscript->index == nullptr)) {
+				return false;
+			}
+			bool valid = false;
+			if (subscript->is_attribute && subscript->base->type == GDScriptParser::Node::IDENTIFIER) {
+				const StringName &base_name = static_cast<const GDScriptParser::IdentifierNode *>(subscript->base)->name;
+				const Variant::Type builtin_type = GDScriptParser::get_builtin_type(base_name);
+				if (builtin_type < Variant::VARIANT_MAX && _get_local(base_name) == nullptr) {
+					// Constant of a built-in type, e.g. `Vector2.ZERO`.
+					r_value = Variant::get_constant_value(builtin_type, subscript->attribute->name, &valid);
+					return valid;
+				}
+			}
+
+			Variant base;
+			if (!_evaluate(subscript->base, base) || _is_unsafe_type(base.get_type())) {
+				return false;
+			}
+			if (subscript->is_attribute) {
+				r_value = base.get_named(subscript->attribute->name, valid);
+			} else {
+				Variant index;
+				if (!_evaluate(subscript->index, index)) {
+					return false;
+				}
+				r_value = base.get(index, &valid);
+			}
+			return valid;
+		}
+		case GDScriptParser::Node::CALL:
+			return _call(static_cast<const GDScriptParser::CallNode *>(p_expression), r_value);
+		default:
+			// Anything touching objects, members or the scene tree.
+			return false;
+	}
+}
+
+GDScriptConstEvaluator::Flow GDScriptConstEvaluator::_execute_suite(const GDScriptParser::SuiteNode *p_suite) {
+	const uint32_t scope = locals.size();
+	Flow flow = FLOW_NEXT;
+	for (int i = 0; flow == FLOW_NEXT && i < p_suite->statements.size(); i++) {
+		flow = _execute(p_suite->statements[i]);
+	}
+	locals.resize(scope);
+	return flow;
+}
+
+GDScriptConstEvaluator::Flow GDScriptConstEvaluator::_execute(const GDScriptParser::Node *p_statement) {
+	if (!_step()) {
+		return FLOW_ABORT;
+	}
+
+	switch (p_statement->type) {
+		case GDScriptParser::Node::VARIABLE:
+		case GDScriptParser::Node::CONSTANT: {
+			const GDScriptParser::AssignableNode *assignable = static_cast<const GDScriptParser::AssignableNode *>(p_statement);
+			Variant value;
+			if (assignable->initializer != nullptr && !_evaluate(assignable->initializer, value)) {
+				return FLOW_ABORT;
+			}
+			return _declare(assignable, value, assignable->initializer != nullptr) ? FLOW_NEXT : FLOW_ABORT;
+		}
+		case GDScriptParser::Node::ASSIGNMENT:
+			return _assign(static_cast<const GDScriptParser::AssignmentNode *>(p_statement)) ? FLOW_NEXT : FLOW_ABORT;
+		case GDScriptParser::Node::IF: {
+			const GDScriptParser::IfNode *if_node = static_cast<const GDScriptParser::IfNode *>(p_statement);
+			Variant condition;
+			if (!_evaluate(if_node->condition, condition)) {
+				return FLOW_ABORT;
+			}
+			if (condition.booleanize()) {
+				return _execute_suite(if_node->true_block);
+			}
+			return if_node->false_block != nullptr ? _execute_suite(if_node->false_block) : FLOW_NEXT;
+		}
+		case GDScriptParser::Node::WHILE: {
+			const GDScriptParser::WhileNode *while_node = static_cast<const GDScriptParser::WhileNode *>(p_statement);
+			while (true) {
+				Variant condition;
+				if (!_evaluate(while_node->condition, condition)) {
+					return FLOW_ABORT;
+				}
+				if (!condition.booleanize()) {
+					return FLOW_NEXT;
+				}
+				const Flow flow = _execute_suite(while_node->loop);
+				if (flow == FLOW_BREAK) {
+					return FLOW_NEXT;
+				} else if (flow == FLOW_RETURN || flow == FLOW_ABORT) {
+					return flow;
+				}
+			}
+		}
+		case GDScriptParser::Node::FOR: {
+			const GDScriptParser::ForNode *for_node = static_cast<const GDScriptParser::ForNode *>(p_statement);
+			Variant::Type variable_type = Variant::VARIANT_MAX;
+			Variant container;
+			if (!_get_declared_type(for_node->datatype_specifier, variable_type) || !_evaluate(for_node->list, container) || _is_unsafe_type(container.get_type())) {
+				return FLOW_ABORT;
+			}
+
+			// Generic iteration, which is what the VM falls back to as well.
+			bool valid = false;
+			Variant iterator;
+			bool has_next = container.iter_init(iterator, valid);
+			while (valid && has_next) {
+				Local local;
+				local.name = for_node->variable->name;
+				local.type = variable_type;
+				local.value = container.iter_get(iterator, valid);
+				if (!valid || !_convert(variable_type, local.value) || !_step()) {
+					return FLOW_ABORT;
+				}
+				locals.push_back(local);
+				const Flow flow = _execute_suite(for_node->loop);
+				locals.resize(locals.size() - 1);
+				if (flow == FLOW_BREAK) {
+					return FLOW_NEXT;
+				} else if (flow == FLOW_RETURN || flow == FLOW_ABORT) {
+					return flow;
+				}
+				has_next = container.iter_next(iterator, valid);
+			}
+			return valid ? FLOW_NEXT : FLOW_ABORT;
+		}
+		case GDScriptParser::Node::RETURN: {
+			const GDScriptParser::ReturnNode *return_node = static_cast<const GDScriptParser::ReturnNode *>(p_statement);
+			return_value = Variant();
+			if (return_node->return_value != nullptr && !_evaluate(return_node->return_value, return_value)) {
+				return FLOW_ABORT;
+			}
+			return FLOW_RETURN;
+		}
+		case GDScriptParser::Node::ASSERT: {
+			// A failing assertion is left for runtime to report.
+			Variant condition;
+			if (!_evaluate(static_cast<const GDScriptParser::AssertNode *>(p_statement)->condition, condition) || !condition.booleanize()) {
+				return FLOW_ABORT;
+			}
+			return FLOW_NEXT;
+		}
+		case GDScriptParser::Node::BREAK:
+			return FLOW_BREAK;
+		case GDScriptParser::Node::CONTINUE:
+			return FLOW_CONTINUE;
+		case GDScriptParser::Node::PASS:
+			return FLOW_NEXT;
+		default:
+			break;
+	}
+
+	if (p_statement->is_expression()) {
+		// Expression statement, e.g. `table.append(value)`.
+		Variant discarded;
+		return _evaluate(static_cast<const GDScriptParser::ExpressionNode *>(p_statement), discarded) ? FLOW_NEXT : FLOW_ABORT;
+	}
+	// `match`, `await`, `breakpoint` and anything else.
+	return FLOW_ABORT;
+}
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  gdscript_const_evaluator.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#pragma once
+
+#include "gdscript_parser.h"
+
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+// Runs side-effect-free static GDScript functions on the parse tree so the analyzer can fold calls
+// to them into constants. Only a sandboxed subset of the language is supported: locals, control
+// flow, operators, built-in types and their methods, math utilities and other such static functions.
+// Anything else (objects, members, signals, I/O, randomness, `await`) makes the evaluation give up
+// so the call is kept for runtime.
+class GDScriptConstEvaluator {
+	static constexpr uint32_t MAX_STEPS = 100000;
+	static constexpr uint32_t MAX_DEPTH = 32;
+
+	enum Flow {
+		FLOW_NEXT,
+		FLOW_BREAK,
+		FLOW_CONTINUE,
+		FLOW_RETURN,
+		FLOW_ABORT,
+	};
+
+	struct Local {
+		StringName name;
+		Variant value;
+		Variant::Type type = Variant::VARIANT_MAX; // Untyped.
+	};
+
+	const GDScriptParser::ClassNode *current_class = nullptr;
+	LocalVector<Local> locals;
+	uint32_t frame_base = 0;
+	uint32_t steps = 0;
+	uint32_t depth = 0;
+	Variant return_value;
+
+	bool _step();
+	Local *_get_local(const StringName &p_name);
+	bool _get_declared_type(const GDScriptParser::TypeNode *p_type, Variant::Type &r_type) const;
+	bool _convert(Variant::Type p_type, Variant &r_value) const;
+	bool _declare(const GDScriptParser::AssignableNode *p_assignable, const Variant &p_value, bool p_has_value);
+
+	bool _call_function(const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_function, const Vector<Variant> &p_arguments, Variant &r_value);
+	bool _call(const GDScriptParser::CallNode *p_call, Variant &r_value);
+	bool _evaluate_arguments(const GDScriptParser::CallNode *p_call, Vector<Variant> &r_arguments);
+	bool _evaluate(const GDScriptParser::ExpressionNode *p_expression, Variant &r_value);
+	bool _assign(const GDScriptParser::AssignmentNode *p_assignment);
+
+	Flow _execute_suite(const GDScriptParser::SuiteNode *p_suite);
+	Flow _execute(const GDScriptParser::Node *p_statement);
+
+public:
+	// A call that could not be evaluated. Callers keep these so the same function and arguments
+	// aren't run again, possibly for `MAX_STEPS`, at every call site.
+	struct FailedCall {
+		const GDScriptParser::FunctionNode *function = nullptr;
+		Vector<Variant> arguments;
+
+		static uint32_t hash(const FailedCall &p_call);
+		static bool compare(const FailedCall &p_a, const FailedCall &p_b);
+	};
+	typedef HashSet<FailedCall, FailedCall, FailedCall> FailedCalls;
+
+	static const GDScriptParser::FunctionNode *find_static_function(const GDScriptParser::ClassNode *p_class, const StringName &p_name, const GDScriptParser::ClassNode **r_owner = nullptr);
+
+	// Returns `false` without touching `r_value` when the call can't be evaluated at compile time.
+	// Failures are recorded in `r_failed_calls`, if given, and not attempted again.
+	static bool evaluate_static_call(const GDScriptParser::ClassNode *p_class, const GDScriptParser::FunctionNode *p_function, const Vector<Variant> &p_arguments, Variant &r_value, FailedCalls *r_failed_calls = nullptr);
+};
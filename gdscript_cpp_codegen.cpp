@@ -0,0 +1,916 @@
+/**************************************************************************/
+/*  gdscript_cpp_codegen.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_cpp_codegen.h"
+
+#ifdef TOOLS_ENABLED
+
+#include "gdscript_native.h"
+
+void GDScriptCppModule::add_function(const String &p_key, const String &p_comment, const String &p_body) {
+	// Functions with the same key have the same bytecode, so the same translation.
+	if (keys.has(p_key)) {
+		return;
+	}
+	const String symbol = vformat("_gdscript_native_%d", keys.size());
+	keys.insert(p_key);
+
+	definitions += vformat("// %s\nstatic int %s(GDScriptJIT::Frame *p_frame, int p_ip) {\n%s}\n\n", p_comment, symbol, p_body);
+	registrations += vformat("\tGDScriptNativeFunctions::register_function(\"%s\", &%s);\n", p_key.c_escape(), symbol);
+}
+
+void GDScriptCppModule::set_function_typed(const GDScriptFunction *p_function, bool p_typed) {
+	// Also erased otherwise, a new function may reuse the address of a freed one.
+	if (p_typed) {
+		typed_functions.insert(p_function);
+	} else {
+		typed_functions.erase(p_function);
+	}
+}
+
+void GDScriptCppModule::translate_function(const GDScriptFunction *p_function) {
+	if (!typed_functions.erase(p_function)) {
+		return;
+	}
+	String body;
+	if (GDScriptCppCodeGenerator::_translate(p_function, body)) {
+		add_function(GDScriptNativeFunctions::get_key(p_function), vformat("%s::%s", p_function->get_source(), p_function->get_name()), body);
+	}
+}
+
+String GDScriptCppModule::get_source() const {
+	String source = "/* THIS FILE IS GENERATED DO NOT EDIT */\n\n";
+	source += "#include \"../gdscript_native.h\"\n\n";
+	source += "#include \"core/object/method_bind.h\"\n";
+	source += "#include \"core/variant/variant_internal.h\"\n\n";
+	source += definitions;
+	source += "void gdscript_register_native_functions() {\n" + registrations + "}\n";
+	return source;
+}
+
+void GDScriptCppModule::clear() {
+	keys.clear();
+	typed_functions.clear();
+	definitions = String();
+	registrations = String();
+}
+
+void GDScriptCppCodeGenerator::_check_typed(const Address &p_address) {
+	switch (p_address.mode) {
+		case Address::SELF:
+		case Address::CLASS:
+		case Address::NIL:
+			break;
+		default:
+			if (!p_address.type.has_type()) {
+				fully_typed = false;
+			}
+			break;
+	}
+}
+
+// The C++ type of each `OPCODE_TYPE_ADJUST_*`, indexed by `opcode - OPCODE_TYPE_ADJUST_BOOL`.
+static const char *type_adjust_types[] = {
+	"bool",
+	"int64_t",
+	"double",
+	"String",
+	"Vector2",
+	"Vector2i",
+	"Rect2",
+	"Rect2i",
+	"Vector3",
+	"Vector3i",
+	"Transform2D",
+	"Vector4",
+	"Vector4i",
+	"Plane",
+	"Quaternion",
+	"AABB",
+	"Basis",
+	"Transform3D",
+	"Projection",
+	"Color",
+	"StringName",
+	"NodePath",
+	"RID",
+	"Object *",
+	"Callable",
+	"Signal",
+	"Dictionary",
+	"Array",
+	"PackedByteArray",
+	"PackedInt32Array",
+	"PackedInt64Array",
+	"PackedFloat32Array",
+	"PackedFloat64Array",
+	"PackedStringArray",
+	"PackedVector2Array",
+	"PackedVector3Array",
+	"PackedColorArray",
+	"PackedVector4Array",
+};
+static_assert(sizeof(type_adjust_types) / sizeof(type_adjust_types[0]) == GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL + 1);
+
+// Translates each instruction to the C++ equivalent of its interpreter handler. Where the
+// interpreter would report an error, the code returns the position of the instruction, so the
+// interpreter runs it again and reports it.
+bool GDScriptCppCodeGenerator::_translate(const GDScriptFunction *p_function, String &r_body) {
+	typedef GDScriptFunction F;
+
+	const int *code = p_function->_code_ptr;
+	const int code_size = p_function->_code_size;
+	if (!code || code_size == 0 || code[code_size - 1] != F::OPCODE_END) {
+		return false;
+	}
+	const int end_ip = code_size - 1;
+
+	// The translation of each instruction, by position.
+	HashMap<int, String> instructions;
+	HashSet<int> jump_targets;
+	bool uses_stack = false;
+	bool uses_constants = false;
+	bool uses_members = false;
+	HashSet<String> tables;
+
+	int ip = 0;
+	while (ip < code_size) {
+		const int *instr = &code[ip];
+		String out;
+		int size = 0;
+
+		// The operand `p_index`, checked as the interpreter does in debug builds.
+		bool valid = true;
+		auto address = [&](int p_index) -> String {
+			const int addr = instr[1 + p_index];
+			const int index = addr & F::ADDR_MASK;
+			switch ((addr & F::ADDR_TYPE_MASK) >> F::ADDR_BITS) {
+				case F::ADDR_TYPE_STACK:
+					if (index < p_function->_stack_size) {
+						uses_stack = true;
+						return vformat("&stack[%d]", index);
+					}
+					break;
+				case F::ADDR_TYPE_CONSTANT:
+					if (index < p_function->_constant_count) {
+						uses_constants = true;
+						return vformat("&constants[%d]", index);
+					}
+					break;
+				case F::ADDR_TYPE_MEMBER:
+					// Checked against the instance when running.
+					uses_members = true;
+					return vformat("&members[%d]", index);
+			}
+			valid = false;
+			return String();
+		};
+		auto table = [&](const char *p_name, int p_index, int p_count) -> String {
+			if (p_index < 0 || p_index >= p_count) {
+				valid = false;
+				return String();
+			}
+			tables.insert(p_name);
+			return vformat("%s[%d]", p_name, p_index);
+		};
+		auto jump = [&](int p_target) -> String {
+			if (p_target < 0 || p_target >= code_size) {
+				valid = false;
+				return String();
+			}
+			jump_targets.insert(p_target);
+			return vformat("goto ip_%d;", p_target);
+		};
+		const String leave = vformat("return %d;", ip);
+
+		switch (instr[0]) {
+			case F::OPCODE_OPERATOR: {
+				if (instr[4] < 0 || instr[4] >= Variant::OP_MAX) {
+					break;
+				}
+				// The generic path, the inline cache is the interpreter's.
+				out += "\t{\n";
+				out += "\t\tbool valid;\n";
+				out += "\t\tVariant ret;\n";
+				out += vformat("\t\tVariant::evaluate(Variant::Operator(%d), *%s, *%s, ret, valid);\n", instr[4], address(0), address(1));
+				out += vformat("\t\tif (!valid) {\n\t\t\t%s\n\t\t}\n", leave);
+				out += vformat("\t\t*%s = ret;\n", address(2));
+				out += "\t}\n";
+				size = 7;
+			} break;
+			case F::OPCODE_OPERATOR_VALIDATED: {
+				out += vformat("\t%s(%s, %s, %s);\n", table("operator_funcs", instr[4], p_function->_operator_funcs_count), address(0), address(1), address(2));
+				size = 5;
+			} break;
+			case F::OPCODE_SET_KEYED_VALIDATED: {
+				out += "\t{\n";
+				out += "\t\tbool valid;\n";
+				out += vformat("\t\t%s(%s, %s, %s, &valid);\n", table("keyed_setters", instr[4], p_function->_keyed_setters_count), address(0), address(1), address(2));
+				out += vformat("#ifdef DEBUG_ENABLED\n\t\tif (!valid) {\n\t\t\t%s\n\t\t}\n#endif\n", leave);
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_GET_KEYED_VALIDATED: {
+				const String getter = table("keyed_getters", instr[4], p_function->_keyed_getters_count);
+				out += "\t{\n";
+				out += "\t\tbool valid;\n";
+				out += "#ifdef DEBUG_ENABLED\n";
+				out += "\t\tVariant ret;\n";
+				out += vformat("\t\t%s(%s, %s, &ret, &valid);\n", getter, address(0), address(1));
+				out += vformat("\t\tif (!valid) {\n\t\t\t%s\n\t\t}\n", leave);
+				out += vformat("\t\t*%s = ret;\n", address(2));
+				out += "#else\n";
+				out += vformat("\t\t%s(%s, %s, %s, &valid);\n", getter, address(0), address(1), address(2));
+				out += "#endif\n";
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_SET_INDEXED_VALIDATED: {
+				out += "\t{\n";
+				out += "\t\tbool oob;\n";
+				out += vformat("\t\t%s(%s, *VariantInternal::get_int(%s), %s, &oob);\n", table("indexed_setters", instr[4], p_function->_indexed_setters_count), address(0), address(1), address(2));
+				out += vformat("#ifdef DEBUG_ENABLED\n\t\tif (oob) {\n\t\t\t%s\n\t\t}\n#endif\n", leave);
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_GET_INDEXED_VALIDATED: {
+				out += "\t{\n";
+				out += "\t\tbool oob;\n";
+				out += vformat("\t\t%s(%s, *VariantInternal::get_int(%s), %s, &oob);\n", table("indexed_getters", instr[4], p_function->_indexed_getters_count), address(0), address(1), address(2));
+				out += vformat("#ifdef DEBUG_ENABLED\n\t\tif (oob) {\n\t\t\t%s\n\t\t}\n#endif\n", leave);
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_GET_NAMED_VALIDATED: {
+				out += vformat("\t%s(%s, %s);\n", table("getters", instr[3], p_function->_getters_count), address(0), address(1));
+				size = 4;
+			} break;
+			case F::OPCODE_SET_NAMED_VALIDATED: {
+				out += vformat("\t%s(%s, %s);\n", table("setters", instr[3], p_function->_setters_count), address(0), address(1));
+				size = 4;
+			} break;
+			case F::OPCODE_ASSIGN: {
+				out += vformat("\t*%s = *%s;\n", address(0), address(1));
+				size = 3;
+			} break;
+			case F::OPCODE_ASSIGN_NULL: {
+				out += vformat("\t*%s = Variant();\n", address(0));
+				size = 2;
+			} break;
+			case F::OPCODE_ASSIGN_TRUE: {
+				out += vformat("\t*%s = true;\n", address(0));
+				size = 2;
+			} break;
+			case F::OPCODE_ASSIGN_FALSE: {
+				out += vformat("\t*%s = false;\n", address(0));
+				size = 2;
+			} break;
+			case F::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				if (instr[3] < 0 || instr[3] >= Variant::VARIANT_MAX) {
+					break;
+				}
+				const String type = vformat("Variant::Type(%d)", instr[3]);
+				out += "\t{\n";
+				out += vformat("\t\tconst Variant *src = %s;\n", address(1));
+				out += vformat("\t\tif (src->get_type() == %s) {\n", type);
+				out += vformat("\t\t\t*%s = *src;\n", address(0));
+				out += "\t\t} else {\n";
+				out += vformat("#ifdef DEBUG_ENABLED\n\t\t\tif (!Variant::can_convert_strict(src->get_type(), %s)) {\n\t\t\t\t%s\n\t\t\t}\n#endif\n", type, leave);
+				out += "\t\t\tCallable::CallError ce;\n";
+				out += vformat("\t\t\tVariant::construct(%s, *%s, &src, 1, ce);\n", type, address(0));
+				out += "\t\t}\n";
+				out += "\t}\n";
+				size = 4;
+			} break;
+			case F::OPCODE_CONSTRUCT_VALIDATED:
+			case F::OPCODE_CALL_UTILITY_VALIDATED:
+			case F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED:
+			case F::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN:
+			case F::OPCODE_CALL_METHOD_BIND_VALIDATED_NO_RETURN: {
+				// Operands are `[opcode, count, addresses..., argc, function]`, the arguments first.
+				const int count = instr[1];
+				if (count < 1 || count > p_function->_instruction_args_size || 3 + count >= code_size - ip) {
+					break;
+				}
+				const int argc = instr[2 + count];
+				const int index = instr[3 + count];
+				const bool has_base = instr[0] != F::OPCODE_CONSTRUCT_VALIDATED && instr[0] != F::OPCODE_CALL_UTILITY_VALIDATED;
+				if (argc < 0 || argc + (has_base ? 2 : 1) > count) {
+					break;
+				}
+				// The addresses are operands `1..count`.
+				String args;
+				for (int i = 0; i < argc; i++) {
+					args += (i > 0 ? ", " : "") + address(1 + i);
+				}
+
+				out += "\t{\n";
+				if (argc > 0) {
+					out += vformat("\t\tconst Variant *args[] = { %s };\n", args);
+				} else {
+					out += "\t\tconst Variant **args = nullptr;\n";
+				}
+				switch (instr[0]) {
+					case F::OPCODE_CONSTRUCT_VALIDATED: {
+						out += vformat("\t\t%s(%s, args);\n", table("constructors", index, p_function->_constructors_count), address(1 + argc));
+					} break;
+					case F::OPCODE_CALL_UTILITY_VALIDATED: {
+						out += vformat("\t\t%s(%s, args, %d);\n", table("utilities", index, p_function->_utilities_count), address(1 + argc), argc);
+					} break;
+					case F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+						// The base is before the destination.
+						out += vformat("\t\t%s(%s, args, %d, %s);\n", table("builtin_methods", index, p_function->_builtin_methods_count), address(1 + argc), argc, address(2 + argc));
+					} break;
+					default: {
+						const String method = table("methods", index, p_function->_methods_count);
+						out += "#ifdef DEBUG_ENABLED\n";
+						out += "\t\tbool freed = false;\n";
+						out += vformat("\t\tObject *base = %s->get_validated_object_with_check(freed);\n", address(1 + argc));
+						out += vformat("\t\tif (!base) {\n\t\t\t%s\n\t\t}\n", leave);
+						out += "#else\n";
+						out += vformat("\t\tObject *base = *VariantInternal::get_object(%s);\n", address(1 + argc));
+						out += "#endif\n";
+						if (instr[0] == F::OPCODE_CALL_METHOD_BIND_VALIDATED_RETURN) {
+							out += vformat("\t\t%s->validated_call(base, args, %s);\n", method, address(2 + argc));
+						} else {
+							out += vformat("\t\tVariantInternal::initialize(%s, Variant::NIL);\n", address(2 + argc));
+							out += vformat("\t\t%s->validated_call(base, args, nullptr);\n", method);
+						}
+					} break;
+				}
+				out += "\t}\n";
+				size = 4 + count;
+			} break;
+			case F::OPCODE_JUMP: {
+				out += vformat("\t%s\n", jump(instr[1]));
+				size = 2;
+			} break;
+			case F::OPCODE_JUMP_IF:
+			case F::OPCODE_JUMP_IF_NOT: {
+				out += vformat("\tif (%s%s->booleanize()) {\n\t\t%s\n\t}\n", instr[0] == F::OPCODE_JUMP_IF ? "" : "!", address(0), jump(instr[2]));
+				size = 3;
+			} break;
+			case F::OPCODE_RETURN: {
+				out += vformat("\t*p_frame->retvalue = *%s;\n", address(0));
+				out += vformat("\treturn %d;\n", end_ip);
+				size = 2;
+			} break;
+			case F::OPCODE_RETURN_TYPED_BUILTIN: {
+				if (instr[2] < 0 || instr[2] >= Variant::VARIANT_MAX) {
+					break;
+				}
+				const String type = vformat("Variant::Type(%d)", instr[2]);
+				out += "\t{\n";
+				out += vformat("\t\tconst Variant *ret = %s;\n", address(0));
+				out += vformat("\t\tif (ret->get_type() == %s) {\n", type);
+				out += "\t\t\t*p_frame->retvalue = *ret;\n";
+				out += vformat("\t\t} else if (Variant::can_convert_strict(ret->get_type(), %s)) {\n", type);
+				out += "\t\t\tCallable::CallError ce;\n";
+				out += vformat("\t\t\tVariant::construct(%s, *p_frame->retvalue, &ret, 1, ce);\n", type);
+				out += "\t\t} else {\n";
+				out += vformat("\t\t\t%s\n", leave);
+				out += "\t\t}\n";
+				out += "\t}\n";
+				out += vformat("\treturn %d;\n", end_ip);
+				size = 3;
+			} break;
+			case F::OPCODE_ITERATE_BEGIN_INT: {
+				const String counter = address(0);
+				const String iterator = address(2);
+				out += "\t{\n";
+				out += vformat("\t\tconst int64_t size = *VariantInternal::get_int(%s);\n", address(1));
+				out += vformat("\t\tVariantInternal::initialize(%s, Variant::INT);\n", counter);
+				out += vformat("\t\t*VariantInternal::get_int(%s) = 0;\n", counter);
+				out += vformat("\t\tif (size <= 0) {\n\t\t\t%s\n\t\t}\n", jump(instr[4]));
+				out += vformat("\t\tVariantInternal::initialize(%s, Variant::INT);\n", iterator);
+				out += vformat("\t\t*VariantInternal::get_int(%s) = 0;\n", iterator);
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_ITERATE_INT: {
+				out += "\t{\n";
+				out += vformat("\t\tint64_t *count = VariantInternal::get_int(%s);\n", address(0));
+				out += "\t\t(*count)++;\n";
+				out += vformat("\t\tif (*count >= *VariantInternal::get_int(%s)) {\n\t\t\t%s\n\t\t}\n", address(1), jump(instr[4]));
+				out += vformat("\t\t*VariantInternal::get_int(%s) = *count;\n", address(2));
+				out += "\t}\n";
+				size = 5;
+			} break;
+			case F::OPCODE_ITERATE_BEGIN_RANGE: {
+				const String counter = address(0);
+				const String iterator = address(4);
+				out += "\t{\n";
+				out += vformat("\t\tconst int64_t from = *VariantInternal::get_int(%s);\n", address(1));
+				out += vformat("\t\tconst int64_t to = *VariantInternal::get_int(%s);\n", address(2));
+				out += vformat("\t\tconst int64_t step = *VariantInternal::get_int(%s);\n", address(3));
+				out += vformat("\t\tVariantInternal::initialize(%s, Variant::INT);\n", counter);
+				out += vformat("\t\t*VariantInternal::get_int(%s) = from;\n", counter);
+				out += vformat("\t\tif (from == to ? true : (from < to ? step <= 0 : step >= 0)) {\n\t\t\t%s\n\t\t}\n", jump(instr[6]));
+				out += vformat("\t\tVariantInternal::initialize(%s, Variant::INT);\n", iterator);
+				out += vformat("\t\t*VariantInternal::get_int(%s) = from;\n", iterator);
+				out += "\t}\n";
+				size = 7;
+			} break;
+			case F::OPCODE_ITERATE_RANGE: {
+				out += "\t{\n";
+				out += vformat("\t\tconst int64_t to = *VariantInternal::get_int(%s);\n", address(1));
+				out += vformat("\t\tconst int64_t step = *VariantInternal::get_int(%s);\n", address(2));
+				out += vformat("\t\tint64_t *count = VariantInternal::get_int(%s);\n", address(0));
+				out += "\t\t*count += step;\n";
+				out += vformat("\t\tif ((step < 0 && *count <= to) || (step > 0 && *count >= to)) {\n\t\t\t%s\n\t\t}\n", jump(instr[5]));
+				out += vformat("\t\t*VariantInternal::get_int(%s) = *count;\n", address(3));
+				out += "\t}\n";
+				size = 6;
+			} break;
+			case F::OPCODE_LINE: {
+				out += vformat("\t*p_frame->line = %d;\n", instr[1]);
+				size = 2;
+			} break;
+			case F::OPCODE_END: {
+				out += vformat("\t%s\n", leave);
+				size = 1;
+			} break;
+			default: {
+				if (instr[0] >= F::OPCODE_TYPE_ADJUST_BOOL && instr[0] <= F::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+					out += vformat("\tVariantTypeAdjust<%s>::adjust(%s);\n", type_adjust_types[instr[0] - F::OPCODE_TYPE_ADJUST_BOOL], address(0));
+					size = 2;
+				}
+			} break;
+		}
+
+		if (size == 0 || !valid) {
+			// No translation, the function stays bytecode only.
+			return false;
+		}
+		instructions.insert(ip, out);
+		ip += size;
+	}
+
+	// Only the start of the function is an entry point, the interpreter runs anything else.
+	r_body = "\tif (p_ip != 0) {\n\t\treturn p_ip;\n\t}\n";
+	if (uses_stack) {
+		r_body += "\tVariant *stack = p_frame->stack;\n";
+	}
+	if (uses_constants) {
+		r_body += "\tVariant *constants = p_frame->constants;\n";
+	}
+	if (uses_members) {
+		// Member addresses are relative to the instance.
+		r_body += "\tVariant *members = p_frame->members;\n";
+		r_body += "\tif (!members) {\n\t\treturn p_ip;\n\t}\n";
+	}
+	static const char *table_types[][2] = {
+		{ "operator_funcs", "const Variant::ValidatedOperatorEvaluator *" },
+		{ "setters", "const Variant::ValidatedSetter *" },
+		{ "getters", "const Variant::ValidatedGetter *" },
+		{ "keyed_setters", "const Variant::ValidatedKeyedSetter *" },
+		{ "keyed_getters", "const Variant::ValidatedKeyedGetter *" },
+		{ "indexed_setters", "const Variant::ValidatedIndexedSetter *" },
+		{ "indexed_getters", "const Variant::ValidatedIndexedGetter *" },
+		{ "builtin_methods", "const Variant::ValidatedBuiltInMethod *" },
+		{ "constructors", "const Variant::ValidatedConstructor *" },
+		{ "utilities", "const Variant::ValidatedUtilityFunction *" },
+		{ "methods", "MethodBind *const *" },
+	};
+	for (const auto &table_type : table_types) {
+		if (tables.has(table_type[0])) {
+			r_body += vformat("\t%s%s = GDScriptNativeFunctions::get_%s(p_frame->function);\n", table_type[1], table_type[0], table_type[0]);
+		}
+	}
+	r_body += "\n";
+
+	for (ip = 0; ip < code_size; ip++) {
+		const String *out = instructions.getptr(ip);
+		if (!out) {
+			continue;
+		}
+		if (jump_targets.has(ip)) {
+			r_body += vformat("ip_%d:\n", ip);
+		}
+		r_body += *out;
+	}
+	return true;
+}
+
+void GDScriptCppCodeGenerator::write_start(GDScript *p_script, const StringName &p_function_name, bool p_static, Variant p_rpc_config, const GDScriptDataType &p_return_type) {
+	fully_typed = true;
+	bytecode.write_start(p_script, p_function_name, p_static, p_rpc_config, p_return_type);
+}
+
+GDScriptFunction *GDScriptCppCodeGenerator::write_end() {
+	GDScriptFunction *function = bytecode.write_end();
+	// The constants aren't known yet, the compiler translates the function with its pool.
+	module->set_function_typed(function, fully_typed);
+	return function;
+}
+
+#ifdef DEBUG_ENABLED
+void GDScriptCppCodeGenerator::set_signature(const String &p_signature) {
+	bytecode.set_signature(p_signature);
+}
+#endif
+
+uint32_t GDScriptCppCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) {
+	return bytecode.add_parameter(p_name, p_is_optional, p_type);
+}
+
+uint32_t GDScriptCppCodeGenerator::add_local(const StringName &p_name, const GDScriptDataType &p_type) {
+	return bytecode.add_local(p_name, p_type);
+}
+
+uint32_t GDScriptCppCodeGenerator::add_local_constant(const StringName &p_name, const Variant &p_constant) {
+	return bytecode.add_local_constant(p_name, p_constant);
+}
+
+uint32_t GDScriptCppCodeGenerator::add_or_get_constant(const Variant &p_constant) {
+	return bytecode.add_or_get_constant(p_constant);
+}
+
+uint32_t GDScriptCppCodeGenerator::add_or_get_name(const StringName &p_name) {
+	return bytecode.add_or_get_name(p_name);
+}
+
+uint32_t GDScriptCppCodeGenerator::add_temporary(const GDScriptDataType &p_type) {
+	return bytecode.add_temporary(p_type);
+}
+
+void GDScriptCppCodeGenerator::pop_temporary() {
+	bytecode.pop_temporary();
+}
+
+void GDScriptCppCodeGenerator::clear_temporaries() {
+	bytecode.clear_temporaries();
+}
+
+void GDScriptCppCodeGenerator::clear_address(const Address &p_address) {
+	bytecode.clear_address(p_address);
+}
+
+bool GDScriptCppCodeGenerator::is_local_dirty(const Address &p_address) const {
+	return bytecode.is_local_dirty(p_address);
+}
+
+void GDScriptCppCodeGenerator::start_parameters() {
+	bytecode.start_parameters();
+}
+
+void GDScriptCppCodeGenerator::end_parameters() {
+	bytecode.end_parameters();
+}
+
+void GDScriptCppCodeGenerator::start_block() {
+	bytecode.start_block();
+}
+
+void GDScriptCppCodeGenerator::end_block() {
+	bytecode.end_block();
+}
+
+void GDScriptCppCodeGenerator::set_initial_line(int p_line) {
+	bytecode.set_initial_line(p_line);
+}
+
+void GDScriptCppCodeGenerator::write_type_adjust(const Address &p_target, Variant::Type p_new_type) {
+	bytecode.write_type_adjust(p_target, p_new_type);
+}
+
+void GDScriptCppCodeGenerator::write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) {
+	_check_typed(p_left_operand);
+	bytecode.write_unary_operator(p_target, p_operator, p_left_operand);
+}
+
+void GDScriptCppCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
+	_check_typed(p_left_operand);
+	_check_typed(p_right_operand);
+	bytecode.write_binary_operator(p_target, p_operator, p_left_operand, p_right_operand);
+}
+
+void GDScriptCppCodeGenerator::write_type_test(const Address &p_target, const Address &p_source, const GDScriptDataType &p_type) {
+	bytecode.write_type_test(p_target, p_source, p_type);
+}
+
+void GDScriptCppCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
+	bytecode.write_and_left_operand(p_left_operand);
+}
+
+void GDScriptCppCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
+	bytecode.write_and_right_operand(p_right_operand);
+}
+
+void GDScriptCppCodeGenerator::write_end_and(const Address &p_target) {
+	bytecode.write_end_and(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_or_left_operand(const Address &p_left_operand) {
+	bytecode.write_or_left_operand(p_left_operand);
+}
+
+void GDScriptCppCodeGenerator::write_or_right_operand(const Address &p_right_operand) {
+	bytecode.write_or_right_operand(p_right_operand);
+}
+
+void GDScriptCppCodeGenerator::write_end_or(const Address &p_target) {
+	bytecode.write_end_or(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_start_ternary(const Address &p_target) {
+	bytecode.write_start_ternary(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_ternary_condition(const Address &p_condition) {
+	_check_typed(p_condition);
+	bytecode.write_ternary_condition(p_condition);
+}
+
+void GDScriptCppCodeGenerator::write_ternary_true_expr(const Address &p_expr) {
+	bytecode.write_ternary_true_expr(p_expr);
+}
+
+void GDScriptCppCodeGenerator::write_ternary_false_expr(const Address &p_expr) {
+	bytecode.write_ternary_false_expr(p_expr);
+}
+
+void GDScriptCppCodeGenerator::write_end_ternary() {
+	bytecode.write_end_ternary();
+}
+
+void GDScriptCppCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
+	_check_typed(p_target);
+	_check_typed(p_index);
+	bytecode.write_set(p_target, p_index, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_get(const Address &p_target, const Address &p_index, const Address &p_source) {
+	_check_typed(p_index);
+	_check_typed(p_source);
+	bytecode.write_get(p_target, p_index, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_get_dictionary_key(const Address &p_target, const Address &p_key, const Address &p_source) {
+	_check_typed(p_key);
+	_check_typed(p_source);
+	bytecode.write_get_dictionary_key(p_target, p_key, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_set_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
+	_check_typed(p_target);
+	bytecode.write_set_named(p_target, p_name, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
+	_check_typed(p_source);
+	bytecode.write_get_named(p_target, p_name, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
+	bytecode.write_set_member(p_value, p_name);
+}
+
+void GDScriptCppCodeGenerator::write_get_member(const Address &p_target, const StringName &p_name) {
+	bytecode.write_get_member(p_target, p_name);
+}
+
+void GDScriptCppCodeGenerator::write_set_static_variable(const Address &p_value, const Address &p_class, int p_index) {
+	bytecode.write_set_static_variable(p_value, p_class, p_index);
+}
+
+void GDScriptCppCodeGenerator::write_get_static_variable(const Address &p_target, const Address &p_class, int p_index) {
+	bytecode.write_get_static_variable(p_target, p_class, p_index);
+}
+
+void GDScriptCppCodeGenerator::write_assign(const Address &p_target, const Address &p_source) {
+	bytecode.write_assign(p_target, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_assign_with_conversion(const Address &p_target, const Address &p_source) {
+	bytecode.write_assign_with_conversion(p_target, p_source);
+}
+
+void GDScriptCppCodeGenerator::write_assign_null(const Address &p_target) {
+	bytecode.write_assign_null(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_assign_true(const Address &p_target) {
+	bytecode.write_assign_true(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_assign_false(const Address &p_target) {
+	bytecode.write_assign_false(p_target);
+}
+
+void GDScriptCppCodeGenerator::write_assign_default_parameter(const Address &dst, const Address &src, bool p_use_conversion) {
+	bytecode.write_assign_default_parameter(dst, src, p_use_conversion);
+}
+
+void GDScriptCppCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
+	bytecode.write_store_global(p_dst, p_global_index);
+}
+
+void GDScriptCppCodeGenerator::write_store_named_global(const Address &p_dst, const StringName &p_global) {
+	bytecode.write_store_named_global(p_dst, p_global);
+}
+
+void GDScriptCppCodeGenerator::write_cast(const Address &p_target, const Address &p_source, const GDScriptDataType &p_type) {
+	bytecode.write_cast(p_target, p_source, p_type);
+}
+
+void GDScriptCppCodeGenerator::write_call(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	_check_typed(p_base);
+	bytecode.write_call(p_target, p_base, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_super_call(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	bytecode.write_super_call(p_target, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_async(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	bytecode.write_call_async(p_target, p_base, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_utility(const Address &p_target, const StringName &p_function, const Vector<Address> &p_arguments) {
+	bytecode.write_call_utility(p_target, p_function, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_gdscript_utility(const Address &p_target, const StringName &p_function, const Vector<Address> &p_arguments) {
+	bytecode.write_call_gdscript_utility(p_target, p_function, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_builtin_type(const Address &p_target, const Address &p_base, Variant::Type p_type, const StringName &p_method, const Vector<Address> &p_arguments) {
+	_check_typed(p_base);
+	bytecode.write_call_builtin_type(p_target, p_base, p_type, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_builtin_type_static(const Address &p_target, Variant::Type p_type, const StringName &p_method, const Vector<Address> &p_arguments) {
+	bytecode.write_call_builtin_type_static(p_target, p_type, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_native_static(const Address &p_target, const StringName &p_class, const StringName &p_method, const Vector<Address> &p_arguments) {
+	bytecode.write_call_native_static(p_target, p_class, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_native_static_validated(const Address &p_target, MethodBind *p_method, const Vector<Address> &p_arguments) {
+	bytecode.write_call_native_static_validated(p_target, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_method_bind(const Address &p_target, const Address &p_base, MethodBind *p_method, const Vector<Address> &p_arguments) {
+	_check_typed(p_base);
+	bytecode.write_call_method_bind(p_target, p_base, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_method_bind_validated(const Address &p_target, const Address &p_base, MethodBind *p_method, const Vector<Address> &p_arguments) {
+	_check_typed(p_base);
+	bytecode.write_call_method_bind_validated(p_target, p_base, p_method, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_self(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	bytecode.write_call_self(p_target, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	bytecode.write_call_self_async(p_target, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	_check_typed(p_base);
+	bytecode.write_call_script_function(p_target, p_base, p_function_name, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures, bool p_use_self) {
+	bytecode.write_lambda(p_target, p_function, p_captures, p_use_self);
+}
+
+void GDScriptCppCodeGenerator::write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) {
+	bytecode.write_construct(p_target, p_type, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) {
+	bytecode.write_construct_array(p_target, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments) {
+	bytecode.write_construct_typed_array(p_target, p_element_type, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_construct_scratch_array(const Address &p_target, const Vector<Address> &p_arguments) {
+	bytecode.write_construct_scratch_array(p_target, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) {
+	bytecode.write_construct_dictionary(p_target, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments) {
+	bytecode.write_construct_typed_dictionary(p_target, p_key_type, p_value_type, p_arguments);
+}
+
+void GDScriptCppCodeGenerator::write_await(const Address &p_target, const Address &p_operand) {
+	bytecode.write_await(p_target, p_operand);
+}
+
+void GDScriptCppCodeGenerator::write_if(const Address &p_condition) {
+	_check_typed(p_condition);
+	bytecode.write_if(p_condition);
+}
+
+void GDScriptCppCodeGenerator::write_else() {
+	bytecode.write_else();
+}
+
+void GDScriptCppCodeGenerator::write_endif() {
+	bytecode.write_endif();
+}
+
+void GDScriptCppCodeGenerator::write_jump_if_shared(const Address &p_value) {
+	bytecode.write_jump_if_shared(p_value);
+}
+
+void GDScriptCppCodeGenerator::write_end_jump_if_shared() {
+	bytecode.write_end_jump_if_shared();
+}
+
+void GDScriptCppCodeGenerator::start_for(const GDScriptDataType &p_iterator_type, const GDScriptDataType &p_list_type, bool p_is_range) {
+	bytecode.start_for(p_iterator_type, p_list_type, p_is_range);
+}
+
+void GDScriptCppCodeGenerator::write_for_list_assignment(const Address &p_list) {
+	_check_typed(p_list);
+	bytecode.write_for_list_assignment(p_list);
+}
+
+void GDScriptCppCodeGenerator::write_for_range_assignment(const Address &p_from, const Address &p_to, const Address &p_step) {
+	bytecode.write_for_range_assignment(p_from, p_to, p_step);
+}
+
+void GDScriptCppCodeGenerator::write_for(const Address &p_variable, bool p_use_conversion, bool p_is_range) {
+	bytecode.write_for(p_variable, p_use_conversion, p_is_range);
+}
+
+void GDScriptCppCodeGenerator::write_endfor(bool p_is_range) {
+	bytecode.write_endfor(p_is_range);
+}
+
+void GDScriptCppCodeGenerator::start_while_condition() {
+	bytecode.start_while_condition();
+}
+
+void GDScriptCppCodeGenerator::write_while(const Address &p_condition) {
+	_check_typed(p_condition);
+	bytecode.write_while(p_condition);
+}
+
+void GDScriptCppCodeGenerator::write_endwhile() {
+	bytecode.write_endwhile();
+}
+
+void GDScriptCppCodeGenerator::write_break() {
+	bytecode.write_break();
+}
+
+void GDScriptCppCodeGenerator::write_continue() {
+	bytecode.write_continue();
+}
+
+void GDScriptCppCodeGenerator::write_breakpoint() {
+	bytecode.write_breakpoint();
+}
+
+void GDScriptCppCodeGenerator::write_newline(int p_line) {
+	bytecode.write_newline(p_line);
+}
+
+void GDScriptCppCodeGenerator::write_return(const Address &p_return_value) {
+	bytecode.write_return(p_return_value);
+}
+
+void GDScriptCppCodeGenerator::write_assert(const Address &p_test, const Address &p_message) {
+	bytecode.write_assert(p_test, p_message);
+}
+
+#endif // TOOLS_ENABLED
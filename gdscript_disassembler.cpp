@@ -39,6 +39,11 @@ static constexpr int _inline_cache_ptr_slots = sizeof(void *) / sizeof(int);
 static_assert(sizeof(void *) % sizeof(int) == 0, "Pointer size must be divisible by int size for inline caches.");
 static constexpr int _inline_cache_pic_size = 4;
 
+// Lean bytecode doesn't keep debug names.
+static String _get_debug_name(const Vector<String> &p_names, int p_index) {
+	return p_index < p_names.size() ? p_names[p_index] : String("<stripped>");
+}
+
 static String _get_variant_string(const Variant &p_variant) {
 	String txt;
 	if (p_variant.get_type() == Variant::STRING) {
@@ -117,7 +122,6 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 		switch (opcode) {
 			case OPCODE_OPERATOR: {
-				constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*_code_ptr);
 				int operation = _code_ptr[ip + 4];
 
 				text += "operator ";
@@ -130,7 +134,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += " ";
 				text += DADDR(2);
 
-				incr += 7 + _pointer_size;
+				incr += 7;
 			} break;
 			case OPCODE_OPERATOR_VALIDATED: {
 				text += "validated operator ";
@@ -139,7 +143,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += " = ";
 				text += DADDR(1);
 				text += " ";
-				text += operator_names[_code_ptr[ip + 4]];
+				text += _get_debug_name(operator_names, _code_ptr[ip + 4]);
 				text += " ";
 				text += DADDR(2);
 
@@ -293,6 +297,17 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_GET_DICTIONARY_KEY: {
+				text += "get dictionary key ";
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += "[";
+				text += DADDR(2);
+				text += "]";
+
+				incr += 4;
+			} break;
 			case OPCODE_GET_INDEXED_VALIDATED: {
 				text += "get indexed validated ";
 				text += DADDR(3);
@@ -318,7 +333,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "set_named validated ";
 				text += DADDR(1);
 				text += "[\"";
-				text += setter_names[_code_ptr[ip + 3]];
+				text += _get_debug_name(setter_names, _code_ptr[ip + 3]);
 				text += "\"] = ";
 				text += DADDR(2);
 
@@ -335,13 +350,24 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 4 + (_inline_cache_ptr_slots * 2 * _inline_cache_pic_size);
 			} break;
+			case OPCODE_GET_NAMED_SPECULATED: {
+				text += "get_named speculated ";
+				text += DADDR(2);
+				text += " = ";
+				text += DADDR(1);
+				text += "[\"";
+				text += _global_names_ptr[_code_ptr[ip + 3]];
+				text += "\"]";
+
+				incr += 4 + (_inline_cache_ptr_slots * 2 * _inline_cache_pic_size);
+			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
 				text += DADDR(2);
 				text += " = ";
 				text += DADDR(1);
 				text += "[\"";
-				text += getter_names[_code_ptr[ip + 3]];
+				text += _get_debug_name(getter_names, _code_ptr[ip + 3]);
 				text += "\"]";
 
 				incr += 4;
@@ -542,7 +568,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += DADDR(1 + argc);
 				text += " = ";
 
-				text += constructors_names[_code_ptr[ip + 3 + argc]];
+				text += _get_debug_name(constructors_names, _code_ptr[ip + 3 + argc]);
 				text += "(";
 				for (int i = 0; i < argc; i++) {
 					if (i > 0) {
@@ -572,6 +598,26 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 3 + argc;
 			} break;
+			case OPCODE_CONSTRUCT_SCRATCH_ARRAY: {
+				int instr_var_args = _code_ptr[++ip];
+				int argc = _code_ptr[ip + 1 + instr_var_args];
+				text += "make_scratch_array ";
+				text += DADDR(2 + argc);
+				text += " = ";
+				text += DADDR(1 + argc);
+				text += " <- [";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						text += ", ";
+					}
+					text += DADDR(1 + i);
+				}
+
+				text += "]";
+
+				incr += 4 + argc;
+			} break;
 			case OPCODE_CONSTRUCT_TYPED_ARRAY: {
 				int instr_var_args = _code_ptr[++ip];
 				int argc = _code_ptr[ip + 1 + instr_var_args];
@@ -681,13 +727,27 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 			} break;
 			case OPCODE_CALL:
 			case OPCODE_CALL_RETURN:
-			case OPCODE_CALL_ASYNC: {
-				bool ret = (_code_ptr[ip]) == OPCODE_CALL_RETURN;
+			case OPCODE_CALL_ASYNC:
+			case OPCODE_CALL_SCRIPT:
+			case OPCODE_CALL_SCRIPT_RETURN:
+			case OPCODE_CALL_BUILTIN_SPECULATED: {
+				bool ret = (_code_ptr[ip]) == OPCODE_CALL_RETURN || (_code_ptr[ip]) == OPCODE_CALL_SCRIPT_RETURN;
 				bool async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
+				bool script = (_code_ptr[ip]) == OPCODE_CALL_SCRIPT || (_code_ptr[ip]) == OPCODE_CALL_SCRIPT_RETURN;
+				bool speculated = (_code_ptr[ip]) == OPCODE_CALL_BUILTIN_SPECULATED;
 
 				int instr_var_args = _code_ptr[++ip];
+				int argc = _code_ptr[ip + 1 + instr_var_args];
+				if (speculated) {
+					const Speculation *speculation = _get_speculation(_code_ptr[ip + 3 + instr_var_args + _inline_cache_ptr_slots * _inline_cache_pic_size + 2]);
+					ret = speculation != nullptr && speculation->call_return;
+				}
 
-				if (ret) {
+				if (script) {
+					text += ret ? "call-script-ret " : "call-script ";
+				} else if (speculated) {
+					text += ret ? "call-speculated-ret " : "call-speculated ";
+				} else if (ret) {
 					text += "call-ret ";
 				} else if (async) {
 					text += "call-async ";
@@ -695,7 +755,6 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 					text += "call ";
 				}
 
-				int argc = _code_ptr[ip + 1 + instr_var_args];
 				if (ret || async) {
 					text += DADDR(2 + argc) + " = ";
 				}
@@ -890,7 +949,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += DADDR(2 + argc) + " = ";
 
 				text += DADDR(1) + ".";
-				text += builtin_methods_names[_code_ptr[ip + 4 + argc]];
+				text += _get_debug_name(builtin_methods_names, _code_ptr[ip + 4 + argc]);
 
 				text += "(";
 
@@ -933,7 +992,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				int argc = _code_ptr[ip + 1 + instr_var_args];
 				text += DADDR(1 + argc) + " = ";
 
-				text += utilities_names[_code_ptr[ip + 3 + argc]];
+				text += _get_debug_name(utilities_names, _code_ptr[ip + 3 + argc]);
 				text += "(";
 
 				for (int i = 0; i < argc; i++) {
@@ -954,7 +1013,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				int argc = _code_ptr[ip + 1 + instr_var_args];
 				text += DADDR(1 + argc) + " = ";
 
-				text += gds_utilities_names[_code_ptr[ip + 3 + argc]];
+				text += _get_debug_name(gds_utilities_names, _code_ptr[ip + 3 + argc]);
 				text += "(";
 
 				for (int i = 0; i < argc; i++) {
@@ -1244,10 +1303,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 3;
 			} break;
-			case OPCODE_LINE: {
+			case OPCODE_LINE:
+			case OPCODE_LINE_BREAKPOINT: {
 				int line = _code_ptr[ip + 1] - 1;
 				if (line >= 0 && line < p_code_lines.size()) {
-					text += "line ";
+					text += _code_ptr[ip] == OPCODE_LINE_BREAKPOINT ? "line (breakpoint) " : "line ";
 					text += itos(line + 1);
 					text += ": ";
 					text += p_code_lines[line];
@@ -1332,6 +1392,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 			print_line(text.as_string());
 		}
 	}
+
+	const BytecodeStats stats = get_bytecode_stats();
+	print_line(vformat(" ; %d bytes of code (%d inline caches, %d bytes), frame of %d slots (%d temporaries, %d bytes), %d constants (%d bytes), %d bytes of pointer tables, %d bytes of debug data, %d bytes total",
+			stats.code_bytes, stats.inline_cache_count, stats.inline_cache_bytes, stats.stack_size, stats.temporary_count, stats.frame_bytes,
+			stats.constant_count, stats.constant_bytes, stats.pointer_table_bytes, stats.debug_bytes, stats.get_total_bytes()));
 }
 
 #endif // DEBUG_ENABLED
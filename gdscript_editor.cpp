@@ -280,6 +280,10 @@ bool GDScriptLanguage::debug_break(const String &p_error, bool p_allow_continue)
 		_debug_error = p_error;
 		bool is_error_breakpoint = p_error != "Breakpoint";
 		EngineDebugger::get_script_debugger()->debug(this, p_allow_continue, is_error_breakpoint);
+#ifdef DEBUG_ENABLED
+		// Breakpoints are usually edited while paused.
+		_sync_breakpoint_traps();
+#endif
 		// Because this is thread local, clear the memory afterwards.
 		_debug_parse_err_file = String();
 		_debug_error = String();
@@ -703,6 +707,104 @@ static int _get_enum_location(const StringName &p_class, const StringName &p_enu
 
 // END LOCATION METHODS
 
+// NATIVE COMPLETION CACHE
+// The members of a native class only change when extensions are loaded or unloaded, so the options
+// for them are built once per class, with locations relative to that class. Completion requests copy
+// them and offset the location by the recursion depth, instead of walking ClassDB every time.
+
+struct GDScriptNativeCompletionSet {
+	struct Method {
+		ScriptLanguage::CodeCompletionOption option;
+		bool has_arguments = false;
+		bool is_static = false;
+	};
+
+	LocalVector<ScriptLanguage::CodeCompletionOption> enums;
+	LocalVector<ScriptLanguage::CodeCompletionOption> constants;
+	LocalVector<ScriptLanguage::CodeCompletionOption> properties;
+	LocalVector<ScriptLanguage::CodeCompletionOption> signals;
+	LocalVector<Method> methods;
+};
+
+static Mutex native_completion_mutex;
+static HashMap<StringName, GDScriptNativeCompletionSet> native_completion_sets;
+static LocalVector<ScriptLanguage::CodeCompletionOption> native_type_options;
+static bool native_type_options_cached = false;
+static uint32_t native_type_options_singletons_hash = 0; // Singletons hide their class, see `_list_available_types()`.
+
+// Must be called with `native_completion_mutex` locked.
+static const GDScriptNativeCompletionSet &_get_native_completion_set(const StringName &p_class) {
+	HashMap<StringName, GDScriptNativeCompletionSet>::ConstIterator cached = native_completion_sets.find(p_class);
+	if (cached) {
+		return cached->value;
+	}
+
+	GDScriptNativeCompletionSet set;
+
+	List<StringName> enums;
+	ClassDB::get_enum_list(p_class, &enums);
+	for (const StringName &E : enums) {
+		set.enums.push_back(ScriptLanguage::CodeCompletionOption(E, ScriptLanguage::CODE_COMPLETION_KIND_ENUM, _get_enum_location(p_class, E)));
+	}
+
+	List<String> constants;
+	ClassDB::get_integer_constant_list(p_class, &constants);
+	for (const String &E : constants) {
+		set.constants.push_back(ScriptLanguage::CodeCompletionOption(E, ScriptLanguage::CODE_COMPLETION_KIND_CONSTANT, _get_constant_location(p_class, StringName(E))));
+	}
+
+	List<PropertyInfo> pinfo;
+	ClassDB::get_property_list(p_class, &pinfo);
+	for (const PropertyInfo &E : pinfo) {
+		if (E.usage & (PROPERTY_USAGE_CATEGORY | PROPERTY_USAGE_GROUP | PROPERTY_USAGE_SUBGROUP | PROPERTY_USAGE_INTERNAL)) {
+			continue;
+		}
+		if (E.name.contains_char('/')) {
+			continue;
+		}
+		set.properties.push_back(ScriptLanguage::CodeCompletionOption(E.name, ScriptLanguage::CODE_COMPLETION_KIND_MEMBER, _get_property_location(p_class, E.name)));
+	}
+
+	List<MethodInfo> signals;
+	ClassDB::get_signal_list(p_class, &signals);
+	for (const MethodInfo &E : signals) {
+		if (E.name.begins_with("_")) {
+			continue;
+		}
+		set.signals.push_back(ScriptLanguage::CodeCompletionOption(E.name, ScriptLanguage::CODE_COMPLETION_KIND_SIGNAL, _get_signal_location(p_class, StringName(E.name))));
+	}
+
+	List<MethodInfo> methods;
+	ClassDB::get_method_list(p_class, &methods, false, true);
+	for (const MethodInfo &E : methods) {
+		if (E.name.begins_with("_")) {
+			continue;
+		}
+		GDScriptNativeCompletionSet::Method method;
+		method.option = ScriptLanguage::CodeCompletionOption(E.name, ScriptLanguage::CODE_COMPLETION_KIND_FUNCTION, _get_method_location(p_class, E.name));
+		method.has_arguments = E.arguments.size() || (E.flags & METHOD_FLAG_VARARG);
+		method.is_static = E.flags & METHOD_FLAG_STATIC;
+		set.methods.push_back(method);
+	}
+
+	return native_completion_sets.insert(p_class, set)->value;
+}
+
+static void _insert_native_option(const ScriptLanguage::CodeCompletionOption &p_option, int p_recursion_depth, HashMap<String, ScriptLanguage::CodeCompletionOption> &r_result) {
+	ScriptLanguage::CodeCompletionOption option = p_option;
+	option.location += p_recursion_depth;
+	r_result.insert(option.display, option);
+}
+
+void GDScriptLanguage::clear_native_completion_cache() {
+	MutexLock lock(native_completion_mutex);
+	native_completion_sets.clear();
+	native_type_options.clear();
+	native_type_options_cached = false;
+}
+
+// END NATIVE COMPLETION CACHE
+
 static String _trim_parent_class(const String &p_class, const String &p_base_class) {
 	if (p_base_class.is_empty()) {
 		return p_class;
@@ -1056,11 +1158,32 @@ static void _list_available_types(bool p_inherit_only, GDScriptParser::Completio
 		r_result.insert(variant_option.display, variant_option);
 	}
 
-	LocalVector<StringName> native_types;
-	ClassDB::get_class_list(native_types);
-	for (const StringName &type : native_types) {
-		if (ClassDB::is_class_exposed(type) && !Engine::get_singleton()->has_singleton(type)) {
-			ScriptLanguage::CodeCompletionOption option(type, ScriptLanguage::CODE_COMPLETION_KIND_CLASS);
+	{
+		// Singletons can be registered after the options were built, by extensions for example.
+		List<Engine::Singleton> singletons;
+		Engine::get_singleton()->get_singletons(&singletons);
+		uint32_t singletons_hash = HASH_MURMUR3_SEED;
+		for (const Engine::Singleton &E : singletons) {
+			singletons_hash = hash_murmur3_one_32(E.name.hash(), singletons_hash);
+		}
+
+		MutexLock lock(native_completion_mutex);
+		if (native_type_options_cached && native_type_options_singletons_hash != singletons_hash) {
+			native_type_options.clear();
+			native_type_options_cached = false;
+		}
+		if (!native_type_options_cached) {
+			LocalVector<StringName> native_types;
+			ClassDB::get_class_list(native_types);
+			for (const StringName &type : native_types) {
+				if (ClassDB::is_class_exposed(type) && !Engine::get_singleton()->has_singleton(type)) {
+					native_type_options.push_back(ScriptLanguage::CodeCompletionOption(type, ScriptLanguage::CODE_COMPLETION_KIND_CLASS));
+				}
+			}
+			native_type_options_cached = true;
+			native_type_options_singletons_hash = singletons_hash;
+		}
+		for (const ScriptLanguage::CodeCompletionOption &option : native_type_options) {
 			r_result.insert(option.display, option);
 		}
 	}
@@ -1365,12 +1488,11 @@ static void _find_identifiers_in_base(const GDScriptCompletionIdentifier &p_base
 					return;
 				}
 
-				List<StringName> enums;
-				ClassDB::get_enum_list(type, &enums);
-				for (const StringName &E : enums) {
-					int location = p_recursion_depth + _get_enum_location(type, E);
-					ScriptLanguage::CodeCompletionOption option(E, ScriptLanguage::CODE_COMPLETION_KIND_ENUM, location);
-					r_result.insert(option.display, option);
+				MutexLock lock(native_completion_mutex);
+				const GDScriptNativeCompletionSet &native_set = _get_native_completion_set(type);
+
+				for (const ScriptLanguage::CodeCompletionOption &E : native_set.enums) {
+					_insert_native_option(E, p_recursion_depth, r_result);
 				}
 
 				if (p_types_only) {
@@ -1378,57 +1500,30 @@ static void _find_identifiers_in_base(const GDScriptCompletionIdentifier &p_base
 				}
 
 				if (!p_only_functions) {
-					List<String> constants;
-					ClassDB::get_integer_constant_list(type, &constants);
-					for (const String &E : constants) {
-						int location = p_recursion_depth + _get_constant_location(type, StringName(E));
-						ScriptLanguage::CodeCompletionOption option(E, ScriptLanguage::CODE_COMPLETION_KIND_CONSTANT, location);
-						r_result.insert(option.display, option);
+					for (const ScriptLanguage::CodeCompletionOption &E : native_set.constants) {
+						_insert_native_option(E, p_recursion_depth, r_result);
 					}
 
 					if (!base_type.is_meta_type || Engine::get_singleton()->has_singleton(type)) {
-						List<PropertyInfo> pinfo;
-						ClassDB::get_property_list(type, &pinfo);
-						for (const PropertyInfo &E : pinfo) {
-							if (E.usage & (PROPERTY_USAGE_CATEGORY | PROPERTY_USAGE_GROUP | PROPERTY_USAGE_SUBGROUP | PROPERTY_USAGE_INTERNAL)) {
-								continue;
-							}
-							if (E.name.contains_char('/')) {
-								continue;
-							}
-							int location = p_recursion_depth + _get_property_location(type, E.name);
-							ScriptLanguage::CodeCompletionOption option(E.name, ScriptLanguage::CODE_COMPLETION_KIND_MEMBER, location);
-							r_result.insert(option.display, option);
+						for (const ScriptLanguage::CodeCompletionOption &E : native_set.properties) {
+							_insert_native_option(E, p_recursion_depth, r_result);
 						}
-
-						List<MethodInfo> signals;
-						ClassDB::get_signal_list(type, &signals);
-						for (const MethodInfo &E : signals) {
-							if (E.name.begins_with("_")) {
-								continue;
-							}
-							int location = p_recursion_depth + _get_signal_location(type, StringName(E.name));
-							ScriptLanguage::CodeCompletionOption option(E.name, ScriptLanguage::CODE_COMPLETION_KIND_SIGNAL, location);
-							r_result.insert(option.display, option);
+						for (const ScriptLanguage::CodeCompletionOption &E : native_set.signals) {
+							_insert_native_option(E, p_recursion_depth, r_result);
 						}
 					}
 				}
 
 				bool only_static = base_type.is_meta_type && !Engine::get_singleton()->has_singleton(type);
 
-				List<MethodInfo> methods;
-				ClassDB::get_method_list(type, &methods, false, true);
-				for (const MethodInfo &E : methods) {
-					if (only_static && (E.flags & METHOD_FLAG_STATIC) == 0) {
+				for (const GDScriptNativeCompletionSet::Method &E : native_set.methods) {
+					if (only_static && !E.is_static) {
 						continue;
 					}
-					if (E.name.begins_with("_")) {
-						continue;
-					}
-					int location = p_recursion_depth + _get_method_location(type, E.name);
-					ScriptLanguage::CodeCompletionOption option(E.name, ScriptLanguage::CODE_COMPLETION_KIND_FUNCTION, location);
+					ScriptLanguage::CodeCompletionOption option = E.option;
+					option.location += p_recursion_depth;
 					if (p_add_braces) {
-						if (E.arguments.size() || (E.flags & METHOD_FLAG_VARARG)) {
+						if (E.has_arguments) {
 							option.insert_text += "(";
 							option.display += U"(\u2026)";
 						} else {
@@ -3472,12 +3567,21 @@ static void _find_call_arguments(GDScriptParser::CompletionContext &p_context, c
 }
 
 ::Error GDScriptLanguage::complete_code(const String &p_code, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint) {
-	const String quote_style = EDITOR_GET("text_editor/completion/use_single_quotes") ? "'" : "\"";
+	GDScriptParser parser;
+	parser.parse(p_code, p_path, true);
+	return _complete_code(parser, p_path, p_owner, r_options, r_forced, r_call_hint);
+}
 
+::Error GDScriptLanguage::complete_code_at(const String &p_code, int p_line, int p_character, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint) {
 	GDScriptParser parser;
-	GDScriptAnalyzer analyzer(&parser);
+	parser.parse_with_cursor(p_code, p_path, p_line, p_character);
+	return _complete_code(parser, p_path, p_owner, r_options, r_forced, r_call_hint);
+}
 
-	parser.parse(p_code, p_path, true);
+::Error GDScriptLanguage::_complete_code(GDScriptParser &parser, const String &p_path, Object *p_owner, List<ScriptLanguage::CodeCompletionOption> *r_options, bool &r_forced, String &r_call_hint) {
+	const String quote_style = EDITOR_GET("text_editor/completion/use_single_quotes") ? "'" : "\"";
+
+	GDScriptAnalyzer analyzer(&parser);
 	analyzer.analyze();
 
 	r_forced = false;
@@ -4320,36 +4424,57 @@ static Error _lookup_symbol_from_base(const GDScriptParser::DataType &p_base, co
 	return ERR_CANT_RESOLVE;
 }
 
-::Error GDScriptLanguage::lookup_code(const String &p_code, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result) {
-	// Before parsing, try the usual stuff.
+static bool _lookup_symbol_without_parsing(const String &p_symbol, ScriptLanguage::LookupResult &r_result) {
 	if (GDScriptAnalyzer::class_exists(p_symbol)) {
 		r_result.type = ScriptLanguage::LOOKUP_RESULT_CLASS;
 		r_result.class_name = p_symbol;
-		return OK;
+		return true;
 	}
 
 	if (Variant::get_type_by_name(p_symbol) < Variant::VARIANT_MAX) {
 		r_result.type = ScriptLanguage::LOOKUP_RESULT_CLASS;
 		r_result.class_name = p_symbol;
-		return OK;
+		return true;
 	}
 
 	if (p_symbol == "Variant") {
 		r_result.type = ScriptLanguage::LOOKUP_RESULT_CLASS;
 		r_result.class_name = "Variant";
-		return OK;
+		return true;
 	}
 
 	if (p_symbol == "PI" || p_symbol == "TAU" || p_symbol == "INF" || p_symbol == "NAN") {
 		r_result.type = ScriptLanguage::LOOKUP_RESULT_CLASS_CONSTANT;
 		r_result.class_name = "@GDScript";
 		r_result.class_member = p_symbol;
+		return true;
+	}
+
+	return false;
+}
+
+::Error GDScriptLanguage::lookup_code(const String &p_code, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result) {
+	// Before parsing, try the usual stuff.
+	if (_lookup_symbol_without_parsing(p_symbol, r_result)) {
 		return OK;
 	}
 
 	GDScriptParser parser;
 	parser.parse(p_code, p_path, true);
+	return _lookup_code(parser, p_symbol, p_path, p_owner, r_result);
+}
+
+::Error GDScriptLanguage::lookup_code_at(const String &p_code, int p_line, int p_character, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result) {
+	if (_lookup_symbol_without_parsing(p_symbol, r_result)) {
+		return OK;
+	}
+
+	GDScriptParser parser;
+	parser.parse_with_cursor(p_code, p_path, p_line, p_character);
+	return _lookup_code(parser, p_symbol, p_path, p_owner, r_result);
+}
 
+::Error GDScriptLanguage::_lookup_code(GDScriptParser &parser, const String &p_symbol, const String &p_path, Object *p_owner, LookupResult &r_result) {
 	GDScriptParser::CompletionContext context = parser.get_completion_context();
 	context.base = p_owner;
 
@@ -31,79 +31,416 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_utility_functions.h"
+
+bool GDScriptDataType::is_native_subtype(const StringName &p_class, const StringName &p_base) {
+	return p_class == p_base || GDScriptLanguage::get_singleton()->is_native_subclass(p_class, p_base);
+}
+
+bool GDScriptDataType::is_script_subtype(Script *p_script, const Script *p_base) {
+	const GDScript *gdscript = Object::cast_to<GDScript>(p_script);
+	const GDScript *gdscript_base = Object::cast_to<GDScript>(p_base);
+	if (gdscript && gdscript_base) {
+		return gdscript->is_subclass_of(gdscript_base);
+	}
+
+	while (p_script) {
+		if (p_script == p_base) {
+			return true;
+		}
+		p_script = p_script->get_base_script().ptr();
+	}
+	return false;
+}
+
+int GDScriptConstantPool::add_constant(const Variant &p_constant) {
+	ERR_FAIL_COND_V(finalized, -1);
+
+	// Mutable containers are never merged, each use keeps its own instance.
+	bool shareable = true;
+	bool typed = false;
+	if (p_constant.get_type() == Variant::ARRAY) {
+		const Array array = p_constant;
+		shareable = array.is_read_only();
+		typed = array.is_typed();
+	} else if (p_constant.get_type() == Variant::DICTIONARY) {
+		const Dictionary dictionary = p_constant;
+		shareable = dictionary.is_read_only();
+		typed = dictionary.is_typed();
+	}
+
+	if (shareable && typed) {
+		// The comparator doesn't look at element types, equal contents don't mean the same container.
+		for (int index : typed_containers) {
+			if (_is_same_typed_container(constants[index], p_constant)) {
+				return index;
+			}
+		}
+		typed_containers.push_back(constants.size());
+	} else if (shareable) {
+		HashMap<Variant, int, VariantHasher, VariantComparator>::ConstIterator E = constant_map.find(p_constant);
+		if (E) {
+			return E->value;
+		}
+		constant_map.insert(p_constant, constants.size());
+	}
+	constants.push_back(p_constant);
+	return constants.size() - 1;
+}
+
+bool GDScriptConstantPool::_is_same_typed_container(const Variant &p_a, const Variant &p_b) {
+	if (p_a.get_type() != p_b.get_type()) {
+		return false;
+	}
+	if (p_a.get_type() == Variant::ARRAY) {
+		const Array a = p_a;
+		const Array b = p_b;
+		if (a.get_typed_builtin() != b.get_typed_builtin() || a.get_typed_class_name() != b.get_typed_class_name() || a.get_typed_script() != b.get_typed_script()) {
+			return false;
+		}
+	} else {
+		const Dictionary a = p_a;
+		const Dictionary b = p_b;
+		if (a.get_typed_key_builtin() != b.get_typed_key_builtin() || a.get_typed_key_class_name() != b.get_typed_key_class_name() || a.get_typed_key_script() != b.get_typed_key_script()) {
+			return false;
+		}
+		if (a.get_typed_value_builtin() != b.get_typed_value_builtin() || a.get_typed_value_class_name() != b.get_typed_value_class_name() || a.get_typed_value_script() != b.get_typed_value_script()) {
+			return false;
+		}
+	}
+	return VariantComparator::compare(p_a, p_b);
+}
+
+int GDScriptConstantPool::add_global_name(const StringName &p_name) {
+	ERR_FAIL_COND_V(finalized, -1);
+
+	HashMap<StringName, int>::ConstIterator E = name_map.find(p_name);
+	if (E) {
+		return E->value;
+	}
+	name_map.insert(p_name, global_names.size());
+	global_names.push_back(p_name);
+	return global_names.size() - 1;
+}
+
+void GDScriptConstantPool::add_function(GDScriptFunction *p_function) {
+	ERR_FAIL_COND(finalized);
+	refcount.ref();
+	p_function->constant_pool = this;
+	functions.push_back(p_function);
+}
+
+void GDScriptConstantPool::finalize() {
+	finalized = true;
+
+	// The pool can't grow anymore, so the pointers stay valid.
+	for (GDScriptFunction *function : functions) {
+		function->_constant_count = constants.size();
+		function->_constants_ptr = constants.is_empty() ? nullptr : constants.ptrw();
+		function->_global_names_count = global_names.size();
+		function->_global_names_ptr = global_names.is_empty() ? nullptr : global_names.ptr();
+	}
+
+	functions.reset();
+	constant_map.reset();
+	typed_containers.reset();
+	name_map.reset();
+}
+
+void GDScriptConstantPool::unreference() {
+	if (refcount.unref()) {
+		memdelete(this);
+	}
+}
+
+int GDScriptConstantPool::get_memory_usage() const {
+	// Only the constants themselves, shared payloads (strings, arrays...) aren't counted.
+	return constants.size() * sizeof(Variant) + global_names.size() * sizeof(StringName);
+}
 
 Variant GDScriptFunction::get_constant(int p_idx) const {
-	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
-	return constants[p_idx];
+	ERR_FAIL_INDEX_V(p_idx, _constant_count, "<errconst>");
+	return _constants_ptr[p_idx];
 }
 
 StringName GDScriptFunction::get_global_name(int p_idx) const {
-	ERR_FAIL_INDEX_V(p_idx, global_names.size(), "<errgname>");
-	return global_names[p_idx];
+	ERR_FAIL_INDEX_V(p_idx, _global_names_count, "<errgname>");
+	return _global_names_ptr[p_idx];
 }
 
-struct _GDFKC {
-	int order = 0;
-	List<int> pos;
-};
+void GDScriptFunction::_build_local_variable_table(const List<StackDebug> &p_stack_debug) {
+	local_ranges.clear();
+	local_range_parents.clear();
+	local_segment_lines.clear();
+	local_segment_ranges.clear();
+	local_ranges_nested = true;
+
+	// Pair each `added` event with its matching removal. Identifiers can be shadowed
+	// in nested blocks, so keep a stack of open ranges per identifier.
+	HashMap<StringName, Vector<int>> open_ranges;
+	for (const StackDebug &sd : p_stack_debug) {
+		if (sd.added) {
+			LocalVariableRange range;
+			range.identifier = sd.identifier;
+			range.slot = sd.pos;
+			range.start_line = sd.line;
+			open_ranges[sd.identifier].push_back(local_ranges.size());
+			local_ranges.push_back(range);
+		} else {
+			HashMap<StringName, Vector<int>>::Iterator E = open_ranges.find(sd.identifier);
+			ERR_CONTINUE(!E || E->value.is_empty());
+			local_ranges.write[E->value[E->value.size() - 1]].end_line = sd.line;
+			E->value.resize(E->value.size() - 1);
+		}
+	}
+
+	if (local_ranges.is_empty()) {
+		return;
+	}
 
-struct _GDFKCS {
-	int order = 0;
-	StringName id;
-	int pos = 0;
+	// A range is visible for lines in `[start_line + 1, end_line]`. Sort them by first visible
+	// line, outermost first, so each range's enclosing ranges are on the stack when it is reached.
+	struct RangeOrder {
+		const LocalVariableRange *ranges = nullptr;
+		RangeOrder(const LocalVariableRange *p_ranges) :
+				ranges(p_ranges) {}
+		bool operator()(int p_a, int p_b) const {
+			const LocalVariableRange &a = ranges[p_a];
+			const LocalVariableRange &b = ranges[p_b];
+			if (a.start_line != b.start_line) {
+				return a.start_line < b.start_line;
+			}
+			if (a.end_line != b.end_line) {
+				return a.end_line > b.end_line;
+			}
+			return p_a < p_b;
+		}
+	};
 
-	bool operator<(const _GDFKCS &p_r) const {
-		return order < p_r.order;
+	const LocalVariableRange *ranges = local_ranges.ptr();
+	LocalVector<int> order;
+	order.resize(local_ranges.size());
+	for (int i = 0; i < local_ranges.size(); i++) {
+		order[i] = i;
+	}
+	order.sort_custom<RangeOrder>(ranges);
+
+	local_range_parents.resize(local_ranges.size());
+	int *parents = local_range_parents.ptrw();
+	LocalVector<int> stack;
+	for (const int index : order) {
+		const LocalVariableRange &range = ranges[index];
+		parents[index] = -1;
+		if (range.start_line >= range.end_line) {
+			continue; // Never visible.
+		}
+		while (!stack.is_empty() && ranges[stack[stack.size() - 1]].end_line <= range.start_line) {
+			stack.resize(stack.size() - 1);
+		}
+		if (!stack.is_empty()) {
+			parents[index] = stack[stack.size() - 1];
+			if (range.end_line > ranges[parents[index]].end_line) {
+				// Overlapping without nesting: the visible locals are no longer a single chain.
+				local_ranges_nested = false;
+			}
+		}
+		stack.push_back(index);
 	}
-};
 
-void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const {
-	int oc = 0;
-	HashMap<StringName, _GDFKC> sdmap;
-	for (const StackDebug &sd : stack_debug) {
-		if (sd.line >= p_line) {
-			break;
+	if (!local_ranges_nested) {
+		local_range_parents.clear();
+		return;
+	}
+
+	// The visible set can only change where a range starts or ends being visible. Each segment
+	// records the innermost visible range; its enclosing ones follow from `local_range_parents`.
+	Vector<int> boundaries;
+	for (const LocalVariableRange &range : local_ranges) {
+		boundaries.push_back(range.start_line + 1);
+		if (range.end_line != INT32_MAX) {
+			boundaries.push_back(range.end_line + 1);
 		}
+	}
+	boundaries.sort();
+
+	stack.clear();
+	uint32_t next = 0;
+	for (int i = 0; i < boundaries.size(); i++) {
+		const int line = boundaries[i];
+		if (i > 0 && line == boundaries[i - 1]) {
+			continue;
+		}
+		while (!stack.is_empty() && ranges[stack[stack.size() - 1]].end_line < line) {
+			stack.resize(stack.size() - 1);
+		}
+		for (; next < order.size() && ranges[order[next]].start_line < line; next++) {
+			if (ranges[order[next]].start_line < ranges[order[next]].end_line) {
+				stack.push_back(order[next]);
+			}
+		}
+		local_segment_lines.push_back(line);
+		local_segment_ranges.push_back(stack.is_empty() ? -1 : stack[stack.size() - 1]);
+	}
+}
 
-		if (sd.added) {
-			if (!sdmap.has(sd.identifier)) {
-				_GDFKC d;
-				d.order = oc++;
-				d.pos.push_back(sd.pos);
-				sdmap[sd.identifier] = d;
+void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const {
+	LocalVector<int> visible;
+	if (!local_ranges_nested) {
+		for (int i = 0; i < local_ranges.size(); i++) {
+			if (local_ranges[i].start_line < p_line && p_line <= local_ranges[i].end_line) {
+				visible.push_back(i);
+			}
+		}
+	} else {
+		if (local_segment_lines.is_empty() || p_line < local_segment_lines[0]) {
+			return;
+		}
 
+		// Find the last segment starting at or before `p_line`.
+		int low = 0;
+		int high = local_segment_lines.size() - 1;
+		while (low < high) {
+			const int middle = (low + high + 1) / 2;
+			if (local_segment_lines[middle] <= p_line) {
+				low = middle;
 			} else {
-				sdmap[sd.identifier].pos.push_back(sd.pos);
+				high = middle - 1;
 			}
-		} else {
-			ERR_CONTINUE(!sdmap.has(sd.identifier));
+		}
 
-			sdmap[sd.identifier].pos.pop_back();
-			if (sdmap[sd.identifier].pos.is_empty()) {
-				sdmap.erase(sd.identifier);
-			}
+		for (int i = local_segment_ranges[low]; i != -1; i = local_range_parents[i]) {
+			visible.push_back(i);
 		}
+		visible.sort();
 	}
 
-	List<_GDFKCS> stackpositions;
-	for (const KeyValue<StringName, _GDFKC> &E : sdmap) {
-		_GDFKCS spp;
-		spp.id = E.key;
-		spp.order = E.value.order;
-		spp.pos = E.value.pos.back()->get();
-		stackpositions.push_back(spp);
+	// Ranges are in declaration order: outer scopes come first and keep their
+	// position in the listing, while inner declarations shadow their slot.
+	LocalVector<int> listing;
+	HashMap<StringName, uint32_t> positions;
+	for (const int index : visible) {
+		HashMap<StringName, uint32_t>::Iterator E = positions.find(local_ranges[index].identifier);
+		if (E) {
+			listing[E->value] = index;
+		} else {
+			positions.insert(local_ranges[index].identifier, listing.size());
+			listing.push_back(index);
+		}
+	}
+	for (const int index : listing) {
+		const LocalVariableRange &range = local_ranges[index];
+		r_stackvars->push_back(Pair<StringName, int>(range.identifier, range.slot));
 	}
+}
 
-	stackpositions.sort();
+#ifdef DEBUG_ENABLED
+void GDScriptFunction::_profile_mark_dirty() {
+	if (profile.frame_dirty.exchange(true)) {
+		return; // Another thread got here first.
+	}
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	MutexLock lock(language->profile_dirty_mutex);
+	language->profile_dirty_functions.push_back(this);
+}
 
-	for (_GDFKCS &E : stackpositions) {
-		Pair<StringName, int> p;
-		p.first = E.id;
-		p.second = E.pos;
-		r_stackvars->push_back(p);
+void GDScriptFunction::update_breakpoint_traps(const HashMap<int, HashSet<StringName>> &p_breakpoints) {
+	// Other threads may be running this code, swap each opcode with a single store they can't tear.
+	static_assert(sizeof(std::atomic<int>) == sizeof(int) && std::atomic<int>::is_always_lock_free);
+	for (const int &pos : line_opcodes) {
+		const HashMap<int, HashSet<StringName>>::ConstIterator E = p_breakpoints.find(_code_ptr[pos + 1]);
+		const int opcode = (E && E->value.has(source)) ? OPCODE_LINE_BREAKPOINT : OPCODE_LINE;
+		reinterpret_cast<std::atomic<int> *>(&_code_ptr[pos])->store(opcode, std::memory_order_relaxed);
 	}
 }
 
+String GDScriptFunction::_get_gds_utility_name(int p_index) const {
+	if (p_index < gds_utilities_names.size()) {
+		return gds_utilities_names[p_index];
+	}
+
+	// Names are dropped from lean bytecode, this only runs when reporting an error.
+	List<StringName> functions;
+	GDScriptUtilityFunctions::get_function_list(&functions);
+	for (const StringName &E : functions) {
+		if (GDScriptUtilityFunctions::get_function(E) == _gds_utilities_ptr[p_index]) {
+			return E;
+		}
+	}
+	return "<unknown>";
+}
+
+static int _get_debug_names_bytes(const Vector<String> &p_names) {
+	int bytes = p_names.size() * sizeof(String);
+	for (const String &name : p_names) {
+		bytes += (name.length() + 1) * sizeof(char32_t);
+	}
+	return bytes;
+}
+#endif
+
+void GDScriptFunction::BytecodeStats::accumulate(const BytecodeStats &p_other) {
+	code_bytes += p_other.code_bytes;
+	stack_size = MAX(stack_size, p_other.stack_size);
+	frame_bytes = MAX(frame_bytes, p_other.frame_bytes);
+	temporary_count += p_other.temporary_count;
+	constant_count += p_other.constant_count;
+	constant_bytes += p_other.constant_bytes;
+	global_name_count += p_other.global_name_count;
+	inline_cache_count += p_other.inline_cache_count;
+	inline_cache_bytes += p_other.inline_cache_bytes;
+	pointer_table_bytes += p_other.pointer_table_bytes;
+	debug_bytes += p_other.debug_bytes;
+}
+
+Dictionary GDScriptFunction::BytecodeStats::to_dictionary() const {
+	Dictionary dict;
+	dict["code_bytes"] = code_bytes;
+	dict["stack_size"] = stack_size;
+	dict["frame_bytes"] = frame_bytes;
+	dict["temporary_count"] = temporary_count;
+	dict["constant_count"] = constant_count;
+	dict["constant_bytes"] = constant_bytes;
+	dict["global_name_count"] = global_name_count;
+	dict["inline_cache_count"] = inline_cache_count;
+	dict["inline_cache_bytes"] = inline_cache_bytes;
+	dict["pointer_table_bytes"] = pointer_table_bytes;
+	dict["debug_bytes"] = debug_bytes;
+	dict["total_bytes"] = get_total_bytes();
+	return dict;
+}
+
+GDScriptFunction::BytecodeStats GDScriptFunction::get_bytecode_stats() const {
+	BytecodeStats stats;
+
+	stats.code_bytes = (_code_size + instruction_starts.size()) * sizeof(int);
+	stats.stack_size = _stack_size;
+	stats.frame_bytes = _stack_size * sizeof(Variant) + _instruction_args_size * sizeof(Variant *);
+	stats.temporary_count = _temporary_count;
+	stats.constant_count = _constant_count;
+	stats.global_name_count = _global_names_count;
+	stats.inline_cache_count = _inline_cache_count;
+	stats.inline_cache_bytes = _inline_cache_count * INLINE_CACHE_SLOTS * sizeof(int);
+
+	// Constants and global names live in the script's shared pool, see `GDScriptConstantPool::get_memory_usage()`.
+	stats.constant_bytes = default_arguments.size() * sizeof(int);
+
+	stats.pointer_table_bytes = (operator_funcs.size() + setters.size() + getters.size() + keyed_setters.size() + keyed_getters.size() +
+					indexed_setters.size() + indexed_getters.size() + builtin_methods.size() + constructors.size() +
+					utilities.size() + gds_utilities.size() + methods.size() + lambdas.size()) *
+					sizeof(void *);
+
+	stats.debug_bytes = local_ranges.size() * sizeof(LocalVariableRange) +
+			(local_range_parents.size() + local_segment_lines.size() + local_segment_ranges.size() + line_opcodes.size()) * sizeof(int);
+#ifdef DEBUG_ENABLED
+	stats.debug_bytes += func_cname.length() + 1;
+	stats.debug_bytes += _get_debug_names_bytes(operator_names) + _get_debug_names_bytes(setter_names) + _get_debug_names_bytes(getter_names) +
+			_get_debug_names_bytes(builtin_methods_names) + _get_debug_names_bytes(constructors_names) +
+			_get_debug_names_bytes(utilities_names) + _get_debug_names_bytes(gds_utilities_names);
+#endif
+
+	return stats;
+}
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -114,6 +451,26 @@ GDScriptFunction::GDScriptFunction() {
 #endif
 }
 
+int GDScriptFunction::_add_speculation(const Speculation &p_speculation) {
+	const uint32_t capacity = _inline_cache_count + _operator_cache_count + MAX_SPECULATION_FAILURES;
+	Speculation *speculations = _speculations.load(std::memory_order_acquire);
+	if (speculations == nullptr) {
+		Speculation *allocated = memnew_arr(Speculation, capacity);
+		if (_speculations.compare_exchange_strong(speculations, allocated, std::memory_order_acq_rel)) {
+			speculations = allocated;
+		} else {
+			memdelete_arr(allocated); // Another thread allocated first.
+		}
+	}
+
+	const uint32_t index = _speculation_count.postincrement();
+	if (index >= capacity) {
+		return 0;
+	}
+	speculations[index] = p_speculation;
+	return index + 1;
+}
+
 GDScriptFunction::~GDScriptFunction() {
 	get_script()->member_functions.erase(name);
 
@@ -126,7 +483,30 @@ GDScriptFunction::~GDScriptFunction() {
 	}
 	return_type.script_type_ref = Ref<Script>();
 
+	GDScriptJIT::Code *jit_code = _jit_code.load();
+	if (jit_code) {
+		memdelete(jit_code);
+	}
+
+	Speculation *speculations = _speculations.load();
+	if (speculations) {
+		memdelete_arr(speculations);
+	}
+
+	if (constant_pool) {
+		if (!constant_pool->finalized) {
+			constant_pool->functions.erase(this);
+		}
+		constant_pool->unreference();
+	}
+
 #ifdef DEBUG_ENABLED
+	if (profile.frame_dirty.load() || profile.reported_last_frame) {
+		MutexLock lock(GDScriptLanguage::get_singleton()->profile_dirty_mutex);
+		GDScriptLanguage::get_singleton()->profile_dirty_functions.erase(this);
+		GDScriptLanguage::get_singleton()->profile_last_frame_functions.erase(this);
+	}
+
 	MutexLock lock(GDScriptLanguage::get_singleton()->mutex);
 	GDScriptLanguage::get_singleton()->function_list.remove(&function_list);
 #endif
@@ -30,13 +30,17 @@
 
 #pragma once
 
+#include "gdscript_jit.h"
 #include "gdscript_utility_functions.h"
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
 
@@ -64,6 +68,11 @@ public:
 
 	_FORCE_INLINE_ bool has_type() const { return kind != VARIANT; }
 
+	// Constant time for native classes and between GDScripts, see `GDScriptLanguage::is_native_subclass()`
+	// and `GDScript::is_subclass_of()`. Scripts from other languages walk their base scripts.
+	static bool is_native_subtype(const StringName &p_class, const StringName &p_base);
+	static bool is_script_subtype(Script *p_script, const Script *p_base);
+
 	bool is_type(const Variant &p_variant, bool p_allow_implicit_conversion = false) const {
 		switch (kind) {
 			case VARIANT: {
@@ -144,10 +153,7 @@ public:
 					return !was_freed;
 				}
 
-				if (!ClassDB::is_parent_class(obj->get_class_name(), native_type)) {
-					return false;
-				}
-				return true;
+				return is_native_subtype(obj->get_class_name(), native_type);
 			} break;
 			case SCRIPT:
 			case GDSCRIPT: {
@@ -164,16 +170,8 @@ public:
 					return !was_freed;
 				}
 
-				Ref<Script> base = obj && obj->get_script_instance() ? obj->get_script_instance()->get_script() : nullptr;
-				bool valid = false;
-				while (base.is_valid()) {
-					if (base == script_type) {
-						valid = true;
-						break;
-					}
-					base = base->get_base_script();
-				}
-				return valid;
+				ScriptInstance *instance = obj->get_script_instance();
+				return instance && is_script_subtype(instance->get_script().ptr(), script_type);
 			} break;
 		}
 		return false;
@@ -260,6 +258,43 @@ public:
 	~GDScriptDataType() {}
 };
 
+class GDScriptFunction;
+
+// Deduplicated constants and global names shared by the bytecode of all the functions of a script.
+// The compiler creates a new pool on every compilation, so functions from before a reload keep
+// referencing the previous one until they are freed.
+class GDScriptConstantPool {
+	friend class GDScriptFunction;
+
+	SafeRefCount refcount;
+	bool finalized = false;
+
+	Vector<Variant> constants;
+	Vector<StringName> global_names;
+
+	// Only needed while compiling, cleared by `finalize()`.
+	HashMap<Variant, int, VariantHasher, VariantComparator> constant_map;
+	LocalVector<int> typed_containers; // Read-only typed arrays and dictionaries, compared with their element types.
+	HashMap<StringName, int> name_map;
+	LocalVector<GDScriptFunction *> functions;
+
+	static bool _is_same_typed_container(const Variant &p_a, const Variant &p_b);
+
+public:
+	int add_constant(const Variant &p_constant);
+	int add_global_name(const StringName &p_name);
+	void add_function(GDScriptFunction *p_function);
+	const LocalVector<GDScriptFunction *> &get_functions() const { return functions; }
+	void finalize();
+	void unreference();
+
+	int get_constant_count() const { return constants.size(); }
+	int get_global_name_count() const { return global_names.size(); }
+	int get_memory_usage() const;
+
+	GDScriptConstantPool() { refcount.init(); }
+};
+
 class GDScriptFunction {
 public:
 	enum Opcode {
@@ -275,11 +310,13 @@ public:
 		OPCODE_SET_INDEXED_VALIDATED,
 		OPCODE_GET_KEYED,
 		OPCODE_GET_KEYED_VALIDATED,
+		OPCODE_GET_DICTIONARY_KEY,
 		OPCODE_GET_INDEXED_VALIDATED,
 		OPCODE_SET_NAMED,
 		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
 		OPCODE_GET_NAMED_VALIDATED,
+		OPCODE_GET_NAMED_SPECULATED, // Same layout as `OPCODE_GET_NAMED`, see `SPECULATION_THRESHOLD`.
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_SET_STATIC_VARIABLE, // Only for GDScript.
@@ -300,11 +337,15 @@ public:
 		OPCODE_CONSTRUCT_VALIDATED, // Only for basic types!
 		OPCODE_CONSTRUCT_ARRAY,
 		OPCODE_CONSTRUCT_TYPED_ARRAY,
+		OPCODE_CONSTRUCT_SCRATCH_ARRAY,
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CONSTRUCT_TYPED_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
 		OPCODE_CALL_ASYNC,
+		OPCODE_CALL_SCRIPT,
+		OPCODE_CALL_SCRIPT_RETURN,
+		OPCODE_CALL_BUILTIN_SPECULATED, // Same layout as `OPCODE_CALL(_RETURN)`, see `SPECULATION_THRESHOLD`.
 		OPCODE_CALL_UTILITY,
 		OPCODE_CALL_UTILITY_VALIDATED,
 		OPCODE_CALL_GDSCRIPT_UTILITY,
@@ -420,6 +461,7 @@ public:
 		OPCODE_ASSERT,
 		OPCODE_BREAKPOINT,
 		OPCODE_LINE,
+		OPCODE_LINE_BREAKPOINT, // `OPCODE_LINE` patched in place while a breakpoint is set on its line.
 		OPCODE_END
 	};
 
@@ -443,6 +485,50 @@ public:
 		ADDR_NIL = ADDR_STACK_NIL | (ADDR_TYPE_STACK << ADDR_BITS),
 	};
 
+	// Size in ints of the polymorphic inline cache following property accesses and method calls:
+	// 4 entries of a cached class and a cached target pointer.
+	static constexpr int INLINE_CACHE_SLOTS = 4 * 2 * (sizeof(void *) / sizeof(int));
+
+	// Untyped operators, property reads and method calls record the operand or receiver types they see.
+	// After that many consecutive executions with the same built-in types, the site is rewritten in place
+	// into a version guarded on them which uses the validated evaluator, getter or method.
+	// A failed guard puts the generic opcode back, and after too many failures the function stops speculating.
+	static constexpr int SPECULATION_THRESHOLD = 64;
+	static constexpr uint32_t MAX_SPECULATION_FAILURES = 32;
+
+	// What a speculated site checks and calls. Immutable once published, and kept until the function
+	// is freed, since other threads may still be running with it after the site deoptimized.
+	struct Speculation {
+		Variant::Type receiver_type = Variant::NIL;
+		Variant::Type return_type = Variant::NIL;
+		bool call_return = false;
+		bool is_const = true; // Callable on read-only receivers.
+		uint32_t argument_types = 0; // 8 bits each, `NIL` accepting any.
+		Variant::ValidatedGetter getter = nullptr;
+		Variant::ValidatedBuiltInMethod method = nullptr;
+		// For operators, the receiver is the left operand and the single argument the right one.
+		Variant::ValidatedOperatorEvaluator operator_evaluator = nullptr;
+	};
+
+	// Memory used by a compiled function, see `get_bytecode_stats()`.
+	struct BytecodeStats {
+		int code_bytes = 0; // Including inline caches.
+		int stack_size = 0; // In slots, including locals and temporaries.
+		int frame_bytes = 0; // Allocated on each call: stack and instruction arguments.
+		int temporary_count = 0;
+		int constant_count = 0;
+		int constant_bytes = 0;
+		int global_name_count = 0;
+		int inline_cache_count = 0;
+		int inline_cache_bytes = 0; // Part of `code_bytes`.
+		int pointer_table_bytes = 0; // Global names, validated operators, setters, getters, calls...
+		int debug_bytes = 0; // Local variable scopes, line positions and debug names.
+
+		int get_total_bytes() const { return code_bytes + constant_bytes + pointer_table_bytes + debug_bytes; }
+		void accumulate(const BytecodeStats &p_other);
+		Dictionary to_dictionary() const;
+	};
+
 	struct StackDebug {
 		int line;
 		int pos;
@@ -450,11 +536,28 @@ public:
 		StringName identifier;
 	};
 
+	// A local variable as seen by the debugger: its stack slot and the lines
+	// in which it is in scope, i.e. `start_line < line <= end_line`.
+	struct LocalVariableRange {
+		StringName identifier;
+		int slot = 0;
+		int start_line = 0;
+		int end_line = INT32_MAX;
+	};
+
+	// Entry point of a function compiled ahead of time, see `GDScriptNativeFunctions`.
+	// Runs from `p_ip` and returns the position of the instruction the interpreter continues from.
+	typedef int (*NativeFunction)(GDScriptJIT::Frame *p_frame, int p_ip);
+
 private:
 	friend class GDScript;
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptConstantPool;
 	friend class GDScriptLanguage;
+	friend class GDScriptJIT;
+	friend class GDScriptNativeFunctions;
+	friend class GDScriptCppCodeGenerator;
 
 	StringName name;
 	StringName source;
@@ -468,18 +571,45 @@ private:
 	int _initial_line = 0;
 	int _argument_count = 0;
 	int _vararg_index = -1;
+	uint64_t _borrowable_args = 0; // Parameters the body never writes to, see `call()`.
+	SafeNumeric<uint32_t> _speculation_failures; // See `SPECULATION_THRESHOLD`.
+	// Indexed from the inline caches and untyped operators, allocated with one entry per site plus
+	// `MAX_SPECULATION_FAILURES` on the first speculation: a site needs a failure before speculating again.
+	std::atomic<Speculation *> _speculations{ nullptr };
+	SafeNumeric<uint32_t> _speculation_count;
+	int _add_speculation(const Speculation &p_speculation); // Returns the index + 1, or 0 if full.
+	_FORCE_INLINE_ const Speculation *_get_speculation(int p_index) const {
+		return p_index > 0 ? &_speculations.load(std::memory_order_acquire)[p_index - 1] : nullptr;
+	}
+	SafeNumeric<uint32_t> _jit_call_count;
+	std::atomic<GDScriptJIT::Code *> _jit_code{ nullptr }; // Compiled once the call count reaches the JIT threshold.
+	NativeFunction _native_function = nullptr;
 	int _stack_size = 0;
+	int _temporary_count = 0;
 	int _instruction_args_size = 0;
+	int _inline_cache_count = 0;
+	int _operator_cache_count = 0; // Untyped operators, which speculate on their operand types.
 
 	SelfList<GDScriptFunction> function_list{ this };
 	mutable Variant nil;
 	HashMap<int, Variant::Type> temporary_slots;
-	List<StackDebug> stack_debug;
+
+	// Local variable scopes, compiled from the `StackDebug` events emitted by the code generator.
+	// Scopes nest, so the locals visible at a line form a chain: `local_range_parents` links each
+	// range to the innermost range enclosing it, and `local_segment_ranges[i]` is the innermost range
+	// visible from `local_segment_lines[i]` on, or -1. If ranges overlap without nesting,
+	// `local_ranges_nested` is false and lookups scan `local_ranges` instead.
+	Vector<LocalVariableRange> local_ranges;
+	Vector<int> local_range_parents;
+	Vector<int> local_segment_lines;
+	Vector<int> local_segment_ranges;
+	bool local_ranges_nested = true;
+
+	void _build_local_variable_table(const List<StackDebug> &p_stack_debug);
 
 	Vector<int> code;
 	Vector<int> default_arguments;
-	Vector<Variant> constants;
-	Vector<StringName> global_names;
+	GDScriptConstantPool *constant_pool = nullptr;
 	Vector<Variant::ValidatedOperatorEvaluator> operator_funcs;
 	Vector<Variant::ValidatedSetter> setters;
 	Vector<Variant::ValidatedGetter> getters;
@@ -493,6 +623,8 @@ private:
 	Vector<GDScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
+	Vector<int> line_opcodes; // Code positions of all `OPCODE_LINE`, used to patch in breakpoint traps.
+	Vector<int> instruction_starts; // Code positions of all instructions, only recorded when the JIT is enabled.
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -558,14 +690,28 @@ private:
 			uint64_t total_time;
 			String signature;
 		} NativeProfile;
-		HashMap<String, NativeProfile> native_calls;
-		HashMap<String, NativeProfile> last_native_calls;
+		// Double-buffered, swapped on each frame.
+		HashMap<String, NativeProfile> native_calls_buffers[2];
+		HashMap<String, NativeProfile> *native_calls = &native_calls_buffers[0];
+		HashMap<String, NativeProfile> *last_native_calls = &native_calls_buffers[1];
+		std::atomic<bool> frame_dirty{ false }; // In `GDScriptLanguage::profile_dirty_functions`.
+		bool reported_last_frame = false; // In `GDScriptLanguage::profile_last_frame_functions`.
 	} profile;
+
+	_FORCE_INLINE_ void _profile_touch() {
+		if (unlikely(!profile.frame_dirty.load(std::memory_order_relaxed))) {
+			_profile_mark_dirty();
+		}
+	}
+	void _profile_mark_dirty();
+
+	String _get_gds_utility_name(int p_index) const;
 #endif
 
 	String _get_call_error(const String &p_where, const Variant **p_argptrs, int p_argcount, const Variant &p_ret, const Callable::CallError &p_err) const;
 	String _get_callable_call_error(const String &p_where, const Callable &p_callable, const Variant **p_argptrs, int p_argcount, const Variant &p_ret, const Callable::CallError &p_err) const;
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
+	const GDScriptJIT::Code *_get_jit_code(const GDScriptInstance *p_instance);
 
 public:
 	static constexpr int MAX_CALL_DEPTH = 2048; // Limit to try to avoid crash because of a stack overflow.
@@ -591,6 +737,7 @@ public:
 	_FORCE_INLINE_ GDScript *get_script() const { return _script; }
 	_FORCE_INLINE_ bool is_static() const { return _static; }
 	_FORCE_INLINE_ bool is_vararg() const { return _vararg_index >= 0; }
+	_FORCE_INLINE_ uint64_t get_borrowable_args() const { return _borrowable_args; }
 	_FORCE_INLINE_ MethodInfo get_method_info() const { return method_info; }
 	_FORCE_INLINE_ int get_argument_count() const { return _argument_count; }
 	_FORCE_INLINE_ Variant get_rpc_config() const { return rpc_config; }
@@ -598,11 +745,17 @@ public:
 
 	Variant get_constant(int p_idx) const;
 	StringName get_global_name(int p_idx) const;
+	_FORCE_INLINE_ const GDScriptConstantPool *get_constant_pool() const { return constant_pool; }
 
-	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
+	// `p_borrowed_args` flags arguments the caller keeps alive and unchanged for the whole call, so
+	// read-only parameters can share them without touching reference counts.
+	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr, uint64_t p_borrowed_args = 0);
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
+	_FORCE_INLINE_ const Vector<LocalVariableRange> &debug_get_local_ranges() const { return local_ranges; }
+	BytecodeStats get_bytecode_stats() const;
 
 #ifdef DEBUG_ENABLED
+	void update_breakpoint_traps(const HashMap<int, HashSet<StringName>> &p_breakpoints);
 	void _profile_native_call(uint64_t p_t_taken, const String &p_function_name, const String &p_instance_class_name = String());
 	void disassemble(const Vector<String> &p_code_lines) const;
 #endif
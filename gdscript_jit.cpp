@@ -0,0 +1,1092 @@
+/**************************************************************************/
+/*  gdscript_jit.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_jit.h"
+
+#include "gdscript_function.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/variant/variant_internal.h"
+
+// Only System V (x86-64) and AAPCS64 calling conventions are emitted, and
+// executable memory is mapped with POSIX calls.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define GDSCRIPT_JIT_ENABLED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+// Helpers called by the templates. They do what the interpreter does for the same instruction.
+// Those returning `false` leave everything as it was, so the interpreter can run the instruction
+// again and report the error.
+
+static void _assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+static void _assign_null(Variant *p_dst) {
+	*p_dst = Variant();
+}
+
+static void _assign_true(Variant *p_dst) {
+	*p_dst = true;
+}
+
+static void _assign_false(Variant *p_dst) {
+	*p_dst = false;
+}
+
+static bool _assign_typed_builtin(Variant *p_dst, Variant *p_src, Variant::Type p_type) {
+	if (p_src->get_type() == p_type) {
+		*p_dst = *p_src;
+		return true;
+	}
+#ifdef DEBUG_ENABLED
+	if (!Variant::can_convert_strict(p_src->get_type(), p_type)) {
+		return false;
+	}
+#endif
+	Callable::CallError ce;
+	Variant::construct(p_type, *p_dst, const_cast<const Variant **>(&p_src), 1, ce);
+	return true;
+}
+
+static bool _evaluate(const Variant *p_a, const Variant *p_b, Variant *p_dst, Variant::Operator p_op) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+	Variant ret;
+	Variant::evaluate(p_op, *p_a, *p_b, ret, valid);
+	if (!valid) {
+		return false;
+	}
+	*p_dst = ret;
+#else
+	Variant::evaluate(p_op, *p_a, *p_b, *p_dst, valid);
+#endif
+	return true;
+}
+
+static bool _booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+static bool _set_keyed(Variant::ValidatedKeyedSetter p_setter, Variant *p_dst, const Variant *p_key, const Variant *p_value) {
+	bool valid;
+	p_setter(p_dst, p_key, p_value, &valid);
+#ifdef DEBUG_ENABLED
+	return valid;
+#else
+	return true;
+#endif
+}
+
+static bool _get_keyed(Variant::ValidatedKeyedGetter p_getter, const Variant *p_src, const Variant *p_key, Variant *p_dst) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+	Variant ret;
+	p_getter(p_src, p_key, &ret, &valid);
+	if (!valid) {
+		return false;
+	}
+	*p_dst = ret;
+	return true;
+#else
+	p_getter(p_src, p_key, p_dst, &valid);
+	return true;
+#endif
+}
+
+static bool _set_indexed(Variant::ValidatedIndexedSetter p_setter, Variant *p_dst, const Variant *p_index, const Variant *p_value) {
+	bool oob;
+	p_setter(p_dst, *VariantInternal::get_int(p_index), p_value, &oob);
+#ifdef DEBUG_ENABLED
+	return !oob;
+#else
+	return true;
+#endif
+}
+
+static bool _get_indexed(Variant::ValidatedIndexedGetter p_getter, const Variant *p_src, const Variant *p_index, Variant *p_dst) {
+	bool oob;
+	p_getter(p_src, *VariantInternal::get_int(p_index), p_dst, &oob);
+#ifdef DEBUG_ENABLED
+	return !oob;
+#else
+	return true;
+#endif
+}
+
+static void _return(GDScriptJIT::Frame *p_frame, const Variant *p_value) {
+	*p_frame->retvalue = *p_value;
+}
+
+static bool _return_typed_builtin(GDScriptJIT::Frame *p_frame, Variant *p_value, Variant::Type p_type) {
+	if (p_value->get_type() == p_type) {
+		*p_frame->retvalue = *p_value;
+		return true;
+	}
+	if (!Variant::can_convert_strict(p_value->get_type(), p_type)) {
+		return false;
+	}
+	Callable::CallError ce;
+	Variant::construct(p_type, *p_frame->retvalue, const_cast<const Variant **>(&p_value), 1, ce);
+	return true;
+}
+
+// The iteration helpers return whether the loop body runs.
+
+static bool _iterate_begin_int(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	const int64_t size = *VariantInternal::get_int(p_container);
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = 0;
+	if (size <= 0) {
+		return false;
+	}
+	VariantInternal::initialize(p_iterator, Variant::INT);
+	*VariantInternal::get_int(p_iterator) = 0;
+	return true;
+}
+
+static bool _iterate_int(Variant *p_counter, const Variant *p_container, Variant *p_iterator) {
+	const int64_t size = *VariantInternal::get_int(p_container);
+	int64_t *count = VariantInternal::get_int(p_counter);
+	(*count)++;
+	if (*count >= size) {
+		return false;
+	}
+	*VariantInternal::get_int(p_iterator) = *count;
+	return true;
+}
+
+static bool _iterate_begin_range(Variant *p_counter, const Variant *p_from, const Variant *p_to, const Variant *p_step, Variant *p_iterator) {
+	const int64_t from = *VariantInternal::get_int(p_from);
+	const int64_t to = *VariantInternal::get_int(p_to);
+	const int64_t step = *VariantInternal::get_int(p_step);
+	VariantInternal::initialize(p_counter, Variant::INT);
+	*VariantInternal::get_int(p_counter) = from;
+	if (from == to ? true : (from < to ? step <= 0 : step >= 0)) {
+		return false;
+	}
+	VariantInternal::initialize(p_iterator, Variant::INT);
+	*VariantInternal::get_int(p_iterator) = from;
+	return true;
+}
+
+static bool _iterate_range(Variant *p_counter, const Variant *p_to, const Variant *p_step, Variant *p_iterator) {
+	const int64_t to = *VariantInternal::get_int(p_to);
+	const int64_t step = *VariantInternal::get_int(p_step);
+	int64_t *count = VariantInternal::get_int(p_counter);
+	*count += step;
+	if ((step < 0 && *count <= to) || (step > 0 && *count >= to)) {
+		return false;
+	}
+	*VariantInternal::get_int(p_iterator) = *count;
+	return true;
+}
+
+template <typename T>
+static void _type_adjust(Variant *p_value) {
+	VariantTypeAdjust<T>::adjust(p_value);
+}
+
+// Indexed by `opcode - OPCODE_TYPE_ADJUST_BOOL`.
+static void (*const type_adjust_functions[])(Variant *) = {
+	&_type_adjust<bool>,
+	&_type_adjust<int64_t>,
+	&_type_adjust<double>,
+	&_type_adjust<String>,
+	&_type_adjust<Vector2>,
+	&_type_adjust<Vector2i>,
+	&_type_adjust<Rect2>,
+	&_type_adjust<Rect2i>,
+	&_type_adjust<Vector3>,
+	&_type_adjust<Vector3i>,
+	&_type_adjust<Transform2D>,
+	&_type_adjust<Vector4>,
+	&_type_adjust<Vector4i>,
+	&_type_adjust<Plane>,
+	&_type_adjust<Quaternion>,
+	&_type_adjust<AABB>,
+	&_type_adjust<Basis>,
+	&_type_adjust<Transform3D>,
+	&_type_adjust<Projection>,
+	&_type_adjust<Color>,
+	&_type_adjust<StringName>,
+	&_type_adjust<NodePath>,
+	&_type_adjust<RID>,
+	&_type_adjust<Object *>,
+	&_type_adjust<Callable>,
+	&_type_adjust<Signal>,
+	&_type_adjust<Dictionary>,
+	&_type_adjust<Array>,
+	&_type_adjust<PackedByteArray>,
+	&_type_adjust<PackedInt32Array>,
+	&_type_adjust<PackedInt64Array>,
+	&_type_adjust<PackedFloat32Array>,
+	&_type_adjust<PackedFloat64Array>,
+	&_type_adjust<PackedStringArray>,
+	&_type_adjust<PackedVector2Array>,
+	&_type_adjust<PackedVector3Array>,
+	&_type_adjust<PackedColorArray>,
+	&_type_adjust<PackedVector4Array>,
+};
+
+static_assert(sizeof(type_adjust_functions) / sizeof(type_adjust_functions[0]) == GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL + 1, "Type adjust templates don't match the opcodes.");
+
+// Emits the templates. While running compiled code, callee-saved registers hold the base of the stack,
+// the constants, the members, the frame and the instruction arguments, so an operand address is
+// computed with a single addition. The code starts with the prologue, which jumps to the template
+// given as second argument, followed by the epilogue, which returns the value in the result register.
+class GDScriptJITAssembler {
+	LocalVector<uint8_t> bytes;
+	uint32_t exit_offset = 0;
+
+	void emit8(uint8_t p_byte) { bytes.push_back(p_byte); }
+	void emit32(uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			bytes.push_back((p_value >> (i * 8)) & 0xFF);
+		}
+	}
+	void emit64(uint64_t p_value) {
+		emit32(p_value & 0xFFFFFFFF);
+		emit32(p_value >> 32);
+	}
+	uint32_t read32(uint32_t p_offset) const {
+		uint32_t value = 0;
+		for (int i = 0; i < 4; i++) {
+			value |= uint32_t(bytes[p_offset + i]) << (i * 8);
+		}
+		return value;
+	}
+	void write32(uint32_t p_offset, uint32_t p_value) {
+		for (int i = 0; i < 4; i++) {
+			bytes[p_offset + i] = (p_value >> (i * 8)) & 0xFF;
+		}
+	}
+
+	static int _get_base_register(int p_address);
+
+	void _load_address(int p_register, int p_address);
+	void _load_register(int p_register, int p_source);
+	void _load_int(int p_register, uint32_t p_value);
+	void _load_pointer(int p_register, uint64_t p_value);
+
+public:
+	static const int ARGUMENT_REGISTERS[];
+
+	_FORCE_INLINE_ uint32_t get_offset() const { return bytes.size(); }
+	_FORCE_INLINE_ const LocalVector<uint8_t> &get_bytes() const { return bytes; }
+
+	void write_prologue();
+
+	// Arguments of the next call.
+	void write_address_argument(int p_arg, int p_address) { _load_address(ARGUMENT_REGISTERS[p_arg], p_address); }
+	void write_int_argument(int p_arg, int p_value) { _load_int(ARGUMENT_REGISTERS[p_arg], p_value); }
+	void write_pointer_argument(int p_arg, const void *p_pointer) { _load_pointer(ARGUMENT_REGISTERS[p_arg], (uint64_t)p_pointer); }
+	void write_frame_argument(int p_arg);
+	void write_instruction_args_argument(int p_arg);
+
+	void write_instruction_arg(int p_slot, int p_address);
+	void write_call(const void *p_function);
+	void write_line(int p_line);
+	// Returns to the interpreter, which continues from `p_ip`.
+	void write_leave(int p_ip);
+
+	// These return where to patch the jump destination.
+	uint32_t write_jump();
+	uint32_t write_jump_if_result(bool p_value);
+	void patch_jump(uint32_t p_site, uint32_t p_target);
+};
+
+#if defined(__x86_64__)
+
+enum {
+	X86_RAX = 0,
+	X86_RCX = 1,
+	X86_RDX = 2,
+	X86_RBX = 3, // Stack.
+	X86_RSI = 6,
+	X86_RDI = 7,
+	X86_R8 = 8,
+	X86_R9 = 9,
+	X86_R12 = 12, // Members.
+	X86_R13 = 13, // Frame.
+	X86_R14 = 14, // Instruction arguments.
+	X86_R15 = 15, // Constants.
+};
+
+const int GDScriptJITAssembler::ARGUMENT_REGISTERS[] = { X86_RDI, X86_RSI, X86_RDX, X86_RCX, X86_R8, X86_R9 };
+
+int GDScriptJITAssembler::_get_base_register(int p_address) {
+	switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+		case GDScriptFunction::ADDR_TYPE_CONSTANT:
+			return X86_R15;
+		case GDScriptFunction::ADDR_TYPE_MEMBER:
+			return X86_R12;
+		default:
+			return X86_RBX;
+	}
+}
+
+void GDScriptJITAssembler::_load_address(int p_register, int p_address) {
+	// lea reg, [base + disp32]
+	const int base = _get_base_register(p_address);
+	emit8(0x48 | ((p_register >> 3) << 2) | (base >> 3));
+	emit8(0x8D);
+	emit8(0x80 | ((p_register & 7) << 3) | (base & 7));
+	if ((base & 7) == 4) {
+		emit8(0x24); // SIB byte, needed with r12 as base.
+	}
+	emit32((p_address & GDScriptFunction::ADDR_MASK) * sizeof(Variant));
+}
+
+void GDScriptJITAssembler::_load_register(int p_register, int p_source) {
+	// mov reg, source
+	emit8(0x48 | ((p_source >> 3) << 2) | (p_register >> 3));
+	emit8(0x89);
+	emit8(0xC0 | ((p_source & 7) << 3) | (p_register & 7));
+}
+
+void GDScriptJITAssembler::_load_int(int p_register, uint32_t p_value) {
+	// mov reg32, imm32
+	if (p_register >= 8) {
+		emit8(0x41);
+	}
+	emit8(0xB8 | (p_register & 7));
+	emit32(p_value);
+}
+
+void GDScriptJITAssembler::_load_pointer(int p_register, uint64_t p_value) {
+	// mov reg, imm64
+	emit8(0x48 | (p_register >> 3));
+	emit8(0xB8 | (p_register & 7));
+	emit64(p_value);
+}
+
+void GDScriptJITAssembler::write_prologue() {
+	// Five pushes after the return address keep the stack 16 bytes aligned for calls.
+	emit8(0x53); // push rbx
+	emit8(0x41);
+	emit8(0x54); // push r12
+	emit8(0x41);
+	emit8(0x55); // push r13
+	emit8(0x41);
+	emit8(0x56); // push r14
+	emit8(0x41);
+	emit8(0x57); // push r15
+	_load_register(X86_R13, X86_RDI);
+
+	const struct {
+		int reg;
+		size_t offset;
+	} loads[] = {
+		{ X86_RBX, offsetof(GDScriptJIT::Frame, stack) },
+		{ X86_R15, offsetof(GDScriptJIT::Frame, constants) },
+		{ X86_R12, offsetof(GDScriptJIT::Frame, members) },
+		{ X86_R14, offsetof(GDScriptJIT::Frame, instruction_args) },
+	};
+	for (const auto &load : loads) {
+		// mov reg, [r13 + disp8]
+		emit8(0x49 | ((load.reg >> 3) << 2));
+		emit8(0x8B);
+		emit8(0x40 | ((load.reg & 7) << 3) | (X86_R13 & 7));
+		emit8(load.offset);
+	}
+	emit8(0xFF);
+	emit8(0xE6); // jmp rsi
+
+	exit_offset = get_offset();
+	emit8(0x41);
+	emit8(0x5F); // pop r15
+	emit8(0x41);
+	emit8(0x5E); // pop r14
+	emit8(0x41);
+	emit8(0x5D); // pop r13
+	emit8(0x41);
+	emit8(0x5C); // pop r12
+	emit8(0x5B); // pop rbx
+	emit8(0xC3); // ret
+}
+
+void GDScriptJITAssembler::write_frame_argument(int p_arg) {
+	_load_register(ARGUMENT_REGISTERS[p_arg], X86_R13);
+}
+
+void GDScriptJITAssembler::write_instruction_args_argument(int p_arg) {
+	_load_register(ARGUMENT_REGISTERS[p_arg], X86_R14);
+}
+
+void GDScriptJITAssembler::write_instruction_arg(int p_slot, int p_address) {
+	_load_address(X86_RAX, p_address);
+	// mov [r14 + disp32], rax
+	emit8(0x49);
+	emit8(0x89);
+	emit8(0x86);
+	emit32(p_slot * sizeof(Variant *));
+}
+
+void GDScriptJITAssembler::write_call(const void *p_function) {
+	_load_pointer(X86_RAX, (uint64_t)p_function);
+	emit8(0xFF);
+	emit8(0xD0); // call rax
+}
+
+void GDScriptJITAssembler::write_line(int p_line) {
+	// mov rax, [r13 + disp8]
+	emit8(0x49);
+	emit8(0x8B);
+	emit8(0x45);
+	emit8(offsetof(GDScriptJIT::Frame, line));
+	// mov dword [rax], imm32
+	emit8(0xC7);
+	emit8(0x00);
+	emit32(p_line);
+}
+
+void GDScriptJITAssembler::write_leave(int p_ip) {
+	_load_int(X86_RAX, p_ip);
+	patch_jump(write_jump(), exit_offset);
+}
+
+uint32_t GDScriptJITAssembler::write_jump() {
+	emit8(0xE9); // jmp rel32
+	const uint32_t site = get_offset();
+	emit32(0);
+	return site;
+}
+
+uint32_t GDScriptJITAssembler::write_jump_if_result(bool p_value) {
+	// Only the low byte of a returned `bool` is defined.
+	emit8(0x84);
+	emit8(0xC0); // test al, al
+	emit8(0x0F);
+	emit8(p_value ? 0x85 : 0x84); // jnz/jz rel32
+	const uint32_t site = get_offset();
+	emit32(0);
+	return site;
+}
+
+void GDScriptJITAssembler::patch_jump(uint32_t p_site, uint32_t p_target) {
+	write32(p_site, int32_t(p_target) - int32_t(p_site + 4));
+}
+
+#elif defined(__aarch64__)
+
+enum {
+	A64_X9 = 9, // Scratch.
+	A64_X10 = 10, // Scratch.
+	A64_X16 = 16, // Call target.
+	A64_X19 = 19, // Stack.
+	A64_X20 = 20, // Constants.
+	A64_X21 = 21, // Members.
+	A64_X22 = 22, // Frame.
+	A64_X23 = 23, // Instruction arguments.
+};
+
+const int GDScriptJITAssembler::ARGUMENT_REGISTERS[] = { 0, 1, 2, 3, 4, 5 };
+
+int GDScriptJITAssembler::_get_base_register(int p_address) {
+	switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+		case GDScriptFunction::ADDR_TYPE_CONSTANT:
+			return A64_X20;
+		case GDScriptFunction::ADDR_TYPE_MEMBER:
+			return A64_X21;
+		default:
+			return A64_X19;
+	}
+}
+
+void GDScriptJITAssembler::_load_address(int p_register, int p_address) {
+	const int base = _get_base_register(p_address);
+	const uint32_t offset = (p_address & GDScriptFunction::ADDR_MASK) * sizeof(Variant);
+	if (offset < 4096) {
+		emit32(0x91000000 | (offset << 10) | (base << 5) | p_register); // add reg, base, #offset
+	} else {
+		_load_pointer(A64_X9, offset);
+		emit32(0x8B000000 | (A64_X9 << 16) | (base << 5) | p_register); // add reg, base, x9
+	}
+}
+
+void GDScriptJITAssembler::_load_register(int p_register, int p_source) {
+	emit32(0xAA0003E0 | (p_source << 16) | p_register); // mov reg, source
+}
+
+void GDScriptJITAssembler::_load_int(int p_register, uint32_t p_value) {
+	emit32(0x52800000 | ((p_value & 0xFFFF) << 5) | p_register); // movz wreg, #imm16
+	if (p_value >> 16) {
+		emit32(0x72800000 | (1 << 21) | ((p_value >> 16) << 5) | p_register); // movk wreg, #imm16, lsl #16
+	}
+}
+
+void GDScriptJITAssembler::_load_pointer(int p_register, uint64_t p_value) {
+	emit32(0xD2800000 | ((p_value & 0xFFFF) << 5) | p_register); // movz reg, #imm16
+	for (int hw = 1; hw < 4; hw++) {
+		const uint32_t chunk = (p_value >> (hw * 16)) & 0xFFFF;
+		if (chunk) {
+			emit32(0xF2800000 | (hw << 21) | (chunk << 5) | p_register); // movk reg, #imm16, lsl #(16 * hw)
+		}
+	}
+}
+
+void GDScriptJITAssembler::write_prologue() {
+	emit32(0xA9800000 | ((-8 & 0x7F) << 15) | (30 << 10) | (31 << 5) | 29); // stp x29, x30, [sp, #-64]!
+	emit32(0x910003FD); // mov x29, sp
+	emit32(0xA9000000 | (2 << 15) | (20 << 10) | (31 << 5) | 19); // stp x19, x20, [sp, #16]
+	emit32(0xA9000000 | (4 << 15) | (22 << 10) | (31 << 5) | 21); // stp x21, x22, [sp, #32]
+	emit32(0xA9000000 | (6 << 15) | (24 << 10) | (31 << 5) | 23); // stp x23, x24, [sp, #48]
+	_load_register(A64_X22, 0);
+
+	const struct {
+		int reg;
+		size_t offset;
+	} loads[] = {
+		{ A64_X19, offsetof(GDScriptJIT::Frame, stack) },
+		{ A64_X20, offsetof(GDScriptJIT::Frame, constants) },
+		{ A64_X21, offsetof(GDScriptJIT::Frame, members) },
+		{ A64_X23, offsetof(GDScriptJIT::Frame, instruction_args) },
+	};
+	for (const auto &load : loads) {
+		emit32(0xF9400000 | ((load.offset / 8) << 10) | (A64_X22 << 5) | load.reg); // ldr reg, [x22, #offset]
+	}
+	emit32(0xD61F0020); // br x1
+
+	exit_offset = get_offset();
+	emit32(0xA9400000 | (6 << 15) | (24 << 10) | (31 << 5) | 23); // ldp x23, x24, [sp, #48]
+	emit32(0xA9400000 | (4 << 15) | (22 << 10) | (31 << 5) | 21); // ldp x21, x22, [sp, #32]
+	emit32(0xA9400000 | (2 << 15) | (20 << 10) | (31 << 5) | 19); // ldp x19, x20, [sp, #16]
+	emit32(0xA8C00000 | (8 << 15) | (30 << 10) | (31 << 5) | 29); // ldp x29, x30, [sp], #64
+	emit32(0xD65F03C0); // ret
+}
+
+void GDScriptJITAssembler::write_frame_argument(int p_arg) {
+	_load_register(ARGUMENT_REGISTERS[p_arg], A64_X22);
+}
+
+void GDScriptJITAssembler::write_instruction_args_argument(int p_arg) {
+	_load_register(ARGUMENT_REGISTERS[p_arg], A64_X23);
+}
+
+void GDScriptJITAssembler::write_instruction_arg(int p_slot, int p_address) {
+	_load_address(A64_X10, p_address);
+	emit32(0xF9000000 | (p_slot << 10) | (A64_X23 << 5) | A64_X10); // str x10, [x23, #(slot * 8)]
+}
+
+void GDScriptJITAssembler::write_call(const void *p_function) {
+	_load_pointer(A64_X16, (uint64_t)p_function);
+	emit32(0xD63F0200); // blr x16
+}
+
+void GDScriptJITAssembler::write_line(int p_line) {
+	emit32(0xF9400000 | ((offsetof(GDScriptJIT::Frame, line) / 8) << 10) | (A64_X22 << 5) | A64_X9); // ldr x9, [x22, #offset]
+	_load_int(A64_X10, p_line);
+	emit32(0xB9000000 | (A64_X9 << 5) | A64_X10); // str w10, [x9]
+}
+
+void GDScriptJITAssembler::write_leave(int p_ip) {
+	_load_int(0, p_ip);
+	patch_jump(write_jump(), exit_offset);
+}
+
+uint32_t GDScriptJITAssembler::write_jump() {
+	const uint32_t site = get_offset();
+	emit32(0x14000000); // b
+	return site;
+}
+
+uint32_t GDScriptJITAssembler::write_jump_if_result(bool p_value) {
+	// Only the low byte of a returned `bool` is defined. Conditional branches have a shorter range, so skip over a `b`.
+	emit32(0x72001C1F); // tst w0, #0xff
+	emit32(p_value ? 0x54000040 : 0x54000041); // b.eq/b.ne #8
+	return write_jump();
+}
+
+void GDScriptJITAssembler::patch_jump(uint32_t p_site, uint32_t p_target) {
+	const int32_t words = (int32_t(p_target) - int32_t(p_site)) / 4;
+	write32(p_site, read32(p_site) | (words & 0x3FFFFFF));
+}
+
+#endif // __aarch64__
+
+#endif // GDSCRIPT_JIT_ENABLED
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+// The compiled code of all functions is packed into shared chunks instead of taking whole pages each.
+// Chunks stay executable, since other threads may run code on the pages new code is written to: only
+// the pages written to are made writable, for the time of the copy. A chunk is unmapped once the code
+// of all its functions is freed, freed space isn't reused before that.
+struct GDScriptJIT::Chunk {
+	static constexpr size_t SIZE = 256 * 1024;
+	static constexpr size_t ALIGNMENT = 16;
+
+	uint8_t *memory = nullptr;
+	size_t size = 0;
+	size_t used = 0;
+	uint32_t functions = 0;
+};
+
+static Mutex jit_arena_mutex;
+static GDScriptJIT::Chunk *jit_arena_chunk = nullptr; // Where new code goes, while it has room.
+
+#endif // GDSCRIPT_JIT_ENABLED
+
+GDScriptJIT::Code::~Code() {
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (chunk) {
+		MutexLock lock(jit_arena_mutex);
+		if (--chunk->functions == 0 && chunk != jit_arena_chunk) {
+			munmap(chunk->memory, chunk->size);
+			memdelete(chunk);
+		}
+	}
+#endif
+}
+
+bool GDScriptJIT::is_supported() {
+#ifdef GDSCRIPT_JIT_ENABLED
+	return true;
+#else
+	return false;
+#endif
+}
+
+GDScriptJIT::Code *GDScriptJIT::compile(const GDScriptFunction *p_function) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	typedef GDScriptFunction F;
+
+	const int *code = p_function->_code_ptr;
+	const int code_size = p_function->_code_size;
+	if (!code || code_size == 0 || code[code_size - 1] != F::OPCODE_END) {
+		return nullptr;
+	}
+	const int end_ip = code_size - 1;
+
+	GDScriptJITAssembler assembler;
+	assembler.write_prologue();
+
+	// Jumps may target one past the last instruction, which never has an entry.
+	LocalVector<uint32_t> entries;
+	entries.resize(code_size + 1);
+	for (uint32_t &entry : entries) {
+		entry = Code::NO_ENTRY;
+	}
+	bool uses_members = false;
+
+	struct Jump {
+		uint32_t site;
+		int target;
+		bool leave; // Return to the interpreter at the target, even if it has a template.
+	};
+	LocalVector<Jump> jumps;
+
+	// Where to continue after an instruction without a template, whose size isn't known here.
+	// Every instruction start when recorded, otherwise only lines, which lean bytecode doesn't have.
+	const Vector<int> &resume_opcodes = p_function->instruction_starts.is_empty() ? p_function->line_opcodes : p_function->instruction_starts;
+	const int *resume_ip = resume_opcodes.ptr();
+	const int *resume_ip_end = resume_ip + resume_opcodes.size();
+
+	int ip = 0;
+	while (ip < code_size) {
+		const int *instr = &code[ip];
+		int size = 0;
+
+		// Validates operand `p_index`, as the interpreter does in debug builds.
+		auto address = [&](int p_index) -> bool {
+			const int addr = instr[1 + p_index];
+			const int index = addr & F::ADDR_MASK;
+			switch ((addr & F::ADDR_TYPE_MASK) >> F::ADDR_BITS) {
+				case F::ADDR_TYPE_STACK:
+					return index < p_function->_stack_size;
+				case F::ADDR_TYPE_CONSTANT:
+					return index < p_function->_constant_count;
+				case F::ADDR_TYPE_MEMBER:
+					uses_members = true; // Checked against the instance when running.
+					return true;
+				default:
+					return false;
+			}
+		};
+		auto valid_target = [&](int p_target) -> bool {
+			return p_target >= 0 && p_target < code_size;
+		};
+		auto jump_to = [&](uint32_t p_site, int p_target) {
+			jumps.push_back({ p_site, p_target, false });
+		};
+		auto fail_to_interpreter = [&]() {
+			jumps.push_back({ assembler.write_jump_if_result(false), ip, true });
+		};
+
+		entries[ip] = assembler.get_offset();
+
+		switch (instr[0]) {
+			case F::OPCODE_OPERATOR: {
+				if (!address(0) || !address(1) || !address(2) || instr[4] < 0 || instr[4] >= Variant::OP_MAX) {
+					break;
+				}
+				// The generic path, the inline cache is the interpreter's.
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_address_argument(2, instr[3]);
+				assembler.write_int_argument(3, instr[4]);
+				assembler.write_call((const void *)&_evaluate);
+				fail_to_interpreter();
+				size = 7;
+			} break;
+			case F::OPCODE_OPERATOR_VALIDATED: {
+				if (!address(0) || !address(1) || !address(2) || instr[4] < 0 || instr[4] >= p_function->_operator_funcs_count) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_address_argument(2, instr[3]);
+				assembler.write_call((const void *)p_function->_operator_funcs_ptr[instr[4]]);
+				size = 5;
+			} break;
+			case F::OPCODE_SET_KEYED_VALIDATED:
+			case F::OPCODE_SET_INDEXED_VALIDATED:
+			case F::OPCODE_GET_KEYED_VALIDATED:
+			case F::OPCODE_GET_INDEXED_VALIDATED: {
+				if (!address(0) || !address(1) || !address(2) || instr[4] < 0) {
+					break;
+				}
+				const void *accessor = nullptr;
+				const void *helper = nullptr;
+				switch (instr[0]) {
+					case F::OPCODE_SET_KEYED_VALIDATED:
+						if (instr[4] < p_function->_keyed_setters_count) {
+							accessor = (const void *)p_function->_keyed_setters_ptr[instr[4]];
+							helper = (const void *)&_set_keyed;
+						}
+						break;
+					case F::OPCODE_SET_INDEXED_VALIDATED:
+						if (instr[4] < p_function->_indexed_setters_count) {
+							accessor = (const void *)p_function->_indexed_setters_ptr[instr[4]];
+							helper = (const void *)&_set_indexed;
+						}
+						break;
+					case F::OPCODE_GET_KEYED_VALIDATED:
+						if (instr[4] < p_function->_keyed_getters_count) {
+							accessor = (const void *)p_function->_keyed_getters_ptr[instr[4]];
+							helper = (const void *)&_get_keyed;
+						}
+						break;
+					default:
+						if (instr[4] < p_function->_indexed_getters_count) {
+							accessor = (const void *)p_function->_indexed_getters_ptr[instr[4]];
+							helper = (const void *)&_get_indexed;
+						}
+						break;
+				}
+				if (!helper) {
+					break;
+				}
+				assembler.write_pointer_argument(0, accessor);
+				assembler.write_address_argument(1, instr[1]);
+				assembler.write_address_argument(2, instr[2]);
+				assembler.write_address_argument(3, instr[3]);
+				assembler.write_call(helper);
+				fail_to_interpreter();
+				size = 5;
+			} break;
+			case F::OPCODE_GET_NAMED_VALIDATED: {
+				if (!address(0) || !address(1) || instr[3] < 0 || instr[3] >= p_function->_getters_count) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_call((const void *)p_function->_getters_ptr[instr[3]]);
+				size = 4;
+			} break;
+			case F::OPCODE_SET_NAMED_VALIDATED: {
+				if (!address(0) || !address(1) || instr[3] < 0 || instr[3] >= p_function->_setters_count) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_call((const void *)p_function->_setters_ptr[instr[3]]);
+				size = 4;
+			} break;
+			case F::OPCODE_ASSIGN: {
+				if (!address(0) || !address(1)) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_call((const void *)&_assign);
+				size = 3;
+			} break;
+			case F::OPCODE_ASSIGN_NULL:
+			case F::OPCODE_ASSIGN_TRUE:
+			case F::OPCODE_ASSIGN_FALSE: {
+				if (!address(0)) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				if (instr[0] == F::OPCODE_ASSIGN_NULL) {
+					assembler.write_call((const void *)&_assign_null);
+				} else if (instr[0] == F::OPCODE_ASSIGN_TRUE) {
+					assembler.write_call((const void *)&_assign_true);
+				} else {
+					assembler.write_call((const void *)&_assign_false);
+				}
+				size = 2;
+			} break;
+			case F::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				if (!address(0) || !address(1) || instr[3] < 0 || instr[3] >= Variant::VARIANT_MAX) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_int_argument(2, instr[3]);
+				assembler.write_call((const void *)&_assign_typed_builtin);
+				fail_to_interpreter();
+				size = 4;
+			} break;
+			case F::OPCODE_CONSTRUCT_VALIDATED:
+			case F::OPCODE_CALL_UTILITY_VALIDATED:
+			case F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+				// Operands are `[opcode, count, addresses..., argc, function]`, the addresses ending with the destination.
+				const int count = instr[1];
+				if (count < 1 || count > p_function->_instruction_args_size || 3 + count >= code_size - ip) {
+					break;
+				}
+				const int argc = instr[2 + count];
+				const int index = instr[3 + count];
+				const int needed = instr[0] == F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED ? argc + 2 : argc + 1;
+				bool valid = argc >= 0 && needed <= count && index >= 0;
+				for (int i = 0; valid && i < count; i++) {
+					valid = address(1 + i);
+				}
+				if (!valid) {
+					break;
+				}
+				const int *addresses = &instr[2];
+
+				const void *function = nullptr;
+				if (instr[0] == F::OPCODE_CONSTRUCT_VALIDATED) {
+					function = index < p_function->_constructors_count ? (const void *)p_function->_constructors_ptr[index] : nullptr;
+				} else if (instr[0] == F::OPCODE_CALL_UTILITY_VALIDATED) {
+					function = index < p_function->_utilities_count ? (const void *)p_function->_utilities_ptr[index] : nullptr;
+				} else {
+					function = index < p_function->_builtin_methods_count ? (const void *)p_function->_builtin_methods_ptr[index] : nullptr;
+				}
+				if (!function) {
+					break;
+				}
+
+				for (int i = 0; i < argc; i++) {
+					assembler.write_instruction_arg(i, addresses[i]);
+				}
+				assembler.write_address_argument(0, addresses[argc]);
+				assembler.write_instruction_args_argument(1);
+				if (instr[0] != F::OPCODE_CONSTRUCT_VALIDATED) {
+					assembler.write_int_argument(2, argc);
+				}
+				if (instr[0] == F::OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+					// The base is before the destination.
+					assembler.write_address_argument(3, addresses[argc + 1]);
+				}
+				assembler.write_call(function);
+				size = 4 + count;
+			} break;
+			case F::OPCODE_JUMP: {
+				if (!valid_target(instr[1])) {
+					break;
+				}
+				jump_to(assembler.write_jump(), instr[1]);
+				size = 2;
+			} break;
+			case F::OPCODE_JUMP_IF:
+			case F::OPCODE_JUMP_IF_NOT: {
+				if (!address(0) || !valid_target(instr[2])) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_call((const void *)&_booleanize);
+				jump_to(assembler.write_jump_if_result(instr[0] == F::OPCODE_JUMP_IF), instr[2]);
+				size = 3;
+			} break;
+			case F::OPCODE_RETURN: {
+				if (!address(0)) {
+					break;
+				}
+				assembler.write_frame_argument(0);
+				assembler.write_address_argument(1, instr[1]);
+				assembler.write_call((const void *)&_return);
+				assembler.write_leave(end_ip);
+				size = 2;
+			} break;
+			case F::OPCODE_RETURN_TYPED_BUILTIN: {
+				if (!address(0) || instr[2] < 0 || instr[2] >= Variant::VARIANT_MAX) {
+					break;
+				}
+				assembler.write_frame_argument(0);
+				assembler.write_address_argument(1, instr[1]);
+				assembler.write_int_argument(2, instr[2]);
+				assembler.write_call((const void *)&_return_typed_builtin);
+				fail_to_interpreter();
+				assembler.write_leave(end_ip);
+				size = 3;
+			} break;
+			case F::OPCODE_ITERATE_BEGIN_INT:
+			case F::OPCODE_ITERATE_INT: {
+				if (!address(0) || !address(1) || !address(2) || !valid_target(instr[4])) {
+					break;
+				}
+				assembler.write_address_argument(0, instr[1]);
+				assembler.write_address_argument(1, instr[2]);
+				assembler.write_address_argument(2, instr[3]);
+				assembler.write_call(instr[0] == F::OPCODE_ITERATE_BEGIN_INT ? (const void *)&_iterate_begin_int : (const void *)&_iterate_int);
+				jump_to(assembler.write_jump_if_result(false), instr[4]);
+				size = 5;
+			} break;
+			case F::OPCODE_ITERATE_BEGIN_RANGE: {
+				if (!address(0) || !address(1) || !address(2) || !address(3) || !address(4) || !valid_target(instr[6])) {
+					break;
+				}
+				for (int i = 0; i < 5; i++) {
+					assembler.write_address_argument(i, instr[1 + i]);
+				}
+				assembler.write_call((const void *)&_iterate_begin_range);
+				jump_to(assembler.write_jump_if_result(false), instr[6]);
+				size = 7;
+			} break;
+			case F::OPCODE_ITERATE_RANGE: {
+				if (!address(0) || !address(1) || !address(2) || !address(3) || !valid_target(instr[5])) {
+					break;
+				}
+				for (int i = 0; i < 4; i++) {
+					assembler.write_address_argument(i, instr[1 + i]);
+				}
+				assembler.write_call((const void *)&_iterate_range);
+				jump_to(assembler.write_jump_if_result(false), instr[5]);
+				size = 6;
+			} break;
+			case F::OPCODE_LINE: {
+				assembler.write_line(instr[1]);
+				size = 2;
+			} break;
+			case F::OPCODE_END: {
+				assembler.write_leave(ip);
+				size = 1;
+			} break;
+			default: {
+				if (instr[0] >= F::OPCODE_TYPE_ADJUST_BOOL && instr[0] <= F::OPCODE_TYPE_ADJUST_PACKED_VECTOR4_ARRAY) {
+					if (!address(0)) {
+						break;
+					}
+					assembler.write_address_argument(0, instr[1]);
+					assembler.write_call((const void *)type_adjust_functions[instr[0] - F::OPCODE_TYPE_ADJUST_BOOL]);
+					size = 2;
+				}
+			} break;
+		}
+
+		if (size > 0) {
+			ip += size;
+			continue;
+		}
+
+		// No template: the interpreter runs from here, and takes the compiled code again at the next
+		// jump or line. Instructions that aren't decoded have no entry, jumps to them return to the interpreter.
+		entries[ip] = Code::NO_ENTRY;
+		assembler.write_leave(ip);
+		while (resume_ip < resume_ip_end && *resume_ip <= ip) {
+			resume_ip++;
+		}
+		ip = resume_ip < resume_ip_end ? *resume_ip : end_ip;
+	}
+
+	// Jumps to instructions without a template go through a stub returning to the interpreter.
+	HashMap<int, uint32_t> leave_stubs;
+	for (const Jump &jump : jumps) {
+		uint32_t target = jump.leave ? Code::NO_ENTRY : entries[jump.target];
+		if (target == Code::NO_ENTRY) {
+			HashMap<int, uint32_t>::Iterator stub = leave_stubs.find(jump.target);
+			if (stub) {
+				target = stub->value;
+			} else {
+				target = assembler.get_offset();
+				assembler.write_leave(jump.target);
+				leave_stubs.insert(jump.target, target);
+			}
+		}
+		assembler.patch_jump(jump.site, target);
+	}
+
+	const LocalVector<uint8_t> &bytes = assembler.get_bytes();
+	const size_t page_size = sysconf(_SC_PAGESIZE);
+
+	MutexLock lock(jit_arena_mutex);
+
+	Chunk *chunk = jit_arena_chunk;
+	if (!chunk || chunk->used + bytes.size() > chunk->size) {
+		const size_t chunk_size = MAX(Chunk::SIZE, (bytes.size() + page_size - 1) / page_size * page_size);
+		void *chunk_memory = mmap(nullptr, chunk_size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		ERR_FAIL_COND_V_MSG(chunk_memory == MAP_FAILED, nullptr, "Could not allocate memory for compiled GDScript code.");
+
+		if (jit_arena_chunk && jit_arena_chunk->functions == 0) {
+			munmap(jit_arena_chunk->memory, jit_arena_chunk->size);
+			memdelete(jit_arena_chunk);
+		}
+		chunk = memnew(Chunk);
+		chunk->memory = (uint8_t *)chunk_memory;
+		chunk->size = chunk_size;
+		jit_arena_chunk = chunk;
+	}
+
+	uint8_t *memory = chunk->memory + chunk->used;
+	uint8_t *pages_start = chunk->memory + (chunk->used / page_size * page_size);
+	uint8_t *pages_end = chunk->memory + MIN(chunk->size, (chunk->used + bytes.size() + page_size - 1) / page_size * page_size);
+	// Keeps the pages executable, code of other functions may share them.
+	if (mprotect(pages_start, pages_end - pages_start, PROT_READ | PROT_WRITE | PROT_EXEC) != 0) {
+		ERR_FAIL_V_MSG(nullptr, "Could not write compiled GDScript code.");
+	}
+	memcpy(memory, bytes.ptr(), bytes.size());
+	mprotect(pages_start, pages_end - pages_start, PROT_READ | PROT_EXEC);
+	__builtin___clear_cache((char *)memory, (char *)memory + bytes.size());
+
+	chunk->used = (chunk->used + bytes.size() + Chunk::ALIGNMENT - 1) / Chunk::ALIGNMENT * Chunk::ALIGNMENT;
+	chunk->functions++;
+
+	Code *compiled = memnew(Code);
+	compiled->memory = memory;
+	compiled->memory_size = bytes.size();
+	compiled->chunk = chunk;
+	compiled->entries = std::move(entries);
+	compiled->uses_members = uses_members;
+	return compiled;
+#else
+	return nullptr;
+#endif // GDSCRIPT_JIT_ENABLED
+}
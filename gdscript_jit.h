@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*  gdscript_jit.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+class GDScriptFunction;
+
+// Baseline compiler for hot functions, enabled with the `gdscript/jit/enabled` project setting.
+//
+// Each instruction is translated into a fixed machine code template, which computes the operand
+// addresses from the interpreter frame and calls the same validated evaluator (or a small helper)
+// as the interpreter would. There is no register allocation: values stay in the frame, so the
+// interpreter can take over at any instruction. It does so for instructions without a template,
+// and for templates whose check fails, so the interpreter reports the error. The interpreter
+// enters the compiled code again at the next jump target or `OPCODE_LINE` that has an entry.
+class GDScriptJIT {
+public:
+	struct Chunk; // Of the shared code arena, see `gdscript_jit.cpp`.
+
+	// Shared by `GDScriptFunction::call()` and the compiled code, also the code compiled ahead of time.
+	struct Frame {
+		const GDScriptFunction *function = nullptr;
+		Variant *stack = nullptr;
+		Variant *constants = nullptr;
+		Variant *members = nullptr;
+		Variant **instruction_args = nullptr;
+		Variant *retvalue = nullptr;
+		int *line = nullptr;
+	};
+
+	class Code {
+		friend class GDScriptJIT;
+
+		static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+		typedef int (*EntryPoint)(Frame *p_frame, const uint8_t *p_start);
+
+		uint8_t *memory = nullptr;
+		size_t memory_size = 0;
+		Chunk *chunk = nullptr; // Of the shared code arena, holding `memory`.
+		LocalVector<uint32_t> entries; // Offset of the template of each instruction, or `NO_ENTRY`, one past the end included.
+		bool uses_members = false;
+
+	public:
+		_FORCE_INLINE_ bool has_entry(int p_ip) const { return entries[p_ip] != NO_ENTRY; }
+		_FORCE_INLINE_ bool needs_instance() const { return uses_members; }
+		_FORCE_INLINE_ size_t get_size() const { return memory_size; }
+
+		// Runs from the instruction at `p_ip`, which must have an entry.
+		// Returns the position of the instruction the interpreter continues from.
+		_FORCE_INLINE_ int run(Frame *p_frame, int p_ip) const {
+			return reinterpret_cast<EntryPoint>(memory)(p_frame, memory + entries[p_ip]);
+		}
+
+		~Code();
+	};
+
+	// Whether machine code can be generated for this platform.
+	static bool is_supported();
+	// Returns `nullptr` if the function can't be compiled.
+	static Code *compile(const GDScriptFunction *p_function);
+};
@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*  gdscript_native.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_native.h"
+
+#include "core/templates/a_hash_map.h"
+#include "core/templates/hashfuncs.h"
+
+#ifdef GDSCRIPT_NATIVE_FUNCTIONS
+// Defined by the generated code.
+void gdscript_register_native_functions();
+#endif
+
+static AHashMap<String, GDScriptFunction::NativeFunction> native_function_table;
+
+void GDScriptNativeFunctions::register_function(const String &p_key, GDScriptFunction::NativeFunction p_function) {
+	ERR_FAIL_COND_MSG(native_function_table.has(p_key), vformat(R"(Native GDScript function "%s" is already registered.)", p_key));
+	native_function_table.insert(p_key, p_function);
+}
+
+GDScriptFunction::NativeFunction GDScriptNativeFunctions::get_function(const GDScriptFunction *p_function) {
+	if (native_function_table.is_empty()) {
+		return nullptr;
+	}
+	GDScriptFunction::NativeFunction *function = native_function_table.getptr(get_key(p_function));
+	return function ? *function : nullptr;
+}
+
+bool GDScriptNativeFunctions::has_functions() {
+	return !native_function_table.is_empty();
+}
+
+String GDScriptNativeFunctions::get_key(const GDScriptFunction *p_function) {
+	uint32_t hash = hash_murmur3_buffer(p_function->_code_ptr, p_function->_code_size * sizeof(int));
+	hash = hash_murmur3_one_32(p_function->_stack_size, hash);
+	hash = hash_murmur3_one_32(p_function->_constant_count, hash);
+	hash = hash_murmur3_one_32(p_function->_instruction_args_size, hash);
+	return vformat("%s::%s::%08x", p_function->source, p_function->name, hash);
+}
+
+void GDScriptNativeFunctions::register_functions() {
+#ifdef GDSCRIPT_NATIVE_FUNCTIONS
+	gdscript_register_native_functions();
+#endif
+}
+
+void GDScriptNativeFunctions::unregister_functions() {
+	native_function_table.clear();
+}
@@ -0,0 +1,65 @@
+/**************************************************************************/
+/*  gdscript_native.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "gdscript_function.h"
+
+// Functions compiled ahead of time to C++ by `GDScriptCppCodeGenerator`, and built into the engine
+// from the `native/` folder of the module.
+//
+// A function is matched by script path, name and a hash of its bytecode, since the generated code
+// addresses the same frame as the interpreter. If the bytecode differs (the script changed, or was
+// compiled with other options), the interpreter runs it as usual. The translation is made from the
+// bytecode of release builds, so debug builds, which also track lines and run asserts, don't use it.
+class GDScriptNativeFunctions {
+public:
+	static void register_function(const String &p_key, GDScriptFunction::NativeFunction p_function);
+	static GDScriptFunction::NativeFunction get_function(const GDScriptFunction *p_function);
+	static bool has_functions();
+	static String get_key(const GDScriptFunction *p_function);
+
+	static void register_functions();
+	static void unregister_functions();
+
+	// Used by the generated code, which gets the same validated functions as the interpreter.
+
+	_FORCE_INLINE_ static const Variant::ValidatedOperatorEvaluator *get_operator_funcs(const GDScriptFunction *p_function) { return p_function->_operator_funcs_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedSetter *get_setters(const GDScriptFunction *p_function) { return p_function->_setters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedGetter *get_getters(const GDScriptFunction *p_function) { return p_function->_getters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedKeyedSetter *get_keyed_setters(const GDScriptFunction *p_function) { return p_function->_keyed_setters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedKeyedGetter *get_keyed_getters(const GDScriptFunction *p_function) { return p_function->_keyed_getters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedIndexedSetter *get_indexed_setters(const GDScriptFunction *p_function) { return p_function->_indexed_setters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedIndexedGetter *get_indexed_getters(const GDScriptFunction *p_function) { return p_function->_indexed_getters_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedBuiltInMethod *get_builtin_methods(const GDScriptFunction *p_function) { return p_function->_builtin_methods_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedConstructor *get_constructors(const GDScriptFunction *p_function) { return p_function->_constructors_ptr; }
+	_FORCE_INLINE_ static const Variant::ValidatedUtilityFunction *get_utilities(const GDScriptFunction *p_function) { return p_function->_utilities_ptr; }
+	_FORCE_INLINE_ static MethodBind *const *get_methods(const GDScriptFunction *p_function) { return p_function->_methods_ptr; }
+};
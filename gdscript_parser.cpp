@@ -95,6 +95,21 @@ bool GDScriptParser::annotation_exists(const String &p_annotation_name) const {
 	return valid_annotations.has(p_annotation_name);
 }
 
+bool GDScriptParser::annotation_continues_header(const StringName &p_annotation_name, bool &r_exists) {
+	if (unlikely(valid_annotations.is_empty())) {
+		GDScriptParser parser; // Registers the annotations.
+	}
+	const AnnotationInfo *info = valid_annotations.getptr(p_annotation_name);
+	r_exists = info != nullptr;
+	if (!info) {
+		return false;
+	}
+	if (info->target_kind & (AnnotationInfo::SCRIPT | AnnotationInfo::CLASS)) {
+		return true;
+	}
+	return p_annotation_name == SNAME("@warning_ignore_start") || p_annotation_name == SNAME("@warning_ignore_restore");
+}
+
 #ifdef DEBUG_ENABLED
 void GDScriptParser::update_project_settings() {
 	is_project_ignoring_warnings = !GLOBAL_GET("debug/gdscript/warnings/enable").booleanize();
@@ -414,23 +429,23 @@ void GDScriptParser::set_last_completion_call_arg(int p_argument) {
 	completion_call_stack.back()->get().argument = p_argument;
 }
 
-Error GDScriptParser::parse(const String &p_source_code, const String &p_script_path, bool p_for_completion, bool p_parse_body) {
-	clear();
-
-	String source = p_source_code;
-	int cursor_line = -1;
-	int cursor_column = -1;
-	for_completion = p_for_completion;
-	parse_body = p_parse_body;
-
-	int tab_size = 4;
+static int _get_completion_tab_size() {
 #ifdef TOOLS_ENABLED
 	if (EditorSettings::get_singleton()) {
-		tab_size = EditorSettings::get_singleton()->get_setting("text_editor/behavior/indent/size");
+		return EditorSettings::get_singleton()->get_setting("text_editor/behavior/indent/size");
 	}
 #endif // TOOLS_ENABLED
+	return 4;
+}
+
+Error GDScriptParser::parse(const String &p_source_code, const String &p_script_path, bool p_for_completion, bool p_parse_body) {
+	String source = p_source_code;
+	int cursor_line = -1;
+	int cursor_column = -1;
 
 	if (p_for_completion) {
+		const int tab_size = _get_completion_tab_size();
+
 		// Remove cursor sentinel char.
 		const Vector<String> lines = p_source_code.split("\n");
 		cursor_line = 1;
@@ -457,11 +472,41 @@ Error GDScriptParser::parse(const String &p_source_code, const String &p_script_
 		source = source.replace_first(String::chr(0xFFFF), String());
 	}
 
+	return _parse_text(source, p_script_path, p_for_completion, p_parse_body, cursor_line, cursor_column);
+}
+
+Error GDScriptParser::parse_with_cursor(const String &p_source_code, const String &p_script_path, int p_cursor_line, int p_cursor_character) {
+	const int tab_size = _get_completion_tab_size();
+
+	// Only the cursor line has to be looked at to turn the character index into a tokenizer column.
+	const char32_t *chars = p_source_code.ptr();
+	const int length = p_source_code.length();
+	int pos = 0;
+	for (int line = 0; line < p_cursor_line && pos < length; pos++) {
+		if (chars[pos] == '\n') {
+			line++;
+		}
+	}
+
+	int cursor_column = 1;
+	for (int i = 0; i < p_cursor_character && pos + i < length && chars[pos + i] != '\n'; i++) {
+		cursor_column += chars[pos + i] == '\t' ? tab_size : 1;
+	}
+
+	return _parse_text(p_source_code, p_script_path, true, true, p_cursor_line + 1, cursor_column);
+}
+
+Error GDScriptParser::_parse_text(const String &p_source_code, const String &p_script_path, bool p_for_completion, bool p_parse_body, int p_cursor_line, int p_cursor_column) {
+	clear();
+
+	for_completion = p_for_completion;
+	parse_body = p_parse_body;
+
 	GDScriptTokenizerText *text_tokenizer = memnew(GDScriptTokenizerText);
-	text_tokenizer->set_source_code(source);
+	text_tokenizer->set_source_code(p_source_code);
 
 	tokenizer = text_tokenizer;
-	tokenizer->set_cursor_position(cursor_line, cursor_column);
+	tokenizer->set_cursor_position(p_cursor_line, p_cursor_column);
 
 	script_path = p_script_path.simplify_path();
 
@@ -462,6 +462,7 @@ public:
 
 	struct ArrayNode : public ExpressionNode {
 		Vector<ExpressionNode *> elements;
+		bool is_scratch = false; // Only read where it's built, so the frame can reuse its storage.
 
 		ArrayNode() {
 			type = ARRAY;
@@ -1001,6 +1002,12 @@ public:
 
 		int usages = 0; // Useful for binds/iterator variable.
 
+		// Type of an untyped local inside an `is` or `typeof()` guard, see `GDScriptAnalyzer::push_type_narrowings()`.
+		// Only used by the compiler to pick typed opcodes, the identifier keeps its declared type.
+		DataType narrowed_type;
+
+		bool is_read_only_use = false; // Container local only read in place, see `GDScriptAnalyzer::mark_read_only_use()`.
+
 		IdentifierNode() {
 			type = IDENTIFIER;
 		}
@@ -1062,6 +1069,8 @@ public:
 	};
 
 	struct ParameterNode : public AssignableNode {
+		bool is_modified = false; // Written to in the body, even through a subscript.
+
 		ParameterNode() {
 			type = PARAMETER;
 		}
@@ -1350,6 +1359,9 @@ public:
 		PropertyInfo export_info;
 		int assignments = 0;
 		bool is_static = false;
+		// Locals only. Used to share constant container initializers that never escape.
+		int escaping_uses = 0;
+		bool is_modified = false;
 #ifdef TOOLS_ENABLED
 		MemberDocData doc_data;
 #endif // TOOLS_ENABLED
@@ -1705,8 +1717,13 @@ private:
 	ClassDocData parse_class_doc_comment(int p_line, bool p_single_line = false);
 #endif // TOOLS_ENABLED
 
+	Error _parse_text(const String &p_source_code, const String &p_script_path, bool p_for_completion, bool p_parse_body, int p_cursor_line, int p_cursor_column);
+
 public:
 	Error parse(const String &p_source_code, const String &p_script_path, bool p_for_completion, bool p_parse_body = true);
+	// Parses for completion, with the cursor at a zero-based line and character of `p_source_code`
+	// instead of marked by a sentinel character in it.
+	Error parse_with_cursor(const String &p_source_code, const String &p_script_path, int p_cursor_line, int p_cursor_character);
 	Error parse_binary(const Vector<uint8_t> &p_binary, const String &p_script_path);
 	ClassNode *get_tree() const { return head; }
 	bool is_tool() const { return _is_tool; }
@@ -1719,6 +1736,9 @@ public:
 	CompletionContext get_completion_context() const { return completion_context; }
 	void get_annotation_list(List<MethodInfo> *r_annotations) const;
 	bool annotation_exists(const String &p_annotation_name) const;
+	// Whether `class_name` and `extends` can still follow the annotation at the top of a script,
+	// as in `parse_program()`. Sets `r_exists` to whether the annotation is known.
+	static bool annotation_continues_header(const StringName &p_annotation_name, bool &r_exists);
 
 	const List<ParserError> &get_errors() const { return errors; }
 	const List<String> get_dependencies() const {
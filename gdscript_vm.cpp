@@ -38,6 +38,100 @@
 #include "core/profiling/profiling.h"
 
 #include <atomic>
+
+// Arguments stored in the caller's stack or constants outlive a direct call and nothing else can
+// write to them while it runs, so the callee may borrow them.
+static _FORCE_INLINE_ uint64_t _get_borrowed_args(const GDScriptFunction *p_callee, const Variant **p_args, int p_argcount, const Variant *p_stack, int p_stack_size, const Variant *p_constants, int p_constant_count) {
+	uint64_t borrowable = p_callee->get_borrowable_args();
+	if (borrowable == 0) {
+		return 0;
+	}
+	uint64_t borrowed = 0;
+	for (int i = 0; i < MIN(p_argcount, 64); i++) {
+		if ((p_args[i] >= p_stack && p_args[i] < p_stack + p_stack_size) || (p_args[i] >= p_constants && p_args[i] < p_constants + p_constant_count)) {
+			borrowed |= uint64_t(1) << i;
+		}
+	}
+	return borrowed & borrowable;
+}
+
+// Type feedback of property reads and method calls on built-in receivers, see `GDScriptFunction::SPECULATION_THRESHOLD`.
+// It lives in the target half of the inline cache: objects fill the first class slot before any other,
+// so while it's empty the site has only seen built-in receivers and that half is unused.
+static constexpr int SPECULATION_SLOTS_OFFSET = GDScriptFunction::INLINE_CACHE_SLOTS / 2;
+
+// Slots: receiver type + 1, consecutive hits, index + 1 of the published `GDScriptFunction::Speculation`,
+// and the argument types, 8 bits each. A half holds at least four slots, even with 32-bit pointers.
+// Other threads run the same bytecode, so all of them are atomic, and a published speculation is never changed.
+static _FORCE_INLINE_ std::atomic<int> *_get_speculation_slots(int *p_cache) {
+	return reinterpret_cast<std::atomic<int> *>(p_cache + SPECULATION_SLOTS_OFFSET);
+}
+
+static_assert(GDScriptFunction::INLINE_CACHE_SLOTS / 2 >= 4);
+
+static _FORCE_INLINE_ bool _observe_builtin_receiver(int *p_cache, Variant::Type p_type, uint32_t p_argument_types = 0) {
+	if (*reinterpret_cast<void **>(p_cache) != nullptr) {
+		return false;
+	}
+	std::atomic<int> *feedback = _get_speculation_slots(p_cache);
+	if (feedback[0].load(std::memory_order_relaxed) != p_type + 1 || (uint32_t)feedback[3].load(std::memory_order_relaxed) != p_argument_types) {
+		feedback[0].store(p_type + 1, std::memory_order_relaxed);
+		feedback[3].store((int)p_argument_types, std::memory_order_relaxed);
+		feedback[1].store(1, std::memory_order_relaxed);
+		return false;
+	}
+	return feedback[1].fetch_add(1, std::memory_order_relaxed) + 1 == GDScriptFunction::SPECULATION_THRESHOLD;
+}
+
+// Starts observing again, the published speculation stays valid for threads still using it.
+static void _reset_feedback(int *p_cache) {
+	std::atomic<int> *feedback = _get_speculation_slots(p_cache);
+	feedback[0].store(0, std::memory_order_relaxed);
+	feedback[1].store(0, std::memory_order_relaxed);
+	feedback[3].store(0, std::memory_order_relaxed);
+}
+
+static void _publish_speculation(int *p_code, int p_ip, int *p_cache, int p_index, GDScriptFunction::Opcode p_opcode) {
+	if (p_index == 0) {
+		return; // The function has speculated too often.
+	}
+	_get_speculation_slots(p_cache)[2].store(p_index, std::memory_order_release);
+	reinterpret_cast<std::atomic<int> *>(&p_code[p_ip])->store(p_opcode, std::memory_order_release);
+}
+
+static _FORCE_INLINE_ void _set_opcode(int *p_code, int p_ip, GDScriptFunction::Opcode p_opcode) {
+	reinterpret_cast<std::atomic<int> *>(&p_code[p_ip])->store(p_opcode, std::memory_order_release);
+}
+
+static bool _make_get_named_speculation(Variant::Type p_type, const StringName &p_name, GDScriptFunction::Speculation &r_speculation) {
+	r_speculation.receiver_type = p_type;
+	r_speculation.getter = Variant::get_member_validated_getter(p_type, p_name);
+	return r_speculation.getter != nullptr; // Like a dictionary key, look again later.
+}
+
+// `p_argument_types` are the ones observed, which the guard checks against the ones the method takes.
+static bool _make_builtin_call_speculation(Variant::Type p_type, const StringName &p_method, int p_argc, uint32_t p_argument_types, bool p_call_ret, GDScriptFunction::Speculation &r_speculation) {
+	const Variant::ValidatedBuiltInMethod method = Variant::get_validated_builtin_method(p_type, p_method);
+	if (method == nullptr || p_argc > 4 || Variant::is_builtin_method_vararg(p_type, p_method) || Variant::is_builtin_method_static(p_type, p_method) ||
+			Variant::get_builtin_method_argument_count(p_type, p_method) != p_argc || (p_call_ret && !Variant::has_builtin_method_return_value(p_type, p_method))) {
+		return false; // Defaults, varargs or a missing return value stay on the generic path.
+	}
+
+	r_speculation.receiver_type = p_type;
+	r_speculation.return_type = Variant::get_builtin_method_return_type(p_type, p_method);
+	r_speculation.call_return = p_call_ret;
+	r_speculation.is_const = Variant::is_builtin_method_const(p_type, p_method);
+	for (int i = 0; i < p_argc; i++) {
+		const Variant::Type argument_type = Variant::get_builtin_method_argument_type(p_type, p_method, i);
+		if (argument_type != Variant::NIL && argument_type != (Variant::Type)((p_argument_types >> (i * 8)) & 0xFF)) {
+			return false; // Converted by the generic path, the guard would fail every time.
+		}
+		r_speculation.argument_types |= argument_type << (i * 8);
+	}
+	r_speculation.method = method;
+	return true;
+}
+
 #ifdef DEBUG_ENABLED
 
 static bool _profile_count_as_native(const Object *p_base_obj, const StringName &p_methodname) {
@@ -107,12 +201,13 @@ static String _get_var_type(const Variant *p_var) {
 }
 
 void GDScriptFunction::_profile_native_call(uint64_t p_t_taken, const String &p_func_name, const String &p_instance_class_name) {
-	HashMap<String, Profile::NativeProfile>::Iterator inner_prof = profile.native_calls.find(p_func_name);
+	_profile_touch();
+	HashMap<String, Profile::NativeProfile>::Iterator inner_prof = profile.native_calls->find(p_func_name);
 	if (inner_prof) {
 		inner_prof->value.call_count += 1;
 	} else {
 		String sig = vformat("%s::0::%s%s%s", get_script()->get_script_path(), p_instance_class_name, p_instance_class_name.is_empty() ? "" : ".", p_func_name);
-		inner_prof = profile.native_calls.insert(p_func_name, Profile::NativeProfile{ 1, 0, sig });
+		inner_prof = profile.native_calls->insert(p_func_name, Profile::NativeProfile{ 1, 0, sig });
 	}
 	inner_prof->value.total_time += p_t_taken;
 }
@@ -154,6 +249,27 @@ Variant GDScriptFunction::_get_default_variant_for_data_type(const GDScriptDataT
 	return Variant();
 }
 
+const GDScriptJIT::Code *GDScriptFunction::_get_jit_code(const GDScriptInstance *p_instance) {
+	// Compiled code doesn't stop at breakpoints.
+	if (EngineDebugger::is_active()) {
+		return nullptr;
+	}
+	const GDScriptJIT::Code *jit_code = _jit_code.load(std::memory_order_acquire);
+	if (!jit_code) {
+		if (_jit_call_count.increment() != GDScriptLanguage::get_singleton()->get_jit_call_threshold()) {
+			return nullptr;
+		}
+		GDScriptJIT::Code *compiled = GDScriptJIT::compile(this);
+		_jit_code.store(compiled, std::memory_order_release);
+		jit_code = compiled;
+		if (!jit_code) {
+			return nullptr;
+		}
+	}
+	// Member addresses are relative to the instance.
+	return jit_code->needs_instance() && !p_instance ? nullptr : jit_code;
+}
+
 String GDScriptFunction::_get_call_error(const String &p_where, const Variant **p_argptrs, int p_argcount, const Variant &p_ret, const Callable::CallError &p_err) const {
 	switch (p_err.error) {
 		case Callable::CallError::CALL_OK:
@@ -268,11 +384,13 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_SET_INDEXED_VALIDATED,                  \
 		&&OPCODE_GET_KEYED,                              \
 		&&OPCODE_GET_KEYED_VALIDATED,                    \
+		&&OPCODE_GET_DICTIONARY_KEY,                     \
 		&&OPCODE_GET_INDEXED_VALIDATED,                  \
 		&&OPCODE_SET_NAMED,                              \
 		&&OPCODE_SET_NAMED_VALIDATED,                    \
 		&&OPCODE_GET_NAMED,                              \
 		&&OPCODE_GET_NAMED_VALIDATED,                    \
+		&&OPCODE_GET_NAMED_SPECULATED,                   \
 		&&OPCODE_SET_MEMBER,                             \
 		&&OPCODE_GET_MEMBER,                             \
 		&&OPCODE_SET_STATIC_VARIABLE,                    \
@@ -293,11 +411,15 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_CONSTRUCT_VALIDATED,                    \
 		&&OPCODE_CONSTRUCT_ARRAY,                        \
 		&&OPCODE_CONSTRUCT_TYPED_ARRAY,                  \
+		&&OPCODE_CONSTRUCT_SCRATCH_ARRAY,                \
 		&&OPCODE_CONSTRUCT_DICTIONARY,                   \
 		&&OPCODE_CONSTRUCT_TYPED_DICTIONARY,             \
 		&&OPCODE_CALL,                                   \
 		&&OPCODE_CALL_RETURN,                            \
 		&&OPCODE_CALL_ASYNC,                             \
+		&&OPCODE_CALL_SCRIPT,                            \
+		&&OPCODE_CALL_SCRIPT_RETURN,                     \
+		&&OPCODE_CALL_BUILTIN_SPECULATED,                \
 		&&OPCODE_CALL_UTILITY,                           \
 		&&OPCODE_CALL_UTILITY_VALIDATED,                 \
 		&&OPCODE_CALL_GDSCRIPT_UTILITY,                  \
@@ -413,6 +535,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ASSERT,                                 \
 		&&OPCODE_BREAKPOINT,                             \
 		&&OPCODE_LINE,                                   \
+		&&OPCODE_LINE_BREAKPOINT,                        \
 		&&OPCODE_END                                     \
 	};                                                   \
 	static_assert(std_size(switch_table_ops) == (OPCODE_END + 1), "Opcodes in jump table aren't the same as opcodes in enum.");
@@ -456,6 +579,13 @@ void (*type_init_function_table[])(Variant *) = {
 #define OPCODE_OUT break
 #endif // defined(__GNUC__) || defined(__clang__)
 
+// Jump targets are where the interpreter takes the compiled code again after an instruction it has no
+// template for, so loops don't stay interpreted when there is no `OPCODE_LINE` to take it at.
+#define JIT_RESUME_AT_TARGET                   \
+	if (jit_code && jit_code->has_entry(ip)) { \
+		ip = jit_code->run(&jit_frame, ip);    \
+	}
+
 // Helpers for VariantInternal methods in macros.
 #define OP_GET_BOOL get_bool
 #define OP_GET_INT get_int
@@ -498,7 +628,7 @@ void (*type_init_function_table[])(Variant *) = {
 #define METHOD_CALL_ON_NULL_VALUE_ERROR(method_pointer) "Cannot call method '" + (method_pointer)->get_name() + "' on a null value."
 #define METHOD_CALL_ON_FREED_INSTANCE_ERROR(method_pointer) "Cannot call method '" + (method_pointer)->get_name() + "' on a previously freed instance."
 
-Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state) {
+Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state, uint64_t p_borrowed_args) {
 	GodotProfileZoneScript(this, source, name, name, _initial_line);
 
 	constexpr int k_inline_cache_ptr_slots = sizeof(void *) / sizeof(int);
@@ -542,6 +672,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	Variant *stack = nullptr;
 	Variant **instruction_args = nullptr;
 	int defarg = 0;
+	uint64_t borrowed_slots = 0;
 
 	uint32_t alloca_size = 0;
 	GDScript *script;
@@ -584,15 +715,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		stack = (Variant *)aptr;
 
 		const int non_vararg_arg_count = MIN(p_argcount, _argument_count);
+		const uint64_t borrowable_args = p_borrowed_args & _borrowable_args;
 		for (int i = 0; i < non_vararg_arg_count; i++) {
-			if (!argument_types[i].has_type()) {
-				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
-				continue;
-			}
 			// If types already match, don't call Variant::construct(). Constructors of some types
 			// (e.g. packed arrays) do copies, whereas they pass by reference when inside a Variant.
-			if (argument_types[i].is_type(*p_args[i], false)) {
-				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
+			if (!argument_types[i].has_type() || argument_types[i].is_type(*p_args[i], false)) {
+				if (i < 64 && (borrowable_args & (uint64_t(1) << i))) {
+					// Read-only parameter, share the caller's value without copying it.
+					memcpy((void *)&stack[i + FIXED_ADDRESSES_MAX], (const void *)p_args[i], sizeof(Variant));
+					borrowed_slots |= uint64_t(1) << i;
+				} else {
+					memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
+				}
 				continue;
 			}
 			if (!argument_types[i].is_type(*p_args[i], true)) {
@@ -613,8 +747,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Array array(p_args[i]->operator Array(), arg_type.builtin_type, arg_type.native_type, arg_type.script_type);
 					memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(array));
 				} else {
-					Variant variant;
-					Variant::construct(argument_types[i].builtin_type, variant, &p_args[i], 1, r_err);
+					// Construct in place rather than copying a temporary.
+					Variant *variant = memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant);
+					Variant::construct(argument_types[i].builtin_type, *variant, &p_args[i], 1, r_err);
 					if (unlikely(r_err.error)) {
 						r_err.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
 						r_err.argument = i;
@@ -622,7 +757,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						call_depth--;
 						return _get_default_variant_for_data_type(return_type);
 					}
-					memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(variant));
 				}
 			} else {
 				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant(*p_args[i]));
@@ -739,6 +873,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		function_call_time = 0;
 		profile.call_count.increment();
 		profile.frame_call_count.increment();
+		_profile_touch();
 	}
 	bool exit_ok = false;
 	int variant_address_limits[ADDR_TYPE_MAX] = { _stack_size, _constant_count, p_instance ? (int)p_instance->members.size() : 0 };
@@ -747,6 +882,25 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	bool awaited = false;
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
+	// Code compiled ahead of time takes precedence, neither stops at breakpoints.
+	const NativeFunction native_function = _native_function && !EngineDebugger::is_active() ? _native_function : nullptr;
+	const GDScriptJIT::Code *jit_code = !native_function && GDScriptLanguage::get_singleton()->is_jit_enabled() ? _get_jit_code(p_instance) : nullptr;
+	GDScriptJIT::Frame jit_frame;
+	if (native_function || jit_code) {
+		jit_frame.function = this;
+		jit_frame.stack = stack;
+		jit_frame.constants = _constants_ptr;
+		jit_frame.members = variant_addresses[ADDR_TYPE_MEMBER];
+		jit_frame.instruction_args = instruction_args;
+		jit_frame.retvalue = &retvalue;
+		jit_frame.line = &line;
+		if (native_function) {
+			ip = native_function(&jit_frame, ip);
+		} else if (jit_code->has_entry(ip)) {
+			ip = jit_code->run(&jit_frame, ip);
+		}
+	}
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip];
@@ -756,8 +910,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		OPCODE_SWITCH(_code_ptr[ip]) {
 			OPCODE(OPCODE_OPERATOR) {
-				constexpr int _pointer_size = sizeof(Variant::ValidatedOperatorEvaluator) / sizeof(*_code_ptr);
-				CHECK_SPACE(7 + _pointer_size);
+				CHECK_SPACE(7);
 
 				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 4];
@@ -766,54 +919,73 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(a, 0);
 				GET_VARIANT_PTR(b, 1);
 				GET_VARIANT_PTR(dst, 2);
-				// Compute signatures (types of operands) so it can be optimized when matching.
-				uint32_t op_signature = _code_ptr[ip + 5];
-				uint32_t actual_signature = (a->get_type() << 8) | (b->get_type());
+				// The evaluator for the operand types seen so far, published as a speculation: other threads run
+				// the same bytecode, and a single index keeps the types and the evaluator consistent.
+				std::atomic<int> *speculation_slot = reinterpret_cast<std::atomic<int> *>(&_code_ptr[ip + 5]);
+				int speculation_index = speculation_slot->load(std::memory_order_acquire);
 
 #ifdef DEBUG_ENABLED
-				if (op == Variant::OP_DIVIDE || op == Variant::OP_MODULE) {
+				if (unlikely(speculation_index == 0) && (op == Variant::OP_DIVIDE || op == Variant::OP_MODULE)) {
 					// Don't optimize division and modulo since there's not check for division by zero with validated calls.
-					op_signature = 0xFFFF;
-					_code_ptr[ip + 5] = op_signature;
+					speculation_index = -1;
+					speculation_slot->store(speculation_index, std::memory_order_relaxed);
 				}
 #endif
 
-				// Check if this is the first run. If so, store the current signature for the optimized path.
-				if (unlikely(op_signature == 0)) {
-					Variant::Type a_type = (Variant::Type)((actual_signature >> 8) & 0xFF);
-					Variant::Type b_type = (Variant::Type)(actual_signature & 0xFF);
-
-					Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(op, a_type, b_type);
+				// Check if this is the first run. If so, speculate on the current types for the optimized path.
+				if (unlikely(speculation_index == 0)) {
+					Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(op, a->get_type(), b->get_type());
 
 					if (unlikely(!op_func)) {
 	#ifdef DEBUG_ENABLED
 						err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
 	#endif
 						OPCODE_BREAK;
-					} else {
-						Variant::Type ret_type = Variant::get_operator_return_type(op, a_type, b_type);
-						VariantInternal::initialize(dst, ret_type);
-						op_func(a, b, dst);
-
-						// Attempt to publish the cached evaluator atomically to avoid contention.
-						std::atomic<int> *sig_slot = reinterpret_cast<std::atomic<int> *>(&_code_ptr[ip + 5]);
-						int expected_zero = 0;
-						if (sig_slot->compare_exchange_strong(expected_zero, (int)actual_signature, std::memory_order_release, std::memory_order_relaxed)) {
-							_code_ptr[ip + 6] = static_cast<int>(ret_type);
-							Variant::ValidatedOperatorEvaluator *tmp = reinterpret_cast<Variant::ValidatedOperatorEvaluator *>(&_code_ptr[ip + 7]);
-							*tmp = op_func;
-						}
 					}
-				} else if (likely(op_signature == actual_signature)) {
-					// If the signature matches, we can use the optimized path.
-					Variant::Type ret_type = static_cast<Variant::Type>(_code_ptr[ip + 6]);
-					Variant::ValidatedOperatorEvaluator op_func = *reinterpret_cast<Variant::ValidatedOperatorEvaluator *>(&_code_ptr[ip + 7]);
 
-					// Make sure the return value has the correct type.
-					VariantInternal::initialize(dst, ret_type);
+					Speculation speculation;
+					speculation.receiver_type = a->get_type();
+					speculation.argument_types = b->get_type();
+					speculation.return_type = Variant::get_operator_return_type(op, a->get_type(), b->get_type());
+					speculation.operator_evaluator = op_func;
+					VariantInternal::initialize(dst, speculation.return_type);
 					op_func(a, b, dst);
+
+					// Each site has an entry of its own, a thread losing the race to another one only wastes it.
+					const int index = _add_speculation(speculation);
+					int expected_zero = 0;
+					speculation_slot->compare_exchange_strong(expected_zero, index != 0 ? index : -1, std::memory_order_acq_rel);
+					ip += 7;
+					DISPATCH_OPCODE;
+				}
+
+				const Speculation *speculation = _get_speculation(speculation_index);
+				if (likely(speculation && a->get_type() == speculation->receiver_type && b->get_type() == (Variant::Type)speculation->argument_types)) {
+					// Make sure the return value has the correct type.
+					VariantInternal::initialize(dst, speculation->return_type);
+					speculation->operator_evaluator(a, b, dst);
 				} else {
-					// If the signature doesn't match, we have to use the slow path.
+					// If the types don't match, we have to use the slow path.
+					// Misses are counted, so a site whose types changed for good
+					// (e.g. the first call was an edge case) is specialized again for the new ones.
+					if (speculation && _speculation_failures.get() < MAX_SPECULATION_FAILURES) {
+						std::atomic<int> *misses_slot = reinterpret_cast<std::atomic<int> *>(&_code_ptr[ip + 6]);
+						if (misses_slot->fetch_add(1, std::memory_order_relaxed) + 1 >= SPECULATION_THRESHOLD) {
+							misses_slot->store(0, std::memory_order_relaxed);
+							Speculation respeculation;
+							respeculation.receiver_type = a->get_type();
+							respeculation.argument_types = b->get_type();
+							respeculation.return_type = Variant::get_operator_return_type(op, a->get_type(), b->get_type());
+							respeculation.operator_evaluator = Variant::get_validated_operator_evaluator(op, a->get_type(), b->get_type());
+							if (respeculation.operator_evaluator) {
+								_speculation_failures.increment();
+								const int index = _add_speculation(respeculation);
+								if (index != 0) {
+									speculation_slot->store(index, std::memory_order_release);
+								}
+							}
+						}
+					}
 #ifdef DEBUG_ENABLED
 
 					Variant ret;
@@ -835,7 +1007,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					*dst = ret;
 #endif
 				}
-				ip += 7 + _pointer_size;
+				ip += 7;
 			}
 			DISPATCH_OPCODE;
 
@@ -940,7 +1112,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 
-				*dst = object && ClassDB::is_parent_class(object->get_class_name(), native_type);
+				*dst = object && GDScriptDataType::is_native_subtype(object->get_class_name(), native_type);
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
@@ -964,14 +1136,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				bool result = false;
 				if (object && object->get_script_instance()) {
-					Script *script_ptr = object->get_script_instance()->get_script().ptr();
-					while (script_ptr) {
-						if (script_ptr == script_type) {
-							result = true;
-							break;
-						}
-						script_ptr = script_ptr->get_base_script().ptr();
-					}
+					result = GDScriptDataType::is_script_subtype(object->get_script_instance()->get_script().ptr(), script_type);
 				}
 
 				*dst = result;
@@ -1167,6 +1332,36 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_DICTIONARY_KEY) {
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(key, 1);
+				GET_VARIANT_PTR(dst, 2);
+
+				// The key is a constant already in the dictionary key type. Only a `StringName` one carries
+				// its hash, a `String` key of `Dictionary[String, V]` is still hashed on each lookup.
+				const Variant *value = VariantInternal::get_dictionary(src)->getptr(*key);
+#ifdef DEBUG_ENABLED
+				if (unlikely(value == nullptr)) {
+					err_text = "Invalid access to property or key '" + key->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
+					OPCODE_BREAK;
+				}
+#endif
+				if (unlikely(value == nullptr)) {
+					// Like the keyed getters, a missing key reads as null.
+					*dst = Variant();
+				} else if (unlikely(dst == src)) {
+					// Assigning would free the dictionary holding the value.
+					Variant ret = *value;
+					*dst = ret;
+				} else {
+					*dst = *value;
+				}
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_INDEXED_VALIDATED) {
 				CHECK_SPACE(4);
 
@@ -1422,6 +1617,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 
 				if (!used_fast_path) {
+					const Variant::Type src_type = src->get_type();
 	#ifdef DEBUG_ENABLED
 					Variant ret = src->get_named(*index, valid);
 	#else
@@ -1434,12 +1630,56 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 					*dst = ret;
 	#endif
+					if (valid && src_type != Variant::OBJECT && _speculation_failures.get() < MAX_SPECULATION_FAILURES) {
+						int *cache = &_code_ptr[ip + 4];
+						if (unlikely(_observe_builtin_receiver(cache, src_type))) {
+							Speculation speculation;
+							if (_make_get_named_speculation(src_type, *index, speculation)) {
+								_publish_speculation(_code_ptr, ip, cache, _add_speculation(speculation), OPCODE_GET_NAMED_SPECULATED);
+							} else {
+								_reset_feedback(cache);
+							}
+						}
+					}
 				}
 
 				ip += 4 + (k_inline_cache_pic_size * k_inline_cache_ptr_slots * 2);
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_NAMED_SPECULATED) {
+				constexpr int _cache_args = 4 + (k_inline_cache_pic_size * k_inline_cache_ptr_slots * 2);
+				CHECK_SPACE(_cache_args);
+
+				GET_VARIANT_PTR(src, 0);
+				GET_VARIANT_PTR(dst, 1);
+
+				int *cache = &_code_ptr[ip + 4];
+				const Speculation *speculation = _get_speculation(_get_speculation_slots(cache)[2].load(std::memory_order_acquire));
+				if (unlikely(speculation == nullptr)) {
+					DISPATCH_OPCODE; // Published before the opcode, visible on the next read.
+				}
+				if (unlikely(src->get_type() != speculation->receiver_type)) {
+					// Deoptimize, the generic opcode runs this instruction again.
+					_reset_feedback(cache);
+					_speculation_failures.increment();
+					_set_opcode(_code_ptr, ip, OPCODE_GET_NAMED);
+					DISPATCH_OPCODE;
+				}
+
+				const Variant::ValidatedGetter getter = speculation->getter;
+				if (unlikely(src == dst)) {
+					// The getter adjusts the type of the destination before reading.
+					const Variant base = *src;
+					getter(&base, dst);
+				} else {
+					getter(src, dst);
+				}
+
+				ip += _cache_args;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_NAMED_VALIDATED) {
 				CHECK_SPACE(3);
 
@@ -1867,7 +2107,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						OPCODE_BREAK;
 					}
 
-					if (src_obj && !ClassDB::is_parent_class(src_obj->get_class_name(), nc->get_name())) {
+					if (src_obj && !GDScriptDataType::is_native_subtype(src_obj->get_class_name(), nc->get_name())) {
 						err_text = "Trying to assign value of type '" + src_obj->get_class_name() +
 								"' to a variable of type '" + nc->get_name() + "'.";
 						OPCODE_BREAK;
@@ -1913,15 +2153,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						}
 
 						Script *src_type = scr_inst->get_script().ptr();
-						bool valid = false;
-
-						while (src_type) {
-							if (src_type == base_type) {
-								valid = true;
-								break;
-							}
-							src_type = src_type->get_base_script().ptr();
-						}
+						bool valid = GDScriptDataType::is_script_subtype(src_type, base_type);
 
 						if (!valid) {
 							err_text = "Trying to assign value of type '" + val_obj->get_script_instance()->get_script()->get_path().get_file() +
@@ -1994,7 +2226,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				Object *src_obj = src->operator Object *();
 
-				if (src_obj && !ClassDB::is_parent_class(src_obj->get_class_name(), nc->get_name())) {
+				if (src_obj && !GDScriptDataType::is_native_subtype(src_obj->get_class_name(), nc->get_name())) {
 					*dst = Variant(); // invalid cast, assign NULL
 				} else {
 					*dst = *src;
@@ -2033,13 +2265,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					if (scr_inst) {
 						Script *src_type = src->operator Object *()->get_script_instance()->get_script().ptr();
 
-						while (src_type) {
-							if (src_type == base_type) {
-								valid = true;
-								break;
-							}
-							src_type = src_type->get_base_script().ptr();
-						}
+						valid = GDScriptDataType::is_script_subtype(src_type, base_type);
 					}
 				}
 
@@ -2124,6 +2350,34 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CONSTRUCT_SCRATCH_ARRAY) {
+				LOAD_INSTRUCTION_ARGS
+				CHECK_SPACE(1 + instr_arg_count);
+				ip += instr_arg_count;
+
+				int argc = _code_ptr[ip + 1];
+
+				// The scratch slot keeps the array between evaluations, so only the elements are replaced.
+				GET_INSTRUCTION_ARG(scratch, argc);
+				if (scratch->get_type() != Variant::ARRAY) {
+					*scratch = Array();
+				}
+				Array *array = VariantInternal::get_array(scratch);
+				array->resize(argc);
+
+				for (int i = 0; i < argc; i++) {
+					(*array)[i] = *(instruction_args[i]);
+				}
+
+				GET_INSTRUCTION_ARG(dst, argc + 1);
+				*dst = Variant(); // Clear potential previous typed array.
+
+				*dst = *scratch;
+
+				ip += 2;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_CONSTRUCT_TYPED_ARRAY) {
 				LOAD_INSTRUCTION_ARGS
 				CHECK_SPACE(3 + instr_arg_count);
@@ -2220,8 +2474,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
-			OPCODE(OPCODE_CALL) {
-				bool call_ret = (_code_ptr[ip]) != OPCODE_CALL;
+			OPCODE(OPCODE_CALL)
+			OPCODE(OPCODE_CALL_SCRIPT_RETURN)
+			OPCODE(OPCODE_CALL_SCRIPT) {
+				const int call_ip = ip;
+				bool call_ret = (_code_ptr[ip]) != OPCODE_CALL && (_code_ptr[ip]) != OPCODE_CALL_SCRIPT;
+				bool script_call = (_code_ptr[ip]) == OPCODE_CALL_SCRIPT || (_code_ptr[ip]) == OPCODE_CALL_SCRIPT_RETURN;
 	#ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 	#endif
@@ -2271,7 +2529,34 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				MethodBind *method_from_cache = nullptr;
 				int hit_slot = -1;
 
-				if (base_obj) {
+				if (script_call) {
+					// Devirtualized script method call. The cache holds the script the call site is bound
+					// to, the resolved function and the hierarchy epoch they were resolved in.
+					ScriptInstance *script_instance = base_obj ? base_obj->get_script_instance() : nullptr;
+					if (script_instance && !script_instance->is_placeholder() && script_instance->get_language() == GDScriptLanguage::get_singleton()) {
+						GDScriptInstance *gds_instance = static_cast<GDScriptInstance *>(script_instance);
+						GDScript **cached_key_slot = reinterpret_cast<GDScript **>(&_code_ptr[ip + 3]);
+						GDScriptFunction **cached_function_slot = reinterpret_cast<GDScriptFunction **>(&_code_ptr[ip + 3 + k_inline_cache_ptr_slots]);
+						uint32_t *cached_epoch_slot = reinterpret_cast<uint32_t *>(&_code_ptr[ip + 3 + k_inline_cache_ptr_slots * 2]);
+
+						uint32_t epoch = GDScriptLanguage::get_singleton()->get_script_hierarchy_epoch();
+						if (*cached_epoch_slot != epoch) {
+							*cached_function_slot = GDScriptLanguage::get_singleton()->devirtualize_method(gds_instance->script.ptr(), *methodname, cached_key_slot);
+							*cached_epoch_slot = epoch;
+						}
+
+						// Receivers outside the bound subtree take the dynamic path until the next epoch.
+						GDScriptFunction *direct_function = *cached_function_slot;
+						if (direct_function && gds_instance->script->is_subclass_of(*cached_key_slot)) {
+							used_cached_call = true;
+							const uint64_t borrowed_args = _get_borrowed_args(direct_function, (const Variant **)argptrs, argc, stack, _stack_size, _constants_ptr, _constant_count);
+							temp_ret = direct_function->call(gds_instance, (const Variant **)argptrs, argc, err, nullptr, borrowed_args);
+							if (call_ret && ret_ptr) {
+								*ret_ptr = temp_ret;
+							}
+						}
+					}
+				} else if (base_obj) {
 					ClassDB::ClassInfo *info = ClassDB::classes.getptr(base_obj->get_class_name());
 					for (int i = 0; i < k_inline_cache_pic_size; i++) {
 						if (cached_class_slot[i] == info) {
@@ -2402,6 +2687,72 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif // DEBUG_ENABLED
 
+				if (!script_call && !base_obj && base_type != Variant::NIL && base_type != Variant::OBJECT && err.error == Callable::CallError::CALL_OK &&
+						(_code_ptr[call_ip] == OPCODE_CALL || _code_ptr[call_ip] == OPCODE_CALL_RETURN) && _speculation_failures.get() < MAX_SPECULATION_FAILURES) {
+					int *cache = &_code_ptr[ip + 3];
+					uint32_t argument_types = 0;
+					for (int i = 0; i < argc && i < 4; i++) {
+						argument_types |= argptrs[i]->get_type() << (i * 8);
+					}
+					if (unlikely(_observe_builtin_receiver(cache, base_type, argument_types))) {
+						Speculation speculation;
+						if (_make_builtin_call_speculation(base_type, *methodname, argc, argument_types, call_ret, speculation)) {
+							_publish_speculation(_code_ptr, call_ip, cache, _add_speculation(speculation), OPCODE_CALL_BUILTIN_SPECULATED);
+						} else {
+							_reset_feedback(cache);
+						}
+					}
+				}
+
+				ip += 3 + _call_ic_ints;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_CALL_BUILTIN_SPECULATED) {
+				const int call_ip = ip;
+				LOAD_INSTRUCTION_ARGS
+				constexpr int _call_ic_ints = k_inline_cache_pic_size * k_inline_cache_ptr_slots * 2;
+				CHECK_SPACE(3 + instr_arg_count + _call_ic_ints);
+
+				ip += instr_arg_count;
+
+				int argc = _code_ptr[ip + 1];
+				GD_ERR_BREAK(argc < 0);
+
+				GET_INSTRUCTION_ARG(base, argc);
+				Variant **argptrs = instruction_args;
+
+				int *cache = &_code_ptr[ip + 3];
+				const Speculation *speculation = _get_speculation(_get_speculation_slots(cache)[2].load(std::memory_order_acquire));
+				if (unlikely(speculation == nullptr)) {
+					ip = call_ip;
+					DISPATCH_OPCODE; // Published before the opcode, visible on the next read.
+				}
+				// Like `Variant::callp()`, read-only receivers only take const methods, the generic path reports it.
+				bool guard_ok = base->get_type() == speculation->receiver_type && (speculation->is_const || !base->is_read_only());
+				for (int i = 0; guard_ok && i < argc; i++) {
+					const Variant::Type arg_type = (Variant::Type)((speculation->argument_types >> (i * 8)) & 0xFF);
+					guard_ok = arg_type == Variant::NIL || argptrs[i]->get_type() == arg_type;
+				}
+
+				if (unlikely(!guard_ok)) {
+					// Deoptimize, the generic opcode runs this instruction again.
+					_reset_feedback(cache);
+					_speculation_failures.increment();
+					ip = call_ip;
+					_set_opcode(_code_ptr, ip, speculation->call_return ? OPCODE_CALL_RETURN : OPCODE_CALL);
+					DISPATCH_OPCODE;
+				}
+
+				const bool call_ret = speculation->call_return;
+				Variant ret;
+				VariantInternal::initialize(&ret, speculation->return_type);
+				speculation->method(base, (const Variant **)argptrs, argc, &ret);
+				if (call_ret) {
+					GET_INSTRUCTION_ARG(ret_arg, argc + 1);
+					*ret_arg = ret;
+				}
+
 				ip += 3 + _call_ic_ints;
 			}
 			DISPATCH_OPCODE;
@@ -2858,7 +3209,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #ifdef DEBUG_ENABLED
 				if (err.error != Callable::CallError::CALL_OK) {
-					String methodstr = gds_utilities_names[_code_ptr[ip + 2]];
+					String methodstr = _get_gds_utility_name(_code_ptr[ip + 2]);
 					if (dst->get_type() == Variant::STRING && !dst->operator String().is_empty()) {
 						// Call provided error string.
 						err_text = vformat(R"*(Error calling GDScript utility function "%s()": %s)*", methodstr, *dst);
@@ -2910,7 +3261,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 
 				if (E) {
-					*dst = E->value->call(p_instance, (const Variant **)argptrs, argc, err);
+					const uint64_t borrowed_args = _get_borrowed_args(E->value, (const Variant **)argptrs, argc, stack, _stack_size, _constants_ptr, _constant_count);
+					*dst = E->value->call(p_instance, (const Variant **)argptrs, argc, err, nullptr, borrowed_args);
 				} else if (gds->native.ptr()) {
 					if (*methodname != GDScriptLanguage::get_singleton()->strings._init) {
 						MethodBind *mb = ClassDB::get_method(gds->native->get_name(), *methodname);
@@ -3122,6 +3474,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
 				ip = to;
+				JIT_RESUME_AT_TARGET;
 			}
 			DISPATCH_OPCODE;
 
@@ -3136,6 +3489,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					int to = _code_ptr[ip + 2];
 					GD_ERR_BREAK(to < 0 || to > _code_size);
 					ip = to;
+					JIT_RESUME_AT_TARGET;
 				} else {
 					ip += 3;
 				}
@@ -3153,6 +3507,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					int to = _code_ptr[ip + 2];
 					GD_ERR_BREAK(to < 0 || to > _code_size);
 					ip = to;
+					JIT_RESUME_AT_TARGET;
 				} else {
 					ip += 3;
 				}
@@ -3327,7 +3682,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #else
 				Object *ret_obj = r->operator Object *();
 #endif // DEBUG_ENABLED
-				if (ret_obj && !ClassDB::is_parent_class(ret_obj->get_class_name(), nc->get_name())) {
+				if (ret_obj && !GDScriptDataType::is_native_subtype(ret_obj->get_class_name(), nc->get_name())) {
 #ifdef DEBUG_ENABLED
 					err_text = vformat(R"(Trying to return value of type "%s" from a function whose return type is "%s".)",
 							ret_obj->get_class_name(), nc->get_name());
@@ -3381,15 +3736,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 
 					Script *ret_type = ret_obj->get_script_instance()->get_script().ptr();
-					bool valid = false;
-
-					while (ret_type) {
-						if (ret_type == base_type) {
-							valid = true;
-							break;
-						}
-						ret_type = ret_type->get_base_script().ptr();
-					}
+					bool valid = GDScriptDataType::is_script_subtype(ret_type, base_type);
 
 					if (!valid) {
 #ifdef DEBUG_ENABLED
@@ -4288,35 +4635,46 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_LINE_BREAKPOINT)
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
+				// `OPCODE_LINE` with a breakpoint set on its line, see `update_breakpoint_traps()`.
+				const bool trap = _code_ptr[ip] == OPCODE_LINE_BREAKPOINT;
+
+				if (!trap && jit_code && jit_code->has_entry(ip)) {
+					// Back from an instruction the compiled code doesn't handle.
+					ip = jit_code->run(&jit_frame, ip);
+					DISPATCH_OPCODE;
+				}
+
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+#ifdef DEBUG_ENABLED
+				// Release builds never run with the debugger.
 				if (EngineDebugger::is_active()) {
-					// line
-					bool do_break = false;
+					ScriptDebugger *script_debugger = EngineDebugger::get_script_debugger();
+
+					// The trap may be stale if breakpoints changed since the last sync, so confirm it.
+					bool do_break = unlikely(trap) && script_debugger->is_breakpoint(line, source);
 
-					if (unlikely(EngineDebugger::get_script_debugger()->get_lines_left() > 0)) {
-						if (EngineDebugger::get_script_debugger()->get_depth() <= 0) {
-							EngineDebugger::get_script_debugger()->set_lines_left(EngineDebugger::get_script_debugger()->get_lines_left() - 1);
+					if (unlikely(script_debugger->get_lines_left() > 0)) {
+						if (script_debugger->get_depth() <= 0) {
+							script_debugger->set_lines_left(script_debugger->get_lines_left() - 1);
 						}
-						if (EngineDebugger::get_script_debugger()->get_lines_left() <= 0) {
+						if (script_debugger->get_lines_left() <= 0) {
 							do_break = true;
 						}
 					}
 
-					if (EngineDebugger::get_script_debugger()->is_breakpoint(line, source)) {
-						do_break = true;
-					}
-
 					if (unlikely(do_break)) {
 						GDScriptLanguage::get_singleton()->debug_break("Breakpoint", true);
 					}
 
-					EngineDebugger::get_singleton()->line_poll();
+					GDScriptLanguage::get_singleton()->debug_line_poll();
 				}
+#endif
 			}
 			DISPATCH_OPCODE;
 
@@ -4379,6 +4737,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		profile.self_time.add(time_taken - function_call_time);
 		profile.frame_total_time.add(time_taken);
 		profile.frame_self_time.add(time_taken - function_call_time);
+		_profile_touch(); // The call may have started before the last frame flip.
 		if (Thread::get_caller_id() == Thread::get_main_id()) {
 			GDScriptLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
 		}
@@ -4391,6 +4750,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	if (!p_state || awaited) {
 		GDScriptLanguage::get_singleton()->exit_function();
 
+		// Borrowed arguments still belong to the caller, forget them instead of releasing them.
+		for (int i = 0; borrowed_slots != 0; i++) {
+			if (borrowed_slots & (uint64_t(1) << i)) {
+				memnew_placement(&stack[i + FIXED_ADDRESSES_MAX], Variant);
+				borrowed_slots &= ~(uint64_t(1) << i);
+			}
+		}
+
 		// Free stack, except reserved addresses.
 		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
 			stack[i].~Variant();
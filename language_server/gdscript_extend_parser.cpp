@@ -649,71 +649,49 @@ void ExtendGDScriptParser::parse_function_symbol(const GDScriptParser::FunctionN
 	}
 }
 
-String ExtendGDScriptParser::get_text_for_completion(const LSP::Position &p_cursor) const {
-	String longthing;
-	int len = lines.size();
-	for (int i = 0; i < len; i++) {
-		if (i == p_cursor.line) {
-			longthing += lines[i].substr(0, p_cursor.character);
-			longthing += String::chr(0xFFFF); // Not unicode, represents the cursor.
-			longthing += lines[i].substr(p_cursor.character);
-		} else {
-			longthing += lines[i];
-		}
-
-		if (i != len - 1) {
-			longthing += "\n";
-		}
+String ExtendGDScriptParser::get_text_for_lookup_symbol(const LSP::Position &p_cursor, const String &p_symbol, bool p_func_required, LSP::Position &r_cursor) const {
+	r_cursor = p_cursor;
+	if (p_cursor.line < 0 || p_cursor.line >= lines.size()) {
+		return code;
 	}
 
-	return longthing;
-}
-
-String ExtendGDScriptParser::get_text_for_lookup_symbol(const LSP::Position &p_cursor, const String &p_symbol, bool p_func_required) const {
-	String longthing;
-	int len = lines.size();
-	for (int i = 0; i < len; i++) {
-		if (i == p_cursor.line) {
-			// This code tries to insert the symbol into the preexisting code. Due to using a simple
-			// algorithm, the results might not always match the option semantically (e.g. different
-			// identifier name). This is fine because symbol lookup will prioritize the provided
-			// symbol name over the actual code. Establishing a syntactic target (e.g. identifier)
-			// is usually sufficient.
-
-			String line = lines[i];
-			String first_part = line.substr(0, p_cursor.character);
-			String last_part = line.substr(p_cursor.character, lines[i].length());
-			if (!p_symbol.is_empty()) {
-				String left_cursor_text;
-				for (int c = p_cursor.character - 1; c >= 0; c--) {
-					left_cursor_text = line.substr(c, p_cursor.character - c);
-					if (p_symbol.begins_with(left_cursor_text)) {
-						first_part = line.substr(0, c);
-						first_part += p_symbol;
-						break;
-					} else if (c == 0) {
-						// No preexisting code that matches the option. Insert option in place.
-						first_part += p_symbol;
-					}
-				}
-			}
-
-			longthing += first_part;
-			longthing += String::chr(0xFFFF); // Not unicode, represents the cursor.
-			if (p_func_required) {
-				longthing += "("; // Tell the parser this is a function call.
+	// This code tries to insert the symbol into the preexisting code. Due to using a simple
+	// algorithm, the results might not always match the option semantically (e.g. different
+	// identifier name). This is fine because symbol lookup will prioritize the provided
+	// symbol name over the actual code. Establishing a syntactic target (e.g. identifier)
+	// is usually sufficient.
+
+	const String &line = lines[p_cursor.line];
+	String first_part = line.substr(0, p_cursor.character);
+	String last_part = line.substr(p_cursor.character, line.length());
+	if (!p_symbol.is_empty()) {
+		String left_cursor_text;
+		for (int c = p_cursor.character - 1; c >= 0; c--) {
+			left_cursor_text = line.substr(c, p_cursor.character - c);
+			if (p_symbol.begins_with(left_cursor_text)) {
+				first_part = line.substr(0, c);
+				first_part += p_symbol;
+				break;
+			} else if (c == 0) {
+				// No preexisting code that matches the option. Insert option in place.
+				first_part += p_symbol;
 			}
-			longthing += last_part;
-		} else {
-			longthing += lines[i];
 		}
+	}
+	r_cursor.character = first_part.length();
 
-		if (i != len - 1) {
-			longthing += "\n";
-		}
+	if (p_func_required) {
+		first_part += "("; // Tell the parser this is a function call.
+	}
+
+	// Only the cursor line changes, so splice it into the document text.
+	int line_start = 0;
+	for (int i = 0; i < p_cursor.line; i++) {
+		line_start += lines[i].length() + 1;
 	}
+	const int line_end = line_start + line.length();
 
-	return longthing;
+	return code.substr(0, line_start) + first_part + last_part + code.substr(line_end);
 }
 
 String ExtendGDScriptParser::get_identifier_under_position(const LSP::Position &p_position, LSP::Range &r_range) const {
@@ -1056,6 +1034,7 @@ Dictionary ExtendGDScriptParser::generate_api() const {
 
 void ExtendGDScriptParser::parse(const String &p_code, const String &p_path) {
 	path = p_path;
+	code = p_code;
 	lines = p_code.split("\n");
 
 	parse_result = GDScriptParser::parse(p_code, p_path, false);
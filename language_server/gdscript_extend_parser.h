@@ -112,6 +112,7 @@ struct GodotRange {
 
 class ExtendGDScriptParser : public GDScriptParser {
 	String path;
+	String code;
 	Vector<String> lines;
 
 	LSP::DocumentSymbol class_symbol;
@@ -138,6 +139,7 @@ class ExtendGDScriptParser : public GDScriptParser {
 
 public:
 	_FORCE_INLINE_ const String &get_path() const { return path; }
+	_FORCE_INLINE_ const String &get_code() const { return code; }
 	_FORCE_INLINE_ const Vector<String> &get_lines() const { return lines; }
 	_FORCE_INLINE_ const LSP::DocumentSymbol &get_symbols() const { return class_symbol; }
 	_FORCE_INLINE_ const Vector<LSP::Diagnostic> &get_diagnostics() const { return diagnostics; }
@@ -147,8 +149,8 @@ public:
 
 	Error get_left_function_call(const LSP::Position &p_position, LSP::Position &r_func_pos, int &r_arg_index) const;
 
-	String get_text_for_completion(const LSP::Position &p_cursor) const;
-	String get_text_for_lookup_symbol(const LSP::Position &p_cursor, const String &p_symbol = "", bool p_func_required = false) const;
+	// Returns the document with `p_symbol` inserted at `p_cursor`, and the cursor position after it in `r_cursor`.
+	String get_text_for_lookup_symbol(const LSP::Position &p_cursor, const String &p_symbol, bool p_func_required, LSP::Position &r_cursor) const;
 	String get_identifier_under_position(const LSP::Position &p_position, LSP::Range &r_range) const;
 	String get_uri() const;
 
@@ -31,6 +31,7 @@
 #include "gdscript_language_protocol.h"
 
 #include "core/config/project_settings.h"
+#include "core/io/json.h"
 #include "editor/doc/doc_tools.h"
 #include "editor/doc/editor_help.h"
 #include "editor/editor_log.h"
@@ -53,84 +54,120 @@
 
 GDScriptLanguageProtocol *GDScriptLanguageProtocol::singleton = nullptr;
 
-Error GDScriptLanguageProtocol::LSPeer::handle_data() {
+Error GDScriptLanguageProtocol::LSPeer::read_data() {
+	const int available = connection->get_available_bytes();
+	if (available <= 0) {
+		return ERR_BUSY;
+	}
+
+	const uint32_t old_size = req_buf.size();
+	req_buf.resize(old_size + available);
 	int read = 0;
-	// Read headers
-	if (!has_header) {
-		while (true) {
-			if (req_pos >= LSP_MAX_BUFFER_SIZE) {
-				req_pos = 0;
-				ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Response header too big");
-			}
-			Error err = connection->get_partial_data(&req_buf[req_pos], 1, read);
-			if (err != OK) {
-				return FAILED;
-			} else if (read != 1) { // Busy, wait until next poll
-				return ERR_BUSY;
-			}
-			char *r = (char *)req_buf;
-			int l = req_pos;
-
-			// End of headers
-			if (l > 3 && r[l] == '\n' && r[l - 1] == '\r' && r[l - 2] == '\n' && r[l - 3] == '\r') {
-				r[l - 3] = '\0'; // Null terminate to read string
-				String header = String::utf8(r);
-				content_length = header.substr(16).to_int();
-				has_header = true;
-				req_pos = 0;
-				break;
-			}
-			req_pos++;
-		}
+	Error err = connection->get_partial_data(req_buf.ptr() + old_size, available, read);
+	req_buf.resize(old_size + read);
+	if (err != OK) {
+		return FAILED;
 	}
+
+	return scan_header();
+}
+
+Error GDScriptLanguageProtocol::LSPeer::scan_header() {
 	if (has_header) {
-		while (req_pos < content_length) {
-			if (req_pos >= LSP_MAX_BUFFER_SIZE) {
-				req_pos = 0;
-				has_header = false;
-				ERR_FAIL_COND_V_MSG(req_pos >= LSP_MAX_BUFFER_SIZE, ERR_OUT_OF_MEMORY, "Response content too big");
-			}
-			Error err = connection->get_partial_data(&req_buf[req_pos], 1, read);
-			if (err != OK) {
-				return FAILED;
-			} else if (read != 1) {
-				return ERR_BUSY;
-			}
-			req_pos++;
+		return OK;
+	}
+
+	// Look for the end of the header, resuming where the last read stopped.
+	const uint8_t *r = req_buf.ptr();
+	for (uint32_t i = MAX(req_scan_pos, 3u); i < req_buf.size(); i++) {
+		if (r[i] != '\n' || r[i - 1] != '\r' || r[i - 2] != '\n' || r[i - 3] != '\r') {
+			continue;
 		}
 
-		// Parse data
-		String msg = String::utf8((const char *)req_buf, req_pos);
+		content_length = 0;
+		bool found_length = false;
+		const Vector<String> fields = String::utf8((const char *)r, i - 3).split("\r\n");
+		for (const String &field : fields) {
+			if (field.to_lower().begins_with("content-length:")) {
+				content_length = field.get_slicec(':', 1).strip_edges().to_int();
+				found_length = true;
+			}
+		}
+		if (!found_length || content_length > LSP_MAX_MESSAGE_SIZE) {
+			req_buf.clear();
+			req_scan_pos = 0;
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, "LSP: Invalid or too big request header.");
+		}
 
-		// Reset to read again
-		req_pos = 0;
-		has_header = false;
+		has_header = true;
+		content_start = i + 1;
+		break;
+	}
 
-		// Response
-		String output = GDScriptLanguageProtocol::get_singleton()->process_message(msg);
-		if (!output.is_empty()) {
-			res_queue.push_back(output.utf8());
-		}
+	if (!has_header) {
+		req_scan_pos = req_buf.size();
+		ERR_FAIL_COND_V_MSG(req_buf.size() > 4096, ERR_INVALID_DATA, "LSP: Request header too big.");
 	}
+
 	return OK;
 }
 
+bool GDScriptLanguageProtocol::LSPeer::has_message() const {
+	return has_header && req_buf.size() - content_start >= content_length;
+}
+
+Error GDScriptLanguageProtocol::LSPeer::handle_data() {
+	ERR_FAIL_COND_V(!has_message(), ERR_BUSY);
+
+	// Decode straight from the receive buffer.
+	String msg = String::utf8((const char *)req_buf.ptr() + content_start, content_length);
+
+	// Keep bytes from the next message, if any were already received.
+	const uint32_t consumed = content_start + content_length;
+	const uint32_t remaining = req_buf.size() - consumed;
+	if (remaining > 0) {
+		memmove(req_buf.ptr(), req_buf.ptr() + consumed, remaining);
+	}
+	req_buf.resize(remaining);
+	req_scan_pos = 0;
+	has_header = false;
+
+	GDScriptLanguageProtocol::get_singleton()->schedule_message(msg);
+
+	// The next message may already have arrived with this one.
+	return scan_header();
+}
+
+void GDScriptLanguageProtocol::LSPeer::queue_message(const Variant &p_message) {
+	// Encode the content straight into the queue, then prepend the header once its length is known.
+	List<LocalVector<uint8_t>>::Element *header = res_queue.push_back(LocalVector<uint8_t>());
+	LocalVector<uint8_t> &content = res_queue.push_back(LocalVector<uint8_t>())->get();
+	GDScriptLanguageProtocol::encode_json(p_message, content);
+
+	const CharString header_text = ("Content-Length: " + itos(content.size()) + "\r\n\r\n").ascii();
+	header->get().resize(header_text.length());
+	memcpy(header->get().ptr(), header_text.get_data(), header_text.length());
+
+	res_pending += header->get().size() + content.size();
+}
+
 Error GDScriptLanguageProtocol::LSPeer::send_data() {
-	int sent = 0;
 	while (!res_queue.is_empty()) {
-		CharString c_res = res_queue[0];
-		if (res_sent < c_res.size()) {
-			Error err = connection->put_partial_data((const uint8_t *)c_res.get_data() + res_sent, c_res.size() - res_sent - 1, sent);
+		const LocalVector<uint8_t> &chunk = res_queue.front()->get();
+		if (res_sent < chunk.size()) {
+			int sent = 0;
+			Error err = connection->put_partial_data(chunk.ptr() + res_sent, chunk.size() - res_sent, sent);
 			if (err != OK) {
 				return err;
 			}
 			res_sent += sent;
+			res_pending -= sent;
+			if (res_sent < chunk.size()) {
+				return ERR_BUSY; // Socket is full, continue on next poll.
+			}
 		}
-		// Response sent
-		if (res_sent >= c_res.size() - 1) {
-			res_sent = 0;
-			res_queue.remove_at(0);
-		}
+		res_sent = 0;
+		res_queue.pop_front();
 	}
 	return OK;
 }
@@ -151,23 +188,293 @@ void GDScriptLanguageProtocol::on_client_disconnected(const int &p_client_id) {
 	EditorNode::get_log()->add_message("[LSP] Disconnected", EditorLog::MSG_TYPE_EDITOR);
 }
 
-String GDScriptLanguageProtocol::process_message(const String &p_text) {
-	String ret = process_string(p_text);
-	if (ret.is_empty()) {
-		return ret;
-	} else {
-		return format_output(ret);
+static String _get_request_uri(const Variant &p_params) {
+	if (p_params.get_type() != Variant::DICTIONARY) {
+		return String();
+	}
+	const Variant document = p_params.operator Dictionary().get("textDocument", Variant());
+	if (document.get_type() != Variant::DICTIONARY) {
+		return String();
+	}
+	return document.operator Dictionary().get("uri", String());
+}
+
+void GDScriptLanguageProtocol::schedule_message(const String &p_text) {
+	if (p_text.is_empty()) {
+		return;
+	}
+
+	JSON json;
+	if (json.parse(p_text) != OK) {
+		send_to_client(latest_client_id, make_response_error(JSONRPC::PARSE_ERROR, "Parse error"));
+		return;
+	}
+
+	const Variant data = json.get_data();
+	if (data.get_type() != Variant::DICTIONARY || !data.operator Dictionary().has("method")) {
+		// Batches and responses to our own requests are handled right away.
+		send_to_client(latest_client_id, process_action(data, true));
+		return;
+	}
+
+	const Dictionary message = data;
+	const String method = message["method"];
+	const Variant params = message.get("params", Variant());
+
+	if (!message.has("id")) {
+		// Notifications change the server state, so they are handled in the order they arrive.
+		if (method == "$/cancelRequest") {
+			if (params.get_type() == Variant::DICTIONARY) {
+				cancel_request(latest_client_id, params.operator Dictionary().get("id", Variant()));
+			}
+			return;
+		}
+		if (method == "textDocument/didChange" || method == "textDocument/didClose") {
+			invalidate_requests(latest_client_id, _get_request_uri(params));
+		}
+		send_to_client(latest_client_id, process_action(message, true));
+		return;
+	}
+
+	PendingRequest request;
+	request.client_id = latest_client_id;
+	request.id = message["id"];
+	request.method = method;
+	request.uri = _get_request_uri(params);
+	request.message = message;
+
+	const RequestPriority *priority = request_priorities.getptr(method);
+	pending_requests[priority ? *priority : PRIORITY_NORMAL].push_back(request);
+}
+
+void GDScriptLanguageProtocol::send_to_client(int p_client_id, const Variant &p_message) {
+	if (p_message.get_type() == Variant::NIL) {
+		return;
+	}
+	HashMap<int, Ref<LSPeer>>::Iterator E = clients.find(p_client_id);
+	if (E && E->value.is_valid()) {
+		E->value->queue_message(p_message);
+	}
+}
+
+void GDScriptLanguageProtocol::cancel_request(int p_client_id, const Variant &p_id) {
+	for (List<PendingRequest> &queue : pending_requests) {
+		for (List<PendingRequest>::Element *E = queue.front(); E; E = E->next()) {
+			if (E->get().client_id == p_client_id && E->get().id == p_id) {
+				send_to_client(p_client_id, make_response_error(RequestCancelled, "Request cancelled.", p_id));
+				queue.erase(E);
+				return;
+			}
+		}
+	}
+
+	// Snapshot queries can't be interrupted, but their result is replaced by the cancellation error.
+	for (SnapshotJob *job : snapshot_jobs) {
+		if (job->client_id == p_client_id && job->id == p_id) {
+			job->cancelled.set();
+			return;
+		}
+	}
+}
+
+void GDScriptLanguageProtocol::invalidate_requests(int p_client_id, const String &p_uri) {
+	if (p_uri.is_empty()) {
+		return;
+	}
+
+	// Positions in requests sent before the change don't match the new content anymore.
+	for (List<PendingRequest> &queue : pending_requests) {
+		List<PendingRequest>::Element *E = queue.front();
+		while (E) {
+			List<PendingRequest>::Element *N = E->next();
+			if (E->get().client_id == p_client_id && E->get().uri == p_uri) {
+				send_to_client(p_client_id, make_response_error(ContentModified, "Content modified.", E->get().id));
+				queue.erase(E);
+			}
+			E = N;
+		}
 	}
 }
 
-String GDScriptLanguageProtocol::format_output(const String &p_text) {
-	String header = "Content-Length: ";
-	CharString charstr = p_text.utf8();
-	size_t len = charstr.length();
-	header += itos(len);
-	header += "\r\n\r\n";
+void GDScriptLanguageProtocol::run_request(const PendingRequest &p_request) {
+	latest_client_id = p_request.client_id;
+
+	HashMap<String, SnapshotQuery>::ConstIterator query = snapshot_queries.find(p_request.method);
+	if (query && !p_request.uri.is_empty()) {
+		// Parsing must happen here, only reading the result is safe on other threads.
+		const ExtendGDScriptParser *parser = get_parse_result(workspace->get_file_path(p_request.uri));
+		if (parser) {
+			SnapshotJob *job = memnew(SnapshotJob);
+			job->peer = clients.get(p_request.client_id);
+			job->client_id = p_request.client_id;
+			job->id = p_request.id;
+			job->parser = parser;
+			job->query = query->value;
+			job->params = p_request.message.get("params", Dictionary());
+			job->peer->pin_parser(parser);
+			job->task_id = WorkerThreadPool::get_singleton()->add_native_task(&GDScriptLanguageProtocol::run_snapshot_job, job, true, "GDScript LSP " + p_request.method);
+			snapshot_jobs.push_back(job);
+			return;
+		}
+	}
 
-	return header + p_text;
+	send_to_client(p_request.client_id, process_action(p_request.message, true));
+}
+
+void GDScriptLanguageProtocol::run_pending_requests(uint64_t p_target_ticks) {
+	bool ran = false;
+	for (List<PendingRequest> &queue : pending_requests) {
+		while (!queue.is_empty()) {
+			// Always make progress, even if reading the requests used up the time budget.
+			if (ran && OS::get_singleton()->get_ticks_usec() >= p_target_ticks) {
+				return;
+			}
+
+			const PendingRequest request = queue.front()->get();
+			queue.pop_front();
+			if (!clients.has(request.client_id)) {
+				continue;
+			}
+			run_request(request);
+			ran = true;
+		}
+	}
+}
+
+void GDScriptLanguageProtocol::run_snapshot_job(void *p_userdata) {
+	SnapshotJob *job = static_cast<SnapshotJob *>(p_userdata);
+	if (!job->cancelled.is_set()) {
+		job->result = job->query(job->parser, job->params);
+	}
+}
+
+void GDScriptLanguageProtocol::finish_snapshot_jobs(bool p_wait) {
+	uint32_t i = 0;
+	while (i < snapshot_jobs.size()) {
+		SnapshotJob *job = snapshot_jobs[i];
+		if (!p_wait && !WorkerThreadPool::get_singleton()->is_task_completed(job->task_id)) {
+			i++;
+			continue;
+		}
+
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(job->task_id);
+		if (job->cancelled.is_set()) {
+			send_to_client(job->client_id, make_response_error(RequestCancelled, "Request cancelled.", job->id));
+		} else {
+			send_to_client(job->client_id, make_response(job->result, job->id));
+		}
+
+		// The peer may be gone already, in which case this frees it along with its parsers.
+		job->peer->unpin_parser(job->parser);
+		memdelete(job);
+		snapshot_jobs.remove_at(i);
+	}
+}
+
+static void _encode_json_ascii(const char *p_text, LocalVector<uint8_t> &r_buffer) {
+	while (*p_text) {
+		r_buffer.push_back(*p_text++);
+	}
+}
+
+static void _encode_json_string(const String &p_string, LocalVector<uint8_t> &r_buffer) {
+	static const char hex[] = "0123456789abcdef";
+
+	r_buffer.push_back('"');
+	const char32_t *chars = p_string.ptr();
+	for (int i = 0; i < p_string.length(); i++) {
+		const char32_t c = chars[i];
+		switch (c) {
+			case '"':
+				_encode_json_ascii("\\\"", r_buffer);
+				break;
+			case '\\':
+				_encode_json_ascii("\\\\", r_buffer);
+				break;
+			case '\n':
+				_encode_json_ascii("\\n", r_buffer);
+				break;
+			case '\r':
+				_encode_json_ascii("\\r", r_buffer);
+				break;
+			case '\t':
+				_encode_json_ascii("\\t", r_buffer);
+				break;
+			default:
+				if (c < 0x20) {
+					_encode_json_ascii("\\u00", r_buffer);
+					r_buffer.push_back(hex[c >> 4]);
+					r_buffer.push_back(hex[c & 0xF]);
+				} else if (c < 0x80) {
+					r_buffer.push_back(c);
+				} else if (c < 0x800) {
+					r_buffer.push_back(0xC0 | (c >> 6));
+					r_buffer.push_back(0x80 | (c & 0x3F));
+				} else if (c < 0x10000) {
+					r_buffer.push_back(0xE0 | (c >> 12));
+					r_buffer.push_back(0x80 | ((c >> 6) & 0x3F));
+					r_buffer.push_back(0x80 | (c & 0x3F));
+				} else {
+					r_buffer.push_back(0xF0 | (c >> 18));
+					r_buffer.push_back(0x80 | ((c >> 12) & 0x3F));
+					r_buffer.push_back(0x80 | ((c >> 6) & 0x3F));
+					r_buffer.push_back(0x80 | (c & 0x3F));
+				}
+				break;
+		}
+	}
+	r_buffer.push_back('"');
+}
+
+// Writes `p_value` as UTF-8 JSON, without building an intermediate `String` for the whole message.
+void GDScriptLanguageProtocol::encode_json(const Variant &p_value, LocalVector<uint8_t> &r_buffer) {
+	switch (p_value.get_type()) {
+		case Variant::NIL: {
+			_encode_json_ascii("null", r_buffer);
+		} break;
+		case Variant::BOOL: {
+			_encode_json_ascii(p_value.operator bool() ? "true" : "false", r_buffer);
+		} break;
+		case Variant::INT: {
+			_encode_json_ascii(itos(p_value).ascii().get_data(), r_buffer);
+		} break;
+		case Variant::STRING:
+		case Variant::STRING_NAME:
+		case Variant::NODE_PATH: {
+			_encode_json_string(p_value, r_buffer);
+		} break;
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			r_buffer.push_back('[');
+			for (int i = 0; i < array.size(); i++) {
+				if (i > 0) {
+					r_buffer.push_back(',');
+				}
+				encode_json(array[i], r_buffer);
+			}
+			r_buffer.push_back(']');
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_value;
+			r_buffer.push_back('{');
+			for (int i = 0; i < dictionary.size(); i++) {
+				if (i > 0) {
+					r_buffer.push_back(',');
+				}
+				_encode_json_string(String(dictionary.get_key_at_index(i)), r_buffer);
+				r_buffer.push_back(':');
+				encode_json(dictionary.get_value_at_index(i), r_buffer);
+			}
+			r_buffer.push_back('}');
+		} break;
+		default: {
+			// Floats and other types are rare in LSP messages, let the JSON class format them.
+			const CharString text = JSON::stringify(p_value).utf8();
+			for (int i = 0; i < text.length(); i++) {
+				r_buffer.push_back(text[i]);
+			}
+		} break;
+	}
 }
 
 void GDScriptLanguageProtocol::_bind_methods() {
@@ -231,9 +538,7 @@ Dictionary GDScriptLanguageProtocol::initialize(const Dictionary &p_params) {
 				vformat("GDScriptLanguageProtocol: Can't initialize invalid peer '%d'.", latest_client_id));
 		Ref<LSPeer> peer = clients.get(latest_client_id);
 		if (peer.is_valid()) {
-			String msg = Variant(request).to_json_string();
-			msg = format_output(msg);
-			(*peer)->res_queue.push_back(msg.utf8());
+			peer->queue_message(request);
 		}
 	}
 
@@ -280,8 +585,16 @@ void GDScriptLanguageProtocol::poll(int p_limit_usec) {
 			E = clients.begin();
 			continue;
 		} else {
+			// Apply backpressure: leave requests in the socket while responses pile up,
+			// so a client can't make the server buffer an unbounded amount of output.
 			Error err = OK;
-			while (peer->connection->get_available_bytes() > 0) {
+			while (!peer->is_congested()) {
+				if (!peer->has_message()) {
+					err = peer->read_data();
+					if (err != OK || !peer->has_message()) {
+						break;
+					}
+				}
 				latest_client_id = E->key;
 				err = peer->handle_data();
 				if (err != OK || OS::get_singleton()->get_ticks_usec() >= target_ticks) {
@@ -294,13 +607,20 @@ void GDScriptLanguageProtocol::poll(int p_limit_usec) {
 				E = clients.begin();
 				continue;
 			}
+		}
+		++E;
+	}
 
-			err = peer->send_data();
-			if (err != OK && err != ERR_BUSY) {
-				on_client_disconnected(E->key);
-				E = clients.begin();
-				continue;
-			}
+	finish_snapshot_jobs(false);
+	run_pending_requests(target_ticks);
+
+	E = clients.begin();
+	while (E != clients.end()) {
+		Error err = E->value->send_data();
+		if (err != OK && err != ERR_BUSY) {
+			on_client_disconnected(E->key);
+			E = clients.begin();
+			continue;
 		}
 		++E;
 	}
@@ -311,6 +631,11 @@ Error GDScriptLanguageProtocol::start(int p_port, const IPAddress &p_bind_ip) {
 }
 
 void GDScriptLanguageProtocol::stop() {
+	finish_snapshot_jobs(true);
+	for (List<PendingRequest> &queue : pending_requests) {
+		queue.clear();
+	}
+
 	for (const KeyValue<int, Ref<LSPeer>> &E : clients) {
 		Ref<LSPeer> peer = clients.get(E.key);
 		peer->connection->disconnect_from_host();
@@ -334,9 +659,7 @@ void GDScriptLanguageProtocol::notify_client(const String &p_method, const Varia
 	ERR_FAIL_COND(peer.is_null());
 
 	Dictionary message = make_notification(p_method, p_params);
-	String msg = Variant(message).to_json_string();
-	msg = format_output(msg);
-	peer->res_queue.push_back(msg.utf8());
+	peer->queue_message(message);
 }
 
 void GDScriptLanguageProtocol::request_client(const String &p_method, const Variant &p_params, int p_client_id) {
@@ -355,9 +678,7 @@ void GDScriptLanguageProtocol::request_client(const String &p_method, const Vari
 
 	Dictionary message = make_request(p_method, p_params, next_server_id);
 	next_server_id++;
-	String msg = Variant(message).to_json_string();
-	msg = format_output(msg);
-	peer->res_queue.push_back(msg.utf8());
+	peer->queue_message(message);
 }
 
 bool GDScriptLanguageProtocol::is_smart_resolve_enabled() const {
@@ -408,17 +729,51 @@ ExtendGDScriptParser *GDScriptLanguageProtocol::LSPeer::parse_script(const Strin
 void GDScriptLanguageProtocol::LSPeer::remove_cached_parser(const String &p_path) {
 	HashMap<String, ExtendGDScriptParser *>::Iterator cached = parse_results.find(p_path);
 	if (cached) {
-		memdelete(cached->value);
+		free_parser(cached->value);
 		parse_results.remove(cached);
 	}
 
 	HashMap<String, ExtendGDScriptParser *>::Iterator stale = stale_parsers.find(p_path);
 	if (stale) {
-		memdelete(stale->value);
+		free_parser(stale->value);
 		stale_parsers.remove(stale);
 	}
 }
 
+void GDScriptLanguageProtocol::LSPeer::pin_parser(const ExtendGDScriptParser *p_parser) {
+	HashMap<const ExtendGDScriptParser *, int>::Iterator E = pinned_parsers.find(p_parser);
+	if (E) {
+		E->value++;
+	} else {
+		pinned_parsers.insert(p_parser, 1);
+	}
+}
+
+void GDScriptLanguageProtocol::LSPeer::unpin_parser(const ExtendGDScriptParser *p_parser) {
+	HashMap<const ExtendGDScriptParser *, int>::Iterator E = pinned_parsers.find(p_parser);
+	ERR_FAIL_COND(!E);
+	if (--E->value > 0) {
+		return;
+	}
+	pinned_parsers.remove(E);
+
+	for (uint32_t i = 0; i < retired_parsers.size(); i++) {
+		if (retired_parsers[i] == p_parser) {
+			memdelete(retired_parsers[i]);
+			retired_parsers.remove_at_unordered(i);
+			break;
+		}
+	}
+}
+
+void GDScriptLanguageProtocol::LSPeer::free_parser(ExtendGDScriptParser *p_parser) {
+	if (pinned_parsers.has(p_parser)) {
+		retired_parsers.push_back(p_parser);
+	} else {
+		memdelete(p_parser);
+	}
+}
+
 ExtendGDScriptParser *GDScriptLanguageProtocol::get_parse_result(const String &p_path) {
 	LSP_CLIENT_V(nullptr);
 
@@ -537,6 +892,9 @@ GDScriptLanguageProtocol::LSPeer::~LSPeer() {
 	while (!stale_parsers.is_empty()) {
 		remove_cached_parser(stale_parsers.begin()->key);
 	}
+	for (ExtendGDScriptParser *parser : retired_parsers) {
+		memdelete(parser);
+	}
 }
 
 // clang-format off
@@ -578,6 +936,19 @@ GDScriptLanguageProtocol::GDScriptLanguageProtocol() {
 	set_method("initialize", callable_mp(this, &GDScriptLanguageProtocol::initialize));
 	set_method("initialized", callable_mp(this, &GDScriptLanguageProtocol::initialized));
 
+	request_priorities["textDocument/completion"] = PRIORITY_INTERACTIVE;
+	request_priorities["completionItem/resolve"] = PRIORITY_INTERACTIVE;
+	request_priorities["textDocument/signatureHelp"] = PRIORITY_INTERACTIVE;
+	request_priorities["textDocument/hover"] = PRIORITY_INTERACTIVE;
+	request_priorities["textDocument/references"] = PRIORITY_BACKGROUND;
+	request_priorities["textDocument/rename"] = PRIORITY_BACKGROUND;
+
+	// Only these read nothing but the parse result of their document. The reparse done by didChange, and
+	// references, which looks up every candidate through `GDScriptLanguage::lookup_code_at()`, use the
+	// analyzer and the script cache, so they stay on the polling thread. The server has no workspace/symbol.
+	snapshot_queries["textDocument/documentSymbol"] = &GDScriptTextDocument::symbols_from_snapshot;
+	snapshot_queries["textDocument/documentLink"] = &GDScriptTextDocument::links_from_snapshot;
+
 	workspace->root = ProjectSettings::get_singleton()->get_resource_path();
 }
 
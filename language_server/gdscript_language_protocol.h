@@ -35,10 +35,15 @@
 
 #include "core/io/stream_peer_tcp.h"
 #include "core/io/tcp_server.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/safe_refcount.h"
 
 #include "modules/jsonrpc/jsonrpc.h"
 
-#define LSP_MAX_BUFFER_SIZE 4194304
+// Largest accepted request, only meant to reject malformed headers.
+#define LSP_MAX_MESSAGE_SIZE 67108864
+// Stop reading requests from a client while this many response bytes are waiting to be sent.
+#define LSP_MAX_PENDING_OUTPUT 4194304
 #define LSP_MAX_CLIENTS 8
 
 #define LSP_NO_CLIENT -1
@@ -54,16 +59,25 @@ private:
 	struct LSPeer : RefCounted {
 		Ref<StreamPeerTCP> connection;
 
-		uint8_t req_buf[LSP_MAX_BUFFER_SIZE];
-		int req_pos = 0;
+		// Received bytes, split into messages as they arrive.
+		LocalVector<uint8_t> req_buf;
+		uint32_t req_scan_pos = 0; // Where to resume looking for the end of the header.
 		bool has_header = false;
-		bool has_content = false;
-		int content_length = 0;
-		Vector<CharString> res_queue;
-		int res_sent = 0;
+		uint32_t content_start = 0;
+		uint32_t content_length = 0;
 
+		// Encoded messages waiting to be sent, each followed by its content.
+		List<LocalVector<uint8_t>> res_queue;
+		uint32_t res_sent = 0;
+		uint64_t res_pending = 0;
+
+		Error read_data();
+		Error scan_header();
+		bool has_message() const;
 		Error handle_data();
 		Error send_data();
+		void queue_message(const Variant &p_message);
+		_FORCE_INLINE_ bool is_congested() const { return res_pending >= LSP_MAX_PENDING_OUTPUT; }
 
 		/**
 		 * Tracks all files that the client claimed, however for files deemed not relevant
@@ -75,6 +89,17 @@ private:
 		void remove_cached_parser(const String &p_path);
 		ExtendGDScriptParser *parse_script(const String &p_path);
 
+		/**
+		 * Parsers read by snapshot queries on worker threads are pinned. Replacing a pinned parser
+		 * retires it instead, and it's freed once the last query using it finished.
+		 */
+		HashMap<const ExtendGDScriptParser *, int> pinned_parsers;
+		LocalVector<ExtendGDScriptParser *> retired_parsers;
+
+		void pin_parser(const ExtendGDScriptParser *p_parser);
+		void unpin_parser(const ExtendGDScriptParser *p_parser);
+		void free_parser(ExtendGDScriptParser *p_parser);
+
 		~LSPeer();
 
 	private:
@@ -89,6 +114,36 @@ private:
 		ContentModified = -32801,
 	};
 
+	enum RequestPriority {
+		PRIORITY_INTERACTIVE, // Answers the user while typing: completion, hover, signatures.
+		PRIORITY_NORMAL,
+		PRIORITY_BACKGROUND, // Project-wide searches.
+		PRIORITY_MAX,
+	};
+
+	struct PendingRequest {
+		int client_id = LSP_NO_CLIENT;
+		Variant id;
+		String method;
+		String uri; // Document the request is about, if any.
+		Dictionary message;
+	};
+
+	// Queries that only read the parse result of one document, and can run on a worker thread.
+	typedef Variant (*SnapshotQuery)(const ExtendGDScriptParser *p_parser, const Dictionary &p_params);
+
+	struct SnapshotJob {
+		Ref<LSPeer> peer;
+		int client_id = LSP_NO_CLIENT;
+		Variant id;
+		const ExtendGDScriptParser *parser = nullptr;
+		SnapshotQuery query = nullptr;
+		Dictionary params;
+		Variant result;
+		SafeFlag cancelled;
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
 	static GDScriptLanguageProtocol *singleton;
 
 	HashMap<int, Ref<LSPeer>> clients;
@@ -104,8 +159,21 @@ private:
 	Error on_client_connected();
 	void on_client_disconnected(const int &p_client_id);
 
-	String process_message(const String &p_text);
-	String format_output(const String &p_text);
+	HashMap<String, RequestPriority> request_priorities;
+	HashMap<String, SnapshotQuery> snapshot_queries;
+	List<PendingRequest> pending_requests[PRIORITY_MAX];
+	LocalVector<SnapshotJob *> snapshot_jobs;
+
+	void schedule_message(const String &p_text);
+	void send_to_client(int p_client_id, const Variant &p_message);
+	void cancel_request(int p_client_id, const Variant &p_id);
+	void invalidate_requests(int p_client_id, const String &p_uri);
+	void run_request(const PendingRequest &p_request);
+	void run_pending_requests(uint64_t p_target_ticks);
+	void finish_snapshot_jobs(bool p_wait);
+	static void run_snapshot_job(void *p_userdata);
+
+	static void encode_json(const Variant &p_value, LocalVector<uint8_t> &r_buffer);
 
 	bool _initialized = false;
 
@@ -152,6 +220,7 @@ public:
 
 	GDScriptLanguageProtocol();
 	~GDScriptLanguageProtocol() {
+		finish_snapshot_jobs(true);
 		clients.clear();
 	}
 };
@@ -155,12 +155,16 @@ Array GDScriptTextDocument::documentSymbol(const Dictionary &p_params) {
 	Dictionary params = p_params["textDocument"];
 	String uri = params["uri"];
 	String path = GDScriptLanguageProtocol::get_singleton()->get_workspace()->get_file_path(uri);
-	Array arr;
 
 	ExtendGDScriptParser *parser = GDScriptLanguageProtocol::get_singleton()->get_parse_result(path);
-	if (parser) {
-		LSP::DocumentSymbol symbol = parser->get_symbols();
-		arr.push_back(symbol.to_json(true));
+	return symbols_from_snapshot(parser, p_params);
+}
+
+// Only reads the parse result, so the language server may call it from a worker thread.
+Variant GDScriptTextDocument::symbols_from_snapshot(const ExtendGDScriptParser *p_parser, const Dictionary &p_params) {
+	Array arr;
+	if (p_parser) {
+		arr.push_back(p_parser->get_symbols().to_json(true));
 	}
 	return arr;
 }
@@ -363,6 +367,17 @@ Array GDScriptTextDocument::documentLink(const Dictionary &p_params) {
 	return ret;
 }
 
+// Same as `documentLink()`, on an existing parse result. See `symbols_from_snapshot()`.
+Variant GDScriptTextDocument::links_from_snapshot(const ExtendGDScriptParser *p_parser, const Dictionary &p_params) {
+	Array ret;
+	if (p_parser && p_parser->parse_result == OK) {
+		for (const LSP::DocumentLink &E : p_parser->get_document_links()) {
+			ret.push_back(E.to_json());
+		}
+	}
+	return ret;
+}
+
 Array GDScriptTextDocument::colorPresentation(const Dictionary &p_params) {
 	return Array();
 }
@@ -35,6 +35,7 @@
 #include "core/io/file_access.h"
 #include "core/object/ref_counted.h"
 
+class ExtendGDScriptParser;
 class GDScript;
 
 class GDScriptTextDocument : public RefCounted {
@@ -57,6 +58,9 @@ public:
 	void willSaveWaitUntil(const Variant &p_param);
 	void didSave(const Variant &p_param);
 
+	static Variant symbols_from_snapshot(const ExtendGDScriptParser *p_parser, const Dictionary &p_params);
+	static Variant links_from_snapshot(const ExtendGDScriptParser *p_parser, const Dictionary &p_params);
+
 	void reload_script(Ref<GDScript> p_to_reload_script);
 	void show_native_symbol_in_editor(const String &p_symbol_id);
 
@@ -668,8 +668,7 @@ void GDScriptWorkspace::completion(const LSP::CompletionParams &p_params, List<S
 			}
 		}
 
-		String code = parser->get_text_for_completion(p_params.position);
-		GDScriptLanguage::get_singleton()->complete_code(code, path, current, r_options, forced, call_hint);
+		GDScriptLanguage::get_singleton()->complete_code_at(parser->get_code(), p_params.position.line, p_params.position.character, path, current, r_options, forced, call_hint);
 		if (owner_scene_node) {
 			memdelete(owner_scene_node);
 		}
@@ -705,7 +704,9 @@ const LSP::DocumentSymbol *GDScriptWorkspace::resolve_symbol(const LSP::TextDocu
 				if (symbol_identifier == "new" && parser->get_lines()[p_doc_pos.position.line].remove_chars(" \t").contains("new(")) {
 					symbol_identifier = "_init";
 				}
-				if (OK == GDScriptLanguage::get_singleton()->lookup_code(parser->get_text_for_lookup_symbol(pos, symbol_identifier, p_func_required), symbol_identifier, path, nullptr, ret)) {
+				LSP::Position lookup_pos;
+				const String lookup_code = parser->get_text_for_lookup_symbol(pos, symbol_identifier, p_func_required, lookup_pos);
+				if (OK == GDScriptLanguage::get_singleton()->lookup_code_at(lookup_code, lookup_pos.line, lookup_pos.character, symbol_identifier, path, nullptr, ret)) {
 					if (ret.location >= 0) {
 						String target_script_path = path;
 						if (ret.script.is_valid()) {
@@ -31,7 +31,11 @@
 #include "register_types.h"
 
 #include "gdscript.h"
+#include "gdscript_analyzer.h"
 #include "gdscript_cache.h"
+#include "gdscript_compiler.h"
+#include "gdscript_cpp_codegen.h"
+#include "gdscript_native.h"
 #include "gdscript_parser.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_utility_functions.h"
@@ -81,18 +85,49 @@ class EditorExportGDScript : public EditorExportPlugin {
 	static constexpr EditorExportPreset::ScriptExportMode DEFAULT_SCRIPT_MODE = EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED;
 	EditorExportPreset::ScriptExportMode script_mode = DEFAULT_SCRIPT_MODE;
 
+	// Where the C++ translation of the scripts is written, if anywhere.
+	String native_code_path;
+	GDScriptCppModule native_code;
+
+	void _compile_native_code(const String &p_path, const String &p_source) {
+		GDScriptParser parser;
+		if (parser.parse(p_source, p_path, false) != OK) {
+			return;
+		}
+		GDScriptAnalyzer analyzer(&parser);
+		if (analyzer.analyze() != OK) {
+			return;
+		}
+
+		// A separate instance, so the script used by the editor isn't touched.
+		Ref<GDScript> script;
+		script.instantiate();
+		script->set_path_cache(p_path);
+
+		GDScriptCompiler compiler;
+		compiler.set_update_cache(false);
+		compiler.set_cpp_module(&native_code);
+		compiler.compile(&parser, script.ptr(), false);
+	}
+
 protected:
 	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
 		script_mode = DEFAULT_SCRIPT_MODE;
+		native_code_path = String();
+		native_code.clear();
 
 		const Ref<EditorExportPreset> &preset = get_export_preset();
 		if (preset.is_valid()) {
 			script_mode = preset->get_script_export_mode();
+			native_code_path = get_option("gdscript/native_code_path");
 		}
 	}
 
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
-		if (p_path.get_extension() != "gd" || script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
+		if (p_path.get_extension() != "gd") {
+			return;
+		}
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_TEXT && native_code_path.is_empty()) {
 			return;
 		}
 
@@ -102,6 +137,13 @@ protected:
 		}
 
 		String source = String::utf8(reinterpret_cast<const char *>(file.ptr()), file.size());
+		if (!native_code_path.is_empty()) {
+			_compile_native_code(p_path, source);
+		}
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
+			return;
+		}
+
 		GDScriptTokenizerBuffer::CompressMode compress_mode = script_mode == EditorExportPreset::MODE_SCRIPT_BINARY_TOKENS_COMPRESSED ? GDScriptTokenizerBuffer::COMPRESS_ZSTD : GDScriptTokenizerBuffer::COMPRESS_NONE;
 		file = GDScriptTokenizerBuffer::parse_code_string(source, compress_mode);
 		if (file.is_empty()) {
@@ -111,6 +153,32 @@ protected:
 		add_file(p_path.get_basename() + ".gdc", file, true);
 	}
 
+	virtual void _export_end() override {
+		if (native_code_path.is_empty()) {
+			return;
+		}
+		// Built into the engine from `modules/gdscript2/native/`, see `GDScriptNativeFunctions`.
+		const String path = native_code_path.path_join("gdscript_native_functions.gen.cpp");
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(f.is_null(), vformat(R"(Cannot write GDScript native code to "%s".)", path));
+		f->store_string(native_code.get_source());
+		print_line(vformat("GDScript: %d functions translated to C++ in \"%s\".", native_code.get_function_count(), path));
+	}
+
+	virtual void _get_export_options(const Ref<EditorExportPlatform> &p_export_platform, List<EditorExportPlatform::ExportOption> *r_options) const override {
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::BOOL, "gdscript/lean_bytecode"), false));
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::STRING, "gdscript/native_code_path", PROPERTY_HINT_GLOBAL_DIR), String()));
+	}
+
+	virtual PackedStringArray _get_export_features(const Ref<EditorExportPlatform> &p_export_platform, bool p_debug) const override {
+		// Compile scripts without debug metadata when the exported project runs without a debugger.
+		PackedStringArray features;
+		if (get_export_preset().is_valid() && bool(get_option("gdscript/lean_bytecode"))) {
+			features.push_back("gdscript_lean_bytecode");
+		}
+		return features;
+	}
+
 public:
 	virtual String get_name() const override { return "GDScript"; }
 };
@@ -152,6 +220,7 @@ void initialize_gdscript2_module(ModuleInitializationLevel p_level) {
 		gdscript_cache = memnew(GDScriptCache);
 
 		GDScriptUtilityFunctions::register_functions();
+		GDScriptNativeFunctions::register_functions();
 	}
 
 #ifdef TOOLS_ENABLED
@@ -186,6 +255,7 @@ void uninitialize_gdscript2_module(ModuleInitializationLevel p_level) {
 
 		GDScriptParser::cleanup();
 		GDScriptUtilityFunctions::unregister_functions();
+		GDScriptNativeFunctions::unregister_functions();
 	}
 
 #ifdef TOOLS_ENABLED
@@ -131,11 +131,12 @@ void finish_language() {
 
 StringName GDScriptTestRunner::test_function_name;
 
-GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames, bool p_use_binary_tokens) {
+GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames, bool p_use_binary_tokens, bool p_use_jit) {
 	test_function_name = StringName("test");
 	do_init_languages = p_init_language;
 	print_filenames = p_print_filenames;
 	binary_tokens = p_use_binary_tokens;
+	jit = p_use_jit;
 
 	source_dir = p_source_dir;
 	if (!source_dir.ends_with("/")) {
@@ -146,6 +147,12 @@ GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_l
 		init_language(p_source_dir);
 	}
 
+	if (jit) {
+		previous_jit_enabled = GDScriptLanguage::get_singleton()->is_jit_enabled();
+		previous_jit_call_threshold = GDScriptLanguage::get_singleton()->get_jit_call_threshold();
+		GDScriptLanguage::get_singleton()->set_jit_enabled(true, 1);
+	}
+
 #ifdef DEBUG_ENABLED
 	// Set all warning levels to "Warn" in order to test them properly, even the ones that default to error.
 	ProjectSettings::get_singleton()->set_setting("debug/gdscript/warnings/enable", true);
@@ -170,6 +177,9 @@ GDScriptTestRunner::GDScriptTestRunner(const String &p_source_dir, bool p_init_l
 
 GDScriptTestRunner::~GDScriptTestRunner() {
 	test_function_name = StringName();
+	if (jit) {
+		GDScriptLanguage::get_singleton()->set_jit_enabled(previous_jit_enabled, previous_jit_call_threshold);
+	}
 	if (do_init_languages) {
 		finish_language();
 	}
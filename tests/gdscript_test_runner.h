@@ -118,6 +118,9 @@ class GDScriptTestRunner {
 	bool do_init_languages = false;
 	bool print_filenames; // Whether filenames should be printed when generated/running tests
 	bool binary_tokens; // Test with buffer tokenizer.
+	bool jit; // Test with every function compiled on its first call.
+	bool previous_jit_enabled = false;
+	uint32_t previous_jit_call_threshold = 0;
 
 	bool make_tests();
 	bool make_tests_for_dir(const String &p_dir);
@@ -130,7 +133,7 @@ public:
 	int run_tests();
 	bool generate_outputs();
 
-	GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames = false, bool p_use_binary_tokens = false);
+	GDScriptTestRunner(const String &p_source_dir, bool p_init_language, bool p_print_filenames = false, bool p_use_binary_tokens = false, bool p_use_jit = false);
 	~GDScriptTestRunner();
 };
 
@@ -32,7 +32,12 @@
 
 #include "gdscript_test_runner.h"
 
+#include "modules/gdscript2/gdscript_analyzer.h"
 #include "modules/gdscript2/gdscript_cache.h"
+#include "modules/gdscript2/gdscript_compiler.h"
+#include "modules/gdscript2/gdscript_cpp_codegen.h"
+#include "modules/gdscript2/gdscript_native.h"
+#include "modules/gdscript2/gdscript_tokenizer_buffer.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -47,6 +52,28 @@ public:
 	static bool has_full(String p_path) {
 		return GDScriptCache::singleton->full_gdscript_cache.has(p_path);
 	}
+
+	static bool has_parser(String p_path) {
+		return GDScriptCache::singleton->parser_map.has(p_path);
+	}
+
+	static void set_compiling(const String &p_path, Thread::ID p_thread) {
+		GDScriptCache::singleton->compiling_scripts[p_path] = p_thread;
+	}
+
+	static void set_waiting(Thread::ID p_thread, const String &p_path) {
+		GDScriptCache::singleton->waiting_threads[p_thread] = p_path;
+	}
+
+	static bool is_waiting_for(Thread::ID p_thread, Thread::ID p_target) {
+		MutexLock lock(GDScriptCache::mutex);
+		return GDScriptCache::_is_waiting_for(p_thread, p_target);
+	}
+
+	static void clear_compiling() {
+		GDScriptCache::singleton->compiling_scripts.clear();
+		GDScriptCache::singleton->waiting_threads.clear();
+	}
 };
 
 // TODO: Handle some cases failing on release builds. See: https://github.com/godotengine/godot/pull/88452
@@ -55,7 +82,8 @@ TEST_SUITE("[Modules][GDScript]") {
 	TEST_CASE("Script compilation and runtime") {
 		bool print_filenames = OS::get_singleton()->get_cmdline_args().find("--print-filenames") != nullptr;
 		bool use_binary_tokens = OS::get_singleton()->get_cmdline_args().find("--use-binary-tokens") != nullptr;
-		GDScriptTestRunner runner("modules/gdscript2/tests/scripts", true, print_filenames, use_binary_tokens);
+		bool use_jit = OS::get_singleton()->get_cmdline_args().find("--use-jit") != nullptr;
+		GDScriptTestRunner runner("modules/gdscript2/tests/scripts", true, print_filenames, use_binary_tokens, use_jit);
 		int fail_count = runner.run_tests();
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
@@ -63,6 +91,47 @@ TEST_SUITE("[Modules][GDScript]") {
 }
 #endif // TOOLS_ENABLED
 
+#ifdef TOOLS_ENABLED
+TEST_CASE("[Modules][GDScript] Translating to C++ keeps the VM result") {
+	GDScriptLanguage::get_singleton()->init();
+	const String path = "res://gdscript_cpp_module_test.gd";
+	const String source = R"(
+extends RefCounted
+
+func add(a: int, b: int) -> int:
+	return a + b + 40
+)";
+
+	GDScriptParser parser;
+	REQUIRE(parser.parse(source, path, false) == OK);
+	GDScriptAnalyzer analyzer(&parser);
+	REQUIRE(analyzer.analyze() == OK);
+
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path_cache(path);
+
+	GDScriptCppModule module;
+	GDScriptCompiler compiler;
+	compiler.set_update_cache(false);
+	compiler.set_cpp_module(&module);
+	REQUIRE(compiler.compile(&parser, script.ptr(), false) == OK);
+
+	CHECK_MESSAGE(!TestGDScriptCacheAccessor::has_full(path), "Compiling for the C++ module shouldn't touch the cache.");
+
+	// The function uses a constant, so it's only translated once the pool is final.
+	GDScriptFunction *const *add = script->get_member_functions().getptr("add");
+	REQUIRE(add != nullptr);
+	CHECK(module.get_function_count() == 1);
+	CHECK(module.get_source().contains(GDScriptNativeFunctions::get_key(*add).c_escape()));
+
+	// Registered under that key, the generated function replaces this bytecode, which must give the same result.
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(script);
+	CHECK(int(ref_counted->call("add", 1, 1)) == 42);
+}
+#endif // TOOLS_ENABLED
+
 TEST_CASE("[Modules][GDScript] Load source code dynamically and run it") {
 	GDScriptLanguage::get_singleton()->init();
 	Ref<GDScript> gdscript = memnew(GDScript);
@@ -105,6 +174,185 @@ TEST_CASE("[Modules][GDScript] Loading keeps ResourceCache and GDScriptCache in
 	CHECK(TestGDScriptCacheAccessor::has_full(path));
 }
 
+TEST_CASE("[Modules][GDScript] Loading with sub-threads") {
+	const String main_path = TestUtils::get_temp_path("gdscript_threaded_main.gd");
+	const String cycle_a_path = TestUtils::get_temp_path("gdscript_threaded_cycle_a.gd");
+	const String cycle_b_path = TestUtils::get_temp_path("gdscript_threaded_cycle_b.gd");
+	const String leaf_path = TestUtils::get_temp_path("gdscript_threaded_leaf.gd");
+	{
+		Ref<FileAccess> fa = FileAccess::open(main_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends RefCounted\n\nconst A = preload(\"gdscript_threaded_cycle_a.gd\")\nconst Leaf = preload(\"gdscript_threaded_leaf.gd\")\n\nfunc value() -> int:\n\treturn A.new().value() + A.B.new().value() + Leaf.new().value()\n");
+		// Preloading each other, compiled together on another thread while the main script waits for them.
+		fa = FileAccess::open(cycle_a_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends RefCounted\n\nconst B = preload(\"gdscript_threaded_cycle_b.gd\")\n\nfunc value() -> int:\n\treturn 20\n");
+		fa = FileAccess::open(cycle_b_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends RefCounted\n\nconst A = preload(\"gdscript_threaded_cycle_a.gd\")\n\nfunc value() -> int:\n\treturn 1\n");
+		// Compiled on its own thread as well.
+		fa = FileAccess::open(leaf_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends RefCounted\n\nfunc value() -> int:\n\treturn 21\n");
+	}
+
+	REQUIRE(ResourceLoader::load_threaded_request(main_path, "", true) == OK);
+	Ref<GDScript> main = ResourceLoader::load_threaded_get(main_path);
+	REQUIRE(main.is_valid());
+	CHECK(main->is_valid());
+	CHECK(TestGDScriptCacheAccessor::has_full(cycle_a_path));
+	CHECK(TestGDScriptCacheAccessor::has_full(cycle_b_path));
+	CHECK(TestGDScriptCacheAccessor::has_full(leaf_path));
+
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(main);
+	CHECK(int(instance->call("value")) == 42);
+}
+
+TEST_CASE("[Modules][GDScript] Threads waiting for each other's scripts") {
+	// Made-up thread IDs: 1 compiles "a.gd", 2 compiles "b.gd" and 3 compiles "c.gd".
+	TestGDScriptCacheAccessor::set_compiling("res://a.gd", 1);
+	TestGDScriptCacheAccessor::set_compiling("res://b.gd", 2);
+	TestGDScriptCacheAccessor::set_compiling("res://c.gd", 3);
+
+	// 1 waits for "b.gd" and 2 for "c.gd".
+	TestGDScriptCacheAccessor::set_waiting(1, "res://b.gd");
+	TestGDScriptCacheAccessor::set_waiting(2, "res://c.gd");
+	CHECK(TestGDScriptCacheAccessor::is_waiting_for(1, 2));
+	CHECK(TestGDScriptCacheAccessor::is_waiting_for(1, 3)); // Through 2.
+	CHECK_FALSE(TestGDScriptCacheAccessor::is_waiting_for(3, 1));
+
+	// 3 waiting for "a.gd" would close the cycle, it gets the script in progress instead.
+	TestGDScriptCacheAccessor::set_waiting(3, "res://a.gd");
+	CHECK(TestGDScriptCacheAccessor::is_waiting_for(1, 3));
+	CHECK(TestGDScriptCacheAccessor::is_waiting_for(3, 1));
+	CHECK_FALSE(TestGDScriptCacheAccessor::is_waiting_for(3, 4)); // Follows a cycle without looping.
+
+	TestGDScriptCacheAccessor::clear_compiling();
+}
+
+TEST_CASE("[Modules][GDScript] Compacting the cache releases parsers") {
+	const String base_path = TestUtils::get_temp_path("gdscript_compact_base.gd");
+	const String child_path = TestUtils::get_temp_path("gdscript_compact_child.gd");
+	const String other_path = TestUtils::get_temp_path("gdscript_compact_other.gd");
+	{
+		Ref<FileAccess> fa = FileAccess::open(base_path, FileAccess::ModeFlags::WRITE);
+		// Parsers depending on each other keep each other alive.
+		fa->store_string("extends RefCounted\n\nconst Child = preload(\"gdscript_compact_child.gd\")\n\nfunc value() -> int:\n\treturn 21\n");
+		fa = FileAccess::open(child_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends \"gdscript_compact_base.gd\"\n\nfunc doubled() -> int:\n\treturn value() * 2\n");
+		fa = FileAccess::open(other_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends \"gdscript_compact_base.gd\"\n\nfunc tripled() -> int:\n\treturn value() * 3\n");
+	}
+
+	Ref<GDScript> child = ResourceLoader::load(child_path);
+	REQUIRE(child.is_valid());
+
+	const Dictionary report = GDScriptCache::compact();
+	REQUIRE_FALSE(report.is_empty());
+	CHECK(int(report["parsers"]) > 0);
+	CHECK_FALSE(TestGDScriptCacheAccessor::has_parser(base_path));
+	CHECK_FALSE(TestGDScriptCacheAccessor::has_parser(child_path));
+	CHECK(TestGDScriptCacheAccessor::has_full(child_path));
+
+	// The base is parsed again for a script depending on it.
+	Ref<GDScript> other = ResourceLoader::load(other_path);
+	REQUIRE(other.is_valid());
+	Ref<RefCounted> instance = memnew(RefCounted);
+	instance->set_script(other);
+	CHECK(int(instance->call("tripled")) == 63);
+	instance->set_script(child);
+	CHECK(int(instance->call("doubled")) == 42);
+}
+
+TEST_CASE("[Modules][GDScript] Source code loaded as UTF-8") {
+	const String path = TestUtils::get_temp_path("gdscript_utf8_source.gd");
+	const String code = U"extends RefCounted\n\nconst GREETING = \"héllo wörld ✓\"\n";
+	{
+		Ref<FileAccess> fa = FileAccess::open(path, FileAccess::ModeFlags::WRITE);
+		fa->store_string(code);
+	}
+
+	Ref<GDScript> gdscript;
+	gdscript.instantiate();
+	REQUIRE(gdscript->load_source_code(path) == OK);
+	CHECK(gdscript->has_source_code());
+	CHECK(gdscript->get_source_code() == code);
+	CHECK(gdscript->reload() == OK);
+	CHECK(String(gdscript->get_constants()["GREETING"]) == U"héllo wörld ✓");
+
+	gdscript->set_source_code("extends RefCounted\n");
+	CHECK(gdscript->get_source_code() == "extends RefCounted\n");
+}
+
+TEST_CASE("[Modules][GDScript] Global class header") {
+	GDScriptLanguage *lang = GDScriptLanguage::get_singleton();
+	const String base_path = TestUtils::get_temp_path("gdscript_header_base.gd");
+	const String child_path = TestUtils::get_temp_path("gdscript_header_child.gd");
+	const String inner_path = TestUtils::get_temp_path("gdscript_header_inner.gd");
+
+	{
+		Ref<FileAccess> fa = FileAccess::open(base_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("@tool\n@icon(\"icon.svg\")\n@abstract\nclass_name HeaderTestBase extends Node2D\n\n@export var value := 1\n");
+		fa = FileAccess::open(child_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string(vformat("\"\"\"Documentation.\"\"\"\n@warning_ignore(\"unused_variable\")\nextends \"%s\"\nclass_name HeaderTestChild\n", base_path));
+		fa = FileAccess::open(inner_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends RefCounted\n@abstract\nclass Inner:\n\tpass\n");
+	}
+
+	String base_type;
+	String icon_path;
+	bool is_abstract = false;
+	bool is_tool = false;
+	CHECK(lang->get_global_class_name(base_path, &base_type, &icon_path, &is_abstract, &is_tool) == "HeaderTestBase");
+	CHECK(base_type == "Node2D");
+	CHECK(icon_path == base_path.get_base_dir().path_join("icon.svg"));
+	CHECK(is_abstract);
+	CHECK(is_tool);
+
+	CHECK(lang->get_global_class_name(child_path, &base_type, &icon_path, &is_abstract, &is_tool) == "HeaderTestChild");
+	CHECK(base_type == "Node2D"); // Resolved through the base script.
+	CHECK(icon_path.is_empty());
+	CHECK_FALSE(is_abstract);
+	CHECK_FALSE(is_tool);
+
+	// The annotation belongs to the inner class.
+	CHECK(lang->get_global_class_name(inner_path, &base_type, &icon_path, &is_abstract, &is_tool).is_empty());
+	CHECK(base_type == "RefCounted");
+	CHECK_FALSE(is_abstract);
+
+	// Saved again within the same second, and script annotations after `extends` aren't part of the header.
+	{
+		Ref<FileAccess> fa = FileAccess::open(inner_path, FileAccess::ModeFlags::WRITE);
+		fa->store_string("extends Node\n@tool\n");
+	}
+	CHECK(lang->get_global_class_name(inner_path, &base_type, &icon_path, &is_abstract, &is_tool).is_empty());
+	CHECK(base_type == "Node");
+	CHECK_FALSE(is_tool);
+}
+
+TEST_CASE("[Modules][GDScript] Script dependencies") {
+	const String source = "extends \"base.gd\"\n\nconst A = preload(\"a.gd\")\nconst B = preload(\"res://b.tscn\")\nconst C = preload(\"./a.gd\")\n# preload(\"comment.gd\")\nvar text := \"preload(\\\"string.gd\\\")\"\n\nfunc _init():\n\tload(\"loaded.gd\")\n";
+	const String path = TestUtils::get_temp_path("gdscript_dependencies.gd");
+	{
+		Ref<FileAccess> fa = FileAccess::open(path, FileAccess::ModeFlags::WRITE);
+		fa->store_string(source);
+	}
+
+	const Vector<String> dependencies = GDScriptLanguage::get_singleton()->get_script_dependencies(path);
+	const String base_dir = path.get_base_dir();
+	REQUIRE(dependencies.size() == 3);
+	CHECK(dependencies[0] == base_dir.path_join("base.gd"));
+	CHECK(dependencies[1] == base_dir.path_join("a.gd"));
+	CHECK(dependencies[2] == "res://b.tscn");
+
+	// Exported scripts are scanned from their binary tokens.
+	const String binary_path = TestUtils::get_temp_path("gdscript_dependencies.gdc");
+	{
+		Ref<FileAccess> fa = FileAccess::open(binary_path, FileAccess::ModeFlags::WRITE);
+		fa->store_buffer(GDScriptTokenizerBuffer::parse_code_string(source, GDScriptTokenizerBuffer::COMPRESS_ZSTD));
+	}
+
+	const Vector<String> binary_dependencies = GDScriptLanguage::get_singleton()->get_script_dependencies(binary_path);
+	CHECK(binary_dependencies == dependencies);
+}
+
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
 	GDScriptLanguage *lang = GDScriptLanguage::get_singleton();
 
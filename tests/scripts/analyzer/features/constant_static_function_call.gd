@@ -0,0 +1,33 @@
+const MASKS = build_masks(4)
+const LIMIT = clamp_limit(300)
+const FACTORIAL_5 = factorial(5)
+
+static func build_masks(count: int) -> Array:
+	var result := []
+	for i in count:
+		result.append(1 << i)
+	return result
+
+static func clamp_limit(value: int) -> int:
+	return mini(value, 255)
+
+static func factorial(n: int) -> int:
+	return 1 if n <= 1 else n * factorial(n - 1)
+
+static func scaled(value: float, factor := 2) -> float:
+	return value * factor
+
+static func logged(value: int) -> int:
+	print("runtime ", value)
+	return value
+
+func default_argument(value := scaled(1.5)) -> float:
+	return value
+
+func test():
+	print(MASKS)
+	print(MASKS.is_read_only())
+	print(LIMIT)
+	print(FACTORIAL_5)
+	print(default_argument())
+	print(logged(3))
@@ -0,0 +1,13 @@
+# The speculated call skips non-const methods on read-only receivers, the generic path reports them.
+
+func append_to(target, value):
+	target.push_back(value)
+
+func test():
+	var values = []
+	for i in 100:
+		append_to(values, i)
+
+	var frozen = [1, 2, 3]
+	frozen.make_read_only()
+	append_to(frozen, 4)
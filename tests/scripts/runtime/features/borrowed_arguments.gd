@@ -0,0 +1,39 @@
+class Shape:
+	var points: PackedVector2Array
+
+	func total(values: Array[int], offset: Vector2) -> float:
+		var sum := 0
+		for value in values:
+			sum += value
+		return sum + offset.x
+
+	func shifted(point: Vector2) -> Vector2:
+		point.x += 10
+		return point
+
+	func swapped(a: String, b: String) -> String:
+		swap(a, b)
+		return a + b
+
+	func append_to(target: Array) -> void:
+		target.append(4)
+
+func test():
+	var shape := Shape.new()
+	var values: Array[int] = [1, 2, 3]
+	var offset := Vector2(0.5, 0)
+	for _i in 2:
+		print(shape.total(values, offset))
+
+	var point := Vector2(1, 2)
+	print(shape.shifted(point))
+	print(point)
+
+	var first := "a"
+	var second := "b"
+	print(shape.swapped(first, second))
+	print(first, second)
+
+	var list := [1, 2, 3]
+	shape.append_to(list)
+	print(list)
@@ -0,0 +1,27 @@
+class Base:
+	func describe() -> String:
+		return "Base"
+
+	func describe_self() -> String:
+		return "self:" + describe()
+
+class Plain extends Base:
+	pass
+
+class Override extends Base:
+	func describe() -> String:
+		return "Override"
+
+class Leaf extends Plain:
+	pass
+
+func call_describe(value: Base) -> String:
+	return value.describe()
+
+func test():
+	var instances: Array[Base] = [Base.new(), Plain.new(), Override.new(), Leaf.new()]
+	for _i in 2:
+		for instance in instances:
+			print(call_describe(instance))
+	for instance in instances:
+		print(instance.describe_self())
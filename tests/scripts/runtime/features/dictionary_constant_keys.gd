@@ -0,0 +1,22 @@
+func describe(record: Dictionary) -> String:
+	return "%s %s %s %s" % [record["name"], record.hp, record[&"name"], record["hp"]]
+
+func score(stats: Dictionary[String, int]) -> int:
+	var total := 0
+	for _i in 3:
+		total += stats["attack"] * stats.defense
+	return total
+
+func kind_of(tags: Dictionary[StringName, String]) -> String:
+	return tags["kind"] + " " + tags.kind
+
+func test():
+	var record := { "name": "slime", &"hp": 10 }
+	print(describe(record))
+	print(record.keys())
+
+	var stats: Dictionary[String, int] = { "attack": 3, "defense": 2 }
+	print(score(stats))
+
+	var tags: Dictionary[StringName, String] = { &"kind": "enemy" }
+	print(kind_of(tags))
@@ -0,0 +1,39 @@
+# Exercises the instructions the JIT compiles, and leaving the compiled code
+# in the middle of a loop. Run with `--use-jit` to compile every function.
+
+func sum_range(n: int) -> int:
+	var total := 0
+	for i in range(1, n + 1, 2):
+		total += i * i
+	return total
+
+func sum_array(values: Array[float]) -> float:
+	var total := 0.0
+	for v in values:
+		if v < 0.0:
+			continue
+		total += v
+	return total
+
+func mixed(n: int) -> String:
+	var parts := PackedStringArray()
+	for i in n:
+		# Appending goes through the interpreter, the rest is compiled.
+		parts.append(str(i))
+		if i % 2 == 0:
+			parts.append("even")
+	return ",".join(parts)
+
+func vectors(n: int) -> Vector2:
+	var v := Vector2.ZERO
+	for i in n:
+		v += Vector2(i, -i)
+		v.x = maxf(v.x, 1.0)
+	return v.abs()
+
+func test():
+	print(sum_range(10))
+	var values: Array[float] = [1.5, -2.0, 3.5, 4.0]
+	print(sum_array(values))
+	print(mixed(4))
+	print(vectors(5))
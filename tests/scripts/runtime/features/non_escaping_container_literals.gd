@@ -0,0 +1,70 @@
+func count_neighbors(origin: Vector2) -> int:
+	var directions := [Vector2.UP, Vector2.DOWN, Vector2.LEFT, Vector2.RIGHT]
+	var count := 0
+	for direction in directions:
+		if origin + direction in [Vector2(0, 1), Vector2(1, 0)]:
+			count += 1
+	return count + directions.size()
+
+func weight_total() -> float:
+	var weights: Array[float] = [0.5, 1.5]
+	var total := 0.0
+	for i in weights.size():
+		total += weights[i]
+	return total
+
+func lookup(key: String) -> int:
+	var table := { "a": 1, "b": 2 }
+	if key in table:
+		return table[key]
+	return 0
+
+func grown() -> Array:
+	var items := [1, 2]
+	items.append(3)
+	return items
+
+func escaped() -> Dictionary:
+	var info := { "name": "first" }
+	return info
+
+func first_of(a: int, b: int) -> int:
+	return [a, b][0]
+
+func test():
+	for _i in 2:
+		print(count_neighbors(Vector2.ZERO))
+		print(weight_total())
+		print(lookup("b"), " ", lookup("c"))
+		print(grown())
+
+	var info := escaped()
+	info.name = "changed"
+	print(escaped())
+
+	var matched := 0
+	for i in 5:
+		if i in [1, 3, 4]:
+			matched += 1
+		if i in [matched, i + 1]:
+			matched += 10
+	print(matched)
+	print(first_of(7, 8))
+
+	var edited := [1, 2]
+	edited[0] = 5
+	print(edited)
+
+	var grid := [[1], [2]]
+	grid[0].append(3)
+	print(grid)
+
+	var unsorted := [3, 1, 2]
+	var sort := unsorted.sort
+	sort.call()
+	print(unsorted)
+
+	var base := [1, 2]
+	var copy := base.duplicate()
+	copy.append(3)
+	print(copy)
@@ -0,0 +1,45 @@
+# Untyped sites specialize on the built-in types they keep seeing,
+# and must keep working once those types change.
+
+func measure(values):
+	var total = 0.0
+	for value in values:
+		total += value.length() + value.x
+	return total
+
+func add(a, b):
+	return a + b
+
+func count_in(values, item):
+	var found = 0
+	for i in 100:
+		if values.has(item):
+			found += 1
+	return found
+
+func test():
+	var values = []
+	for i in 100:
+		values.push_back(Vector2(3, 4))
+	print(measure(values))
+
+	for i in 10:
+		values.push_back(Vector3(1, 2, 2))
+	print(measure(values))
+
+	var sum = 0
+	for i in 100:
+		sum = add(sum, 1)
+	print(sum)
+
+	var mixed = 0.0
+	for i in 100:
+		mixed = add(mixed, 0.5)
+	print(mixed)
+
+	print(add("spec", "ulated"))
+
+	# Read-only receivers still take const methods.
+	var frozen = [1, 2, 3]
+	frozen.make_read_only()
+	print(count_in(frozen, 2))
@@ -0,0 +1,47 @@
+class Enemy extends Node:
+	var health := 10
+
+	func hit() -> int:
+		health -= 1
+		return health
+
+func check(value):
+	if value is int:
+		print(value + 1)
+	elif typeof(value) == TYPE_STRING:
+		print(value.to_upper())
+	elif value is Enemy:
+		print(value.hit())
+		print(value.get_child_count())
+	elif value as Node != null:
+		print(value.get_class())
+
+	match typeof(value):
+		TYPE_INT:
+			print(value * 2)
+		TYPE_FLOAT, TYPE_INT:
+			print(value)
+
+func reassigned_in_loop(value):
+	if value is int:
+		for _i in 2:
+			print(value + value)
+			value = str(value)
+
+func swapped(value, other):
+	if value is int:
+		swap(value, other)
+		# No longer an `int`, `swap()` wrote to it.
+		print(value + "!")
+
+func test():
+	check(1)
+	check("abc")
+	var enemy := Enemy.new()
+	check(enemy)
+	enemy.free()
+	var node := Node.new()
+	check(node)
+	node.free()
+	reassigned_in_loop(1)
+	swapped(1, "two")
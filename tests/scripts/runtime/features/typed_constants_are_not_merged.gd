@@ -0,0 +1,15 @@
+# Read-only typed containers with equal contents share a pool slot only when their element types match.
+
+const INTS: Array[int] = []
+const MORE_INTS: Array[int] = []
+const STRINGS: Array[String] = []
+const INT_KEYS: Dictionary[int, int] = {}
+const STRING_KEYS: Dictionary[String, int] = {}
+
+func test():
+	Utils.check(INTS.get_typed_builtin() == TYPE_INT)
+	Utils.check(MORE_INTS.get_typed_builtin() == TYPE_INT)
+	Utils.check(STRINGS.get_typed_builtin() == TYPE_STRING)
+	Utils.check(INT_KEYS.get_typed_key_builtin() == TYPE_INT)
+	Utils.check(STRING_KEYS.get_typed_key_builtin() == TYPE_STRING)
+	print('ok')
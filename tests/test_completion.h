@@ -42,6 +42,7 @@
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
 #include "core/variant/dictionary.h"
 #include "core/variant/variant.h"
 #include "editor/settings/editor_settings.h"
@@ -270,6 +271,90 @@ TEST_SUITE("[Modules][GDScript][Completion]") {
 
 		finish_language();
 	}
+
+	TEST_CASE("[Editor] Native member completion latency") {
+		EditorSettings::get_singleton()->set_setting("text_editor/completion/use_single_quotes", false);
+		init_language("modules/gdscript2/tests/scripts");
+
+		const String code = "extends Node2D\n\nfunc _ready():\n\tself." + String::chr(0xFFFF) + "\n";
+		const String path = "res://completion_benchmark.gd";
+		const int iterations = 20;
+
+		String call_hint;
+		bool forced;
+
+		// The first request builds the cached options for Node2D and all its ancestors.
+		GDScriptLanguage::get_singleton()->clear_native_completion_cache();
+		List<ScriptLanguage::CodeCompletionOption> cold_options;
+		uint64_t start = OS::get_singleton()->get_ticks_usec();
+		GDScriptLanguage::get_singleton()->complete_code(code, path, nullptr, &cold_options, forced, call_hint);
+		const uint64_t cold_usec = OS::get_singleton()->get_ticks_usec() - start;
+
+		List<ScriptLanguage::CodeCompletionOption> warm_options;
+		start = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			warm_options.clear();
+			GDScriptLanguage::get_singleton()->complete_code(code, path, nullptr, &warm_options, forced, call_hint);
+		}
+		const uint64_t warm_usec = (OS::get_singleton()->get_ticks_usec() - start) / iterations;
+
+		// Warm options must match both the first request and an enumeration of ClassDB, which the cache replaces.
+		REQUIRE(warm_options.size() == cold_options.size());
+		const List<ScriptLanguage::CodeCompletionOption>::Element *cold = cold_options.front();
+		HashSet<String> warm_names;
+		for (const ScriptLanguage::CodeCompletionOption &option : warm_options) {
+			CHECK(option.display == cold->get().display);
+			CHECK(option.location == cold->get().location);
+			cold = cold->next();
+			warm_names.insert(option.display);
+		}
+
+		HashSet<String> expected;
+		List<StringName> enums;
+		ClassDB::get_enum_list("Node2D", &enums);
+		for (const StringName &E : enums) {
+			expected.insert(E);
+		}
+		List<String> constants;
+		ClassDB::get_integer_constant_list("Node2D", &constants);
+		for (const String &E : constants) {
+			expected.insert(E);
+		}
+		List<PropertyInfo> properties;
+		ClassDB::get_property_list("Node2D", &properties);
+		for (const PropertyInfo &E : properties) {
+			if (!(E.usage & (PROPERTY_USAGE_CATEGORY | PROPERTY_USAGE_GROUP | PROPERTY_USAGE_SUBGROUP | PROPERTY_USAGE_INTERNAL)) && !E.name.contains_char('/')) {
+				expected.insert(E.name);
+			}
+		}
+		List<MethodInfo> signals;
+		ClassDB::get_signal_list("Node2D", &signals);
+		for (const MethodInfo &E : signals) {
+			if (!E.name.begins_with("_")) {
+				expected.insert(E.name);
+			}
+		}
+		List<MethodInfo> methods;
+		ClassDB::get_method_list("Node2D", &methods, false, true);
+		for (const MethodInfo &E : methods) {
+			if (!E.name.begins_with("_")) {
+				expected.insert(E.name);
+			}
+		}
+
+		for (const String &name : expected) {
+			CHECK_MESSAGE(warm_names.has(name), vformat("\"%s\" from ClassDB should be completed.", name));
+		}
+		for (const String &name : warm_names) {
+			if (name != "_ready") { // Declared by the script.
+				CHECK_MESSAGE(expected.has(name), vformat("\"%s\" isn't a member of Node2D in ClassDB.", name));
+			}
+		}
+
+		MESSAGE("Native member completion: ", cold_usec, " usec on an empty cache, ", warm_usec, " usec on average afterwards.");
+
+		finish_language();
+	}
 }
 } // namespace GDScriptTests
 